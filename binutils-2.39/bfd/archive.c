@@ -704,11 +704,12 @@ _bfd_get_elt_at_filepos (bfd *archive, file_ptr filepos,
 	    }
 	  n_bfd->proxy_origin = bfd_tell (archive);
 
-	  /* Copy BFD_COMPRESS, BFD_DECOMPRESS and BFD_COMPRESS_GABI
-	     flags.  */
+	  /* Copy BFD_COMPRESS, BFD_DECOMPRESS, BFD_COMPRESS_GABI and
+	     BFD_CANONICAL_MINISYMS flags.  */
 	  n_bfd->flags |= archive->flags & (BFD_COMPRESS
 					    | BFD_DECOMPRESS
-					    | BFD_COMPRESS_GABI);
+					    | BFD_COMPRESS_GABI
+					    | BFD_CANONICAL_MINISYMS);
 
 	  return n_bfd;
 	}
@@ -764,10 +765,12 @@ _bfd_get_elt_at_filepos (bfd *archive, file_ptr filepos,
 
   n_bfd->arelt_data = new_areldata;
 
-  /* Copy BFD_COMPRESS, BFD_DECOMPRESS and BFD_COMPRESS_GABI flags.  */
+  /* Copy BFD_COMPRESS, BFD_DECOMPRESS, BFD_COMPRESS_GABI and
+     BFD_CANONICAL_MINISYMS flags.  */
   n_bfd->flags |= archive->flags & (BFD_COMPRESS
 				    | BFD_DECOMPRESS
-				    | BFD_COMPRESS_GABI);
+				    | BFD_COMPRESS_GABI
+				    | BFD_CANONICAL_MINISYMS);
 
   /* Copy is_linker_input.  */
   n_bfd->is_linker_input = archive->is_linker_input;
@@ -2114,6 +2117,288 @@ _bfd_noarchive_truncate_arname (bfd *abfd ATTRIBUTE_UNUSED,
 {
 }
 
+/* Write the header and, unless ARCH is a thin archive, the contents
+   of the member CURRENT to ARCH at its current position.  */
+
+static bool
+write_archive_member (bfd *arch, bfd *current)
+{
+  char buffer[DEFAULT_BUFFERSIZE];
+  bfd_size_type remaining = arelt_size (current);
+
+  /* Write ar header.  */
+  if (!_bfd_write_ar_hdr (arch, current))
+    return false;
+  if (bfd_is_thin_archive (arch))
+    return true;
+  if (bfd_seek (current, (file_ptr) 0, SEEK_SET) != 0)
+    goto input_err;
+
+  while (remaining)
+    {
+      size_t amt = DEFAULT_BUFFERSIZE;
+
+      if (amt > remaining)
+	amt = remaining;
+      errno = 0;
+      if (bfd_bread (buffer, amt, current) != amt)
+	goto input_err;
+      if (bfd_bwrite (buffer, amt, arch) != amt)
+	return false;
+      remaining -= amt;
+    }
+
+  if ((arelt_size (current) % 2) == 1)
+    {
+      if (bfd_bwrite (&ARFMAG[1], 1, arch) != 1)
+	return false;
+    }
+  return true;
+
+ input_err:
+  bfd_set_input_error (current, bfd_get_error ());
+  return false;
+}
+
+/* Return TRUE if SYM belongs in the symbol map of an archive.  */
+
+static bool
+armap_symbol_p (const asymbol *sym)
+{
+  return (((sym->flags & (BSF_GLOBAL
+			  | BSF_WEAK
+			  | BSF_INDIRECT
+			  | BSF_GNU_UNIQUE)) != 0
+	   || bfd_is_com_section (sym->section))
+	  && ! bfd_is_und_section (sym->section));
+}
+
+/* A symbol map being built by bfd_append_to_archive, with the names
+   in the order in which they will be written.  */
+
+struct append_armap
+{
+  carsym *syms;
+  size_t count;
+  size_t max;
+  /* The total size of the names, each with its terminating NUL.  */
+  bfd_size_type stringsize;
+};
+
+/* Add NAME, defined by the member whose header is at FILEPOS, to MAP.  */
+
+static bool
+add_armap_entry (struct append_armap *map, const char *name,
+		 file_ptr filepos)
+{
+  if (map->count == map->max)
+    {
+      carsym *syms;
+
+      map->max = map->max == 0 ? 1024 : map->max * 2;
+      syms = (carsym *) bfd_realloc (map->syms,
+				     map->max * sizeof (*map->syms));
+      if (syms == NULL)
+	return false;
+      map->syms = syms;
+    }
+  map->syms[map->count].name = name;
+  map->syms[map->count].file_offset = filepos;
+  map->count++;
+  map->stringsize += strlen (name) + 1;
+  return true;
+}
+
+/* Add to MAP the symbols of ABFD, a member of ARCH whose header is at
+   FILEPOS, that belong in the symbol map.  Set *ISOBJECT if ABFD is an
+   object file.  The names are copied to ARCH's memory.  */
+
+static bool
+add_armap_symbols (bfd *arch, bfd *abfd, file_ptr filepos,
+		   struct append_armap *map, bool *isobject)
+{
+  long storage, symcount, i;
+  asymbol **syms;
+  bool ok = true;
+
+  *isobject = bfd_check_format (abfd, bfd_object);
+  if (!*isobject || (bfd_get_file_flags (abfd) & HAS_SYMS) == 0)
+    return true;
+
+  storage = bfd_get_symtab_upper_bound (abfd);
+  if (storage <= 0)
+    return storage == 0;
+  syms = (asymbol **) bfd_malloc (storage);
+  if (syms == NULL)
+    return false;
+  symcount = bfd_canonicalize_symtab (abfd, syms);
+  if (symcount < 0)
+    ok = false;
+  for (i = 0; ok && i < symcount; i++)
+    if (armap_symbol_p (syms[i]))
+      {
+	size_t len = strlen (syms[i]->name) + 1;
+	char *name = (char *) bfd_alloc (arch, len);
+
+	ok = name != NULL;
+	if (ok)
+	  {
+	    memcpy (name, syms[i]->name, len);
+	    ok = add_armap_entry (map, name, filepos);
+	  }
+      }
+  free (syms);
+
+  /* Unlike _bfd_compute_and_write_armap, keep the symbols, since
+     ABFD may have yet to be written out.  */
+  return ok;
+}
+
+/* Set *END to the file position following the symbol map of ARCH, an
+   archive whose first member is a map as written by
+   _bfd_coff_write_armap.  Return FALSE if the map is of some other
+   kind, or is followed by a second map as PE archives have.  */
+
+static bool
+coff_armap_end (bfd *arch, file_ptr *end)
+{
+  static const char name[] = "/               ";
+  struct ar_hdr hdr;
+  bfd_size_type size;
+  char buf[sizeof (hdr.ar_size) + 1];
+
+  if (bfd_seek (arch, SARMAG, SEEK_SET) != 0
+      || bfd_bread (&hdr, sizeof (hdr), arch) != sizeof (hdr)
+      || memcmp (hdr.ar_name, name, sizeof (hdr.ar_name)) != 0
+      || memcmp (hdr.ar_fmag, ARFMAG, 2) != 0)
+    return false;
+  memcpy (buf, hdr.ar_size, sizeof (hdr.ar_size));
+  buf[sizeof (hdr.ar_size)] = 0;
+  if (sscanf (buf, "%" BFD_VMA_FMT "u", &size) != 1)
+    return false;
+  *end = SARMAG + sizeof (hdr) + size + (size & 1);
+
+  if (bfd_seek (arch, *end, SEEK_SET) != 0)
+    return false;
+  if (bfd_bread (&hdr, sizeof (hdr), arch) == sizeof (hdr)
+      && hdr.ar_name[0] == '/'
+      && hdr.ar_name[1] == ' ')
+    return false;
+  return true;
+}
+
+/* The size of the pieces in which move_archive_contents copies.  */
+#define ARCHIVE_MOVE_CHUNK (1024 * 1024)
+
+/* Move the SIZE bytes at FROM in ARCH up by DELTA bytes.  Copy the
+   last piece first, so that nothing is overwritten before it has
+   been copied.  */
+
+static bool
+move_archive_contents (bfd *arch, file_ptr from, bfd_size_type size,
+		       file_ptr delta)
+{
+  bfd_byte *buf;
+  bool ok = true;
+
+  buf = (bfd_byte *) bfd_malloc (ARCHIVE_MOVE_CHUNK);
+  if (buf == NULL)
+    return false;
+  while (ok && size > 0)
+    {
+      bfd_size_type chunk = size;
+
+      if (chunk > ARCHIVE_MOVE_CHUNK)
+	chunk = ARCHIVE_MOVE_CHUNK;
+      size -= chunk;
+      ok = (bfd_seek (arch, from + size, SEEK_SET) == 0
+	    && bfd_bread (buf, chunk, arch) == chunk
+	    && bfd_seek (arch, from + size + delta, SEEK_SET) == 0
+	    && bfd_bwrite (buf, chunk, arch) == chunk);
+    }
+  free (buf);
+  return ok;
+}
+
+/* Write MAP to ARCH as the symbol map at the start of the archive, in
+   the format of _bfd_coff_write_armap, padding it out to MAPSIZE
+   bytes.  The symbols' members have moved up by DELTA bytes.  */
+
+static bool
+write_appended_armap (bfd *arch, const struct append_armap *map,
+		      bfd_size_type mapsize, file_ptr delta)
+{
+  struct ar_hdr hdr;
+  bfd_size_type pad;
+  bfd_byte *zeros;
+  size_t i;
+  bool ok;
+
+  memset (&hdr, ' ', sizeof (struct ar_hdr));
+  hdr.ar_name[0] = '/';
+  if (!_bfd_ar_sizepad (hdr.ar_size, sizeof (hdr.ar_size), mapsize))
+    return false;
+  _bfd_ar_spacepad (hdr.ar_date, sizeof (hdr.ar_date), "%ld",
+		    ((arch->flags & BFD_DETERMINISTIC_OUTPUT) == 0
+		     ? time (NULL) : 0));
+  _bfd_ar_spacepad (hdr.ar_uid, sizeof (hdr.ar_uid), "%ld", 0);
+  _bfd_ar_spacepad (hdr.ar_gid, sizeof (hdr.ar_gid), "%ld", 0);
+  _bfd_ar_spacepad (hdr.ar_mode, sizeof (hdr.ar_mode), "%-7lo", 0);
+  memcpy (hdr.ar_fmag, ARFMAG, 2);
+
+  if (bfd_seek (arch, SARMAG, SEEK_SET) != 0
+      || bfd_bwrite (&hdr, sizeof (hdr), arch) != sizeof (hdr)
+      || !bfd_write_bigendian_4byte_int (arch, map->count))
+    return false;
+  for (i = 0; i < map->count; i++)
+    if (!bfd_write_bigendian_4byte_int (arch,
+					map->syms[i].file_offset + delta))
+      return false;
+  for (i = 0; i < map->count; i++)
+    {
+      bfd_size_type len = strlen (map->syms[i].name) + 1;
+
+      if (bfd_bwrite (map->syms[i].name, len, arch) != len)
+	return false;
+    }
+
+  /* The readers stop after the last name, so the rest is left for
+     the map to grow into.  */
+  pad = mapsize - (4 + 4 * map->count + map->stringsize);
+  if (pad == 0)
+    return true;
+  zeros = (bfd_byte *) bfd_zmalloc (pad);
+  if (zeros == NULL)
+    return false;
+  ok = bfd_bwrite (zeros, pad, arch) == pad;
+  free (zeros);
+  return ok;
+}
+
+/* Verify the timestamp in the archive file ARCH, which has just been
+   written with a symbol map.  If it would not be accepted by the
+   linker, rewrite it until it would be.  If anything odd happens,
+   break out and just return.  (The Berkeley linker checks the
+   timestamp and refuses to read the table-of-contents if it is >60
+   seconds less than the file's modified-time.  That painful hack
+   requires this painful hack.  */
+
+static void
+update_armap_timestamp (bfd *arch)
+{
+  int tries;
+
+  tries = 1;
+  do
+    {
+      if (bfd_update_armap_timestamp (arch))
+	break;
+      _bfd_error_handler
+	(_("warning: writing archive was slow: rewriting timestamp"));
+    }
+  while (++tries < 6);
+}
+
 /* The BFD is open for write and has its format set to bfd_archive.  */
 
 bool
@@ -2127,7 +2412,6 @@ _bfd_write_archive_contents (bfd *arch)
   /* If no .o's, don't bother to make a map.  */
   bool hasobjects = false;
   bfd_size_type wrote;
-  int tries;
   char *armag;
 
   /* Verify the viability of all entries; if any of them live in the
@@ -2212,65 +2496,269 @@ _bfd_write_archive_contents (bfd *arch)
   for (current = arch->archive_head;
        current != NULL;
        current = current->archive_next)
+    if (!write_archive_member (arch, current))
+      return false;
+
+  if (makemap && hasobjects)
+    update_armap_timestamp (arch);
+
+  return true;
+
+ input_err:
+  bfd_set_input_error (current, bfd_get_error ());
+  return false;
+}
+
+/*
+FUNCTION
+	bfd_append_to_archive
+
+SYNOPSIS
+	bool bfd_append_to_archive (bfd *archive, bfd *new_head,
+				    bool makemap);
+
+DESCRIPTION
+	Write the BFDs chained from @var{new_head} through their
+	<<archive_next>> fields to the end of @var{archive}, an
+	archive open for both reading and writing, without rebuilding
+	the archive.  The result holds the same members and symbols
+	as writing the whole archive would give, with a symbol map
+	if @var{makemap} is true and any member is an object file.  This is only possible if @var{archive} is a
+	normal archive, the names of the new members need no extended
+	name table, and @var{archive} keeps a map only if
+	@var{makemap} is true.  The flags of @var{archive} are used as
+	they would be when writing a whole archive.
+
+	The symbol map comes before the members and holds their
+	offsets.  If the new members add symbols to it, the map is
+	rewritten in place, which is possible when the target writes
+	maps as @code{_bfd_coff_write_armap} does.  Space left at the
+	end of the map by earlier appends is used if the map fits.
+	Otherwise the existing members are first moved up within the
+	file, leaving room for the map to grow by a quarter as much
+	again, so that later appends can use that space.
+
+RETURNS
+	<<TRUE>> if all is ok.  If the members cannot be appended, the
+	error is <<bfd_error_invalid_operation>> and nothing has been
+	written.  After any other error the archive may hold part of
+	the new members beyond its old end, and if members were being
+	moved it may be damaged.
+*/
+
+bool
+bfd_append_to_archive (bfd *arch, bfd *new_head, bool makemap)
+{
+  bfd *current;
+  bfd **made;
+  size_t count, i;
+  char *etable = NULL;
+  bfd_size_type elength = 0;
+  const char *ename = NULL;
+  struct stat buf;
+  struct append_armap map;
+  bool need_map = false;
+  file_ptr map_end = SARMAG;
+  file_ptr delta = 0;
+  bfd_size_type mapsize = 0;
+  bool ok;
+
+  if (bfd_get_format (arch) != bfd_archive
+      || arch->direction != both_direction
+      || bfd_is_thin_archive (arch)
+      || (bfd_has_map (arch) && !makemap)
+      || (arch->xvec->_bfd_write_contents[bfd_archive]
+	  != _bfd_write_archive_contents))
     {
-      char buffer[DEFAULT_BUFFERSIZE];
-      bfd_size_type remaining = arelt_size (current);
+      bfd_set_error (bfd_error_invalid_operation);
+      return false;
+    }
 
-      /* Write ar header.  */
-      if (!_bfd_write_ar_hdr (arch, current))
-	return false;
-      if (bfd_is_thin_archive (arch))
-	continue;
-      if (bfd_seek (current, (file_ptr) 0, SEEK_SET) != 0)
-	goto input_err;
+  count = 0;
+  for (current = new_head; current != NULL; current = current->archive_next)
+    {
+      if (bfd_write_p (current))
+	{
+	  bfd_set_error (bfd_error_invalid_operation);
+	  return false;
+	}
+      count++;
+    }
+
+  /* Construct headers for the new members as
+     _bfd_write_archive_contents would.  Those made here are freed
+     again if the members cannot be appended, so that a rewrite of
+     the whole archive starts afresh.  */
+  made = (bfd **) bfd_malloc (count * sizeof (*made));
+  if (made == NULL)
+    return false;
+  count = 0;
+  ok = true;
+  for (current = new_head; current != NULL; current = current->archive_next)
+    if (!current->arelt_data)
+      {
+	current->arelt_data =
+	  bfd_ar_hdr_from_filesystem (arch, bfd_get_filename (current),
+				      current);
+	if (!current->arelt_data)
+	  {
+	    bfd_set_input_error (current, bfd_get_error ());
+	    ok = false;
+	    break;
+	  }
+	made[count++] = current;
+
+	/* Put in the file name.  */
+	BFD_SEND (arch, _bfd_truncate_arname,
+		  (arch, bfd_get_filename (current),
+		   (char *) arch_hdr (current)));
+      }
+
+  /* The new names must fit in their headers.  */
+  if (ok)
+    {
+      arch->archive_head = new_head;
+      ok = BFD_SEND (arch, _bfd_construct_extended_name_table,
+		     (arch, &etable, &elength, &ename));
+      arch->archive_head = NULL;
+    }
+  if (ok && elength != 0)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      ok = false;
+    }
+
+  /* Archive members start on even offsets, so a file of odd size
+     has something other than members at its end.  */
+  if (ok
+      && (bfd_stat (arch, &buf) != 0
+	  || buf.st_size < SARMAG
+	  || (buf.st_size & 1) != 0))
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      ok = false;
+    }
+
+  /* Collect the symbols of the map that writing the whole archive
+     would give.  The new members' headers will start at the old end
+     of the file, less any move.  */
+  memset (&map, 0, sizeof (map));
+  if (ok && (bfd_has_map (arch) || makemap))
+    {
+      bool hasobjects = bfd_has_map (arch);
+      bool isobject;
+      file_ptr filepos;
 
-      while (remaining)
+      if (bfd_has_map (arch))
+	for (i = 0; ok && i < bfd_ardata (arch)->symdef_count; i++)
+	  ok = add_armap_entry (&map, bfd_ardata (arch)->symdefs[i].name,
+				bfd_ardata (arch)->symdefs[i].file_offset);
+      else
 	{
-	  size_t amt = DEFAULT_BUFFERSIZE;
+	  for (current = bfd_openr_next_archived_file (arch, NULL);
+	       ok && current != NULL;
+	       current = bfd_openr_next_archived_file (arch, current))
+	    {
+	      ok = add_armap_symbols (arch, current,
+				      arch_eltdata (current)->key,
+				      &map, &isobject);
+	      hasobjects |= isobject;
+	    }
+	  if (ok && bfd_get_error () != bfd_error_no_more_archived_files)
+	    ok = false;
+	}
 
-	  if (amt > remaining)
-	    amt = remaining;
-	  errno = 0;
-	  if (bfd_bread (buffer, amt, current) != amt)
-	    goto input_err;
-	  if (bfd_bwrite (buffer, amt, arch) != amt)
-	    return false;
-	  remaining -= amt;
+      filepos = buf.st_size;
+      for (current = new_head; ok && current != NULL;
+	   current = current->archive_next)
+	{
+	  if (!add_armap_symbols (arch, current, filepos, &map, &isobject))
+	    {
+	      bfd_set_input_error (current, bfd_get_error ());
+	      ok = false;
+	    }
+	  hasobjects |= isobject;
+	  filepos += sizeof (struct ar_hdr) + arelt_size (current);
+	  filepos += filepos % 2;
 	}
 
-      if ((arelt_size (current) % 2) == 1)
+      /* A map that gains no symbols can stay as it is.  */
+      need_map = (hasobjects
+		  && (!bfd_has_map (arch)
+		      || map.count != bfd_ardata (arch)->symdef_count));
+    }
+
+  if (ok && need_map)
+    {
+      /* Only maps written by _bfd_coff_write_armap are rewritten.  */
+      if (arch->xvec->write_armap != _bfd_coff_write_armap
+	  || (bfd_has_map (arch) && !coff_armap_end (arch, &map_end)))
 	{
-	  if (bfd_bwrite (&ARFMAG[1], 1, arch) != 1)
-	    return false;
+	  bfd_set_error (bfd_error_invalid_operation);
+	  ok = false;
 	}
     }
 
-  if (makemap && hasobjects)
+  if (ok && need_map)
     {
-      /* Verify the timestamp in the archive file.  If it would not be
-	 accepted by the linker, rewrite it until it would be.  If
-	 anything odd happens, break out and just return.  (The
-	 Berkeley linker checks the timestamp and refuses to read the
-	 table-of-contents if it is >60 seconds less than the file's
-	 modified-time.  That painful hack requires this painful hack.  */
-      tries = 1;
-      do
+      mapsize = 4 + 4 * (bfd_size_type) map.count + map.stringsize;
+      mapsize += mapsize & 1;
+      if (bfd_has_map (arch)
+	  && mapsize <= map_end - SARMAG - sizeof (struct ar_hdr))
+	mapsize = map_end - SARMAG - sizeof (struct ar_hdr);
+      else
 	{
-	  if (bfd_update_armap_timestamp (arch))
-	    break;
-	  _bfd_error_handler
-	    (_("warning: writing archive was slow: rewriting timestamp"));
+	  mapsize += mapsize / 4;
+	  mapsize += mapsize & 1;
+	  delta = SARMAG + sizeof (struct ar_hdr) + mapsize - map_end;
 	}
-      while (++tries < 6);
+
+      /* The offsets in the map are 32 bits.  Leave larger archives to
+	 _bfd_coff_write_armap, which switches to a 64-bit map.  */
+      for (i = 0; ok && i < map.count; i++)
+	if ((bfd_size_type) (map.syms[i].file_offset + delta) > 0xffffffff)
+	  {
+	    bfd_set_error (bfd_error_invalid_operation);
+	    ok = false;
+	  }
     }
 
-  return true;
+  if (!ok)
+    for (i = 0; i < count; i++)
+      {
+	free (made[i]->arelt_data);
+	made[i]->arelt_data = NULL;
+      }
+  free (made);
+  if (!ok)
+    {
+      free (map.syms);
+      return false;
+    }
 
- input_err:
-  bfd_set_input_error (current, bfd_get_error ());
-  return false;
+  /* Write the new members first, so that until the existing ones
+     are moved, an error leaves them intact.  */
+  if (bfd_seek (arch, buf.st_size + delta, SEEK_SET) != 0)
+    ok = false;
+  for (current = new_head; ok && current != NULL;
+       current = current->archive_next)
+    ok = write_archive_member (arch, current);
+
+  if (ok && delta != 0)
+    ok = move_archive_contents (arch, map_end, buf.st_size - map_end, delta);
+  if (ok && need_map)
+    {
+      ok = write_appended_armap (arch, &map, mapsize, delta);
+      arch->has_armap = true;
+    }
+  free (map.syms);
+
+  if (ok && bfd_has_map (arch))
+    update_armap_timestamp (arch);
+
+  return ok;
 }
-
+
 /* Note that the namidx for the first symbol is 0.  */
 
 bool
@@ -2352,15 +2840,7 @@ _bfd_compute_and_write_armap (bfd *arch, unsigned int elength)
 		 want.  */
 	      for (src_count = 0; src_count < symcount; src_count++)
 		{
-		  flagword flags = (syms[src_count])->flags;
-		  asection *sec = syms[src_count]->section;
-
-		  if (((flags & (BSF_GLOBAL
-				 | BSF_WEAK
-				 | BSF_INDIRECT
-				 | BSF_GNU_UNIQUE)) != 0
-		       || bfd_is_com_section (sec))
-		      && ! bfd_is_und_section (sec))
+		  if (armap_symbol_p (syms[src_count]))
 		    {
 		      bfd_size_type namelen;
 		      struct orl *new_map;
@@ -467,6 +467,20 @@ extern void bfd_free_window
 extern bool bfd_get_file_window
   (bfd *, file_ptr, bfd_size_type, bfd_window *, bool);
 
+/* A row of the line number table of a section, as returned by
+   bfd_find_line_rows.  */
+struct bfd_line_row
+{
+  /* Offset of the row within the section.  */
+  bfd_vma address;
+  /* What bfd_find_nearest_line_discriminator finds for ADDRESS, or
+     NULL names and a zero LINE if it finds nothing.  */
+  const char *filename;
+  const char *functionname;
+  unsigned int line;
+  unsigned int discriminator;
+};
+
 /* Externally visible ELF routines.  */
 
 /* Create a new BFD as if by bfd_openr.  Rather than opening a file,
@@ -474,6 +474,20 @@ extern void bfd_free_window
 extern bool bfd_get_file_window
   (bfd *, file_ptr, bfd_size_type, bfd_window *, bool);
 
+/* A row of the line number table of a section, as returned by
+   bfd_find_line_rows.  */
+struct bfd_line_row
+{
+  /* Offset of the row within the section.  */
+  bfd_vma address;
+  /* What bfd_find_nearest_line_discriminator finds for ADDRESS, or
+     NULL names and a zero LINE if it finds nothing.  */
+  const char *filename;
+  const char *functionname;
+  unsigned int line;
+  unsigned int discriminator;
+};
+
 /* Externally visible ELF routines.  */
 
 /* Create a new BFD as if by bfd_openr.  Rather than opening a file,
@@ -6608,17 +6622,22 @@ struct bfd
   /* Put pathnames into archives (non-POSIX).  */
 #define BFD_ARCHIVE_FULL_PATH  0x100000
 
+  /* Make bfd_read_minisymbols return canonical symbols, which can be
+     passed to bfd_get_synthetic_symtab.  */
+#define BFD_CANONICAL_MINISYMS 0x200000
+
   /* Flags bits to be saved in bfd_preserve_save.  */
 #define BFD_FLAGS_SAVED \
   (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
    | BFD_PLUGIN | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON \
-   | BFD_USE_ELF_STT_COMMON)
+   | BFD_USE_ELF_STT_COMMON | BFD_CANONICAL_MINISYMS)
 
   /* Flags bits which are for BFD use only.  */
 #define BFD_FLAGS_FOR_BFD_USE_MASK \
   (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
    | BFD_PLUGIN | BFD_TRADITIONAL_FORMAT | BFD_DETERMINISTIC_OUTPUT \
-   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON)
+   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
+   | BFD_CANONICAL_MINISYMS)
 
   /* The format which belongs to the BFD. (object, core, etc.)  */
   ENUM_BITFIELD (bfd_format) format : 3;
@@ -6805,6 +6824,9 @@ struct bfd
 
   /* For input BFDs, the build ID, if the object has one. */
   const struct bfd_build_id *build_id;
+
+  /* Decompressed contents of compressed sections, kept for reuse.  */
+  struct decompressed_cache_entry *decompressed_cache;
 };
 
 static inline const char *
@@ -7248,6 +7270,10 @@ bool bfd_convert_section_contents
    (bfd *ibfd, asection *isec, bfd *obfd,
     bfd_byte **ptr, bfd_size_type *ptr_size);
 
+bool bfd_find_line_rows
+   (bfd *abfd, asymbol **symbols, asection *section,
+    struct bfd_line_row **rows, size_t *count);
+
 /* Extracted from archive.c.  */
 symindex bfd_get_next_mapent
    (bfd *abfd, symindex previous, carsym **sym);
@@ -7256,6 +7282,9 @@ bool bfd_set_archive_head (bfd *output, bfd *new_head);
 
 bfd *bfd_openr_next_archived_file (bfd *archive, bfd *previous);
 
+bool bfd_append_to_archive (bfd *archive, bfd *new_head,
+    bool makemap);
+
 /* Extracted from corefile.c.  */
 const char *bfd_core_file_failing_command (bfd *abfd);
 
@@ -7907,6 +7936,19 @@ bool bfd_get_full_section_contents
 void bfd_cache_section_contents
    (asection *sec, void *contents);
 
+bool bfd_acquire_decompressed_section_contents
+   (bfd *abfd, asection *section, bfd_byte **ptr);
+
+void bfd_release_decompressed_section_contents
+   (bfd *abfd, const bfd_byte *contents);
+
+bool bfd_get_decompressed_section_contents
+   (bfd *abfd, asection *section, void *location, file_ptr offset,
+    bfd_size_type count);
+
+bfd_size_type bfd_set_decompressed_cache_limit
+   (bfd_size_type limit);
+
 bool bfd_is_section_compressed_with_header
    (bfd *abfd, asection *section,
     int *compression_header_size_p,
@@ -176,17 +176,22 @@ CODE_FRAGMENT
 .  {* Put pathnames into archives (non-POSIX).  *}
 .#define BFD_ARCHIVE_FULL_PATH  0x100000
 .
+.  {* Make bfd_read_minisymbols return canonical symbols, which can be
+.     passed to bfd_get_synthetic_symtab.  *}
+.#define BFD_CANONICAL_MINISYMS 0x200000
+.
 .  {* Flags bits to be saved in bfd_preserve_save.  *}
 .#define BFD_FLAGS_SAVED \
 .  (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
 .   | BFD_PLUGIN | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON \
-.   | BFD_USE_ELF_STT_COMMON)
+.   | BFD_USE_ELF_STT_COMMON | BFD_CANONICAL_MINISYMS)
 .
 .  {* Flags bits which are for BFD use only.  *}
 .#define BFD_FLAGS_FOR_BFD_USE_MASK \
 .  (BFD_IN_MEMORY | BFD_COMPRESS | BFD_DECOMPRESS | BFD_LINKER_CREATED \
 .   | BFD_PLUGIN | BFD_TRADITIONAL_FORMAT | BFD_DETERMINISTIC_OUTPUT \
-.   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON)
+.   | BFD_COMPRESS_GABI | BFD_CONVERT_ELF_COMMON | BFD_USE_ELF_STT_COMMON \
+.   | BFD_CANONICAL_MINISYMS)
 .
 .  {* The format which belongs to the BFD. (object, core, etc.)  *}
 .  ENUM_BITFIELD (bfd_format) format : 3;
@@ -373,6 +378,9 @@ CODE_FRAGMENT
 .
 .  {* For input BFDs, the build ID, if the object has one. *}
 .  const struct bfd_build_id *build_id;
+.
+.  {* Decompressed contents of compressed sections, kept for reuse.  *}
+.  struct decompressed_cache_entry *decompressed_cache;
 .};
 .
 .static inline const char *
@@ -2810,6 +2818,45 @@ bfd_convert_section_contents (bfd *ibfd, sec_ptr isec, bfd *obfd,
   return true;
 }
 
+/*
+FUNCTION
+	bfd_find_line_rows
+
+SYNOPSIS
+	bool bfd_find_line_rows
+	  (bfd *abfd, asymbol **symbols, asection *section,
+	   struct bfd_line_row **rows, size_t *count);
+
+DESCRIPTION
+	Return in @var{*rows}, sorted by address, the rows of the line
+	number table for @var{section} of @var{abfd}, and their number
+	in @var{*count}.  Rows also start wherever the function name
+	found by <<bfd_find_nearest_line>> may change.  Each row holds
+	what <<bfd_find_nearest_line_discriminator>> would find for
+	every address from its start up to the start of the next row,
+	so that a caller walking the section in address order need not
+	look up each address.  @var{*rows} is allocated with
+	<<malloc>>.
+
+RETURNS
+	FALSE, with no rows, if the line information is not known to
+	come only from DWARF and the symbol table.
+*/
+
+bool
+bfd_find_line_rows (bfd *abfd, asymbol **symbols, asection *section,
+		    struct bfd_line_row **rows, size_t *count)
+{
+  *rows = NULL;
+  *count = 0;
+
+  if (bfd_get_flavour (abfd) != bfd_target_elf_flavour)
+    return false;
+
+  return get_elf_backend_data (abfd)->find_line_rows (abfd, symbols, section,
+						      rows, count);
+}
+
 /* Get the linker information.  */
 
 struct bfd_link_info *
@@ -68,6 +68,225 @@ decompress_contents (bfd_byte *compressed_buffer,
   return inflateEnd (&strm) == Z_OK && rc == Z_OK && strm.avail_out == 0;
 }
 
+/* Read COUNT bytes of the still compressed contents of SEC, starting
+   at OFFSET, into BUF.  */
+
+static bool
+read_compressed_contents (bfd *abfd, sec_ptr sec, bfd_byte *buf,
+			  file_ptr offset, bfd_size_type count)
+{
+  bfd_size_type save_size = sec->size;
+  bfd_size_type save_rawsize = sec->rawsize;
+  unsigned int save_status = sec->compress_status;
+  bool ret;
+
+  /* Clear rawsize, set size to compressed size and set compress_status
+     to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
+     the uncompressed size, bfd_get_section_contents will fail.  */
+  sec->rawsize = 0;
+  sec->size = sec->compressed_size;
+  sec->compress_status = COMPRESS_SECTION_NONE;
+  ret = bfd_get_section_contents (abfd, sec, buf, offset, count);
+  /* Restore rawsize, size and compress_status.  */
+  sec->rawsize = save_rawsize;
+  sec->size = save_size;
+  sec->compress_status = save_status;
+  return ret;
+}
+
+/* Return the size of the header in front of the compressed data of
+   SEC.  */
+
+static unsigned int
+compressed_data_offset (bfd *abfd, sec_ptr sec)
+{
+  unsigned int compression_header_size;
+
+  compression_header_size = bfd_get_compression_header_size (abfd, sec);
+  if (compression_header_size == 0)
+    /* Set header size to the zlib header size if it is a
+       SHF_COMPRESSED section.  */
+    compression_header_size = 12;
+  return compression_header_size;
+}
+
+/* Read SEC, which must be DECOMPRESS_SECTION_SIZED, and decompress
+   its SZ bytes of contents into P.  */
+
+static bool
+read_and_decompress_contents (bfd *abfd, sec_ptr sec, bfd_byte *p,
+			      bfd_size_type sz)
+{
+  bfd_byte *compressed_buffer;
+  unsigned int compression_header_size;
+  bool ret;
+
+  /* Read in the full compressed section contents.  */
+  compressed_buffer = (bfd_byte *) bfd_malloc (sec->compressed_size);
+  if (compressed_buffer == NULL)
+    return false;
+  if (!read_compressed_contents (abfd, sec, compressed_buffer,
+				 0, sec->compressed_size))
+    {
+      free (compressed_buffer);
+      return false;
+    }
+
+  compression_header_size = compressed_data_offset (abfd, sec);
+  ret = decompress_contents (compressed_buffer + compression_header_size,
+			     sec->compressed_size - compression_header_size,
+			     p, sz);
+  if (!ret)
+    bfd_set_error (bfd_error_bad_value);
+  free (compressed_buffer);
+  return ret;
+}
+
+/* Decompressed section contents are kept in a cache so that a debug
+   section shared by several consumers, eg. the DWARF line number
+   reader and objdump's DWARF dumper, is only inflated once.  Each BFD
+   has its own cache, which is freed when the BFD is closed.  Entries
+   are added only by bfd_acquire_decompressed_section_contents, whose
+   callers share the cached buffer rather than taking a copy of it.
+   Entries are kept in most recently used order.  Entries that are not
+   currently referenced are discarded, least recently used first, once
+   their total size exceeds decompressed_cache_limit.  */
+
+struct decompressed_cache_entry
+{
+  struct decompressed_cache_entry *next;
+
+  /* The location of the compressed data.  Sections are identified by
+     their file position rather than by the asection pointer, as
+     bfd_check_format may discard and recreate sections.  */
+  file_ptr filepos;
+  bfd_size_type compressed_size;
+
+  /* The decompressed contents, SIZE bytes plus a terminating NUL.  */
+  bfd_size_type size;
+  bfd_byte *contents;
+
+  /* The number of outstanding
+     bfd_acquire_decompressed_section_contents references.  */
+  unsigned int refcount;
+};
+
+#define DEFAULT_DECOMPRESSED_CACHE_LIMIT (64 * 1024 * 1024)
+
+static bfd_size_type decompressed_cache_limit
+  = DEFAULT_DECOMPRESSED_CACHE_LIMIT;
+
+/* Return the cache entry for SEC in ABFD, or NULL if there is none.  */
+
+static struct decompressed_cache_entry *
+decompressed_cache_lookup (bfd *abfd, sec_ptr sec)
+{
+  struct decompressed_cache_entry **pp, *entry;
+
+  for (pp = &abfd->decompressed_cache; (entry = *pp) != NULL;
+       pp = &entry->next)
+    if (entry->filepos == sec->filepos
+	&& entry->compressed_size == sec->compressed_size
+	&& entry->size == sec->size)
+      {
+	/* Move to the front of the list.  */
+	*pp = entry->next;
+	entry->next = abfd->decompressed_cache;
+	abfd->decompressed_cache = entry;
+	return entry;
+      }
+  return NULL;
+}
+
+/* Discard unreferenced entries of ABFD's cache until those remaining
+   fit within decompressed_cache_limit.  */
+
+static void
+decompressed_cache_trim (bfd *abfd)
+{
+  struct decompressed_cache_entry **pp, *entry;
+  bfd_size_type total = 0;
+
+  pp = &abfd->decompressed_cache;
+  while ((entry = *pp) != NULL)
+    {
+      if (entry->refcount == 0)
+	{
+	  if (entry->size > decompressed_cache_limit
+	      || total > decompressed_cache_limit - entry->size)
+	    {
+	      *pp = entry->next;
+	      free (entry->contents);
+	      free (entry);
+	      continue;
+	    }
+	  total += entry->size;
+	}
+      pp = &entry->next;
+    }
+}
+
+/* Decompress SEC in ABFD and add it to the front of the cache.  */
+
+static struct decompressed_cache_entry *
+decompressed_cache_add (bfd *abfd, sec_ptr sec)
+{
+  struct decompressed_cache_entry *entry;
+
+  entry = (struct decompressed_cache_entry *) bfd_malloc (sizeof (*entry));
+  if (entry == NULL)
+    return NULL;
+  entry->contents = (bfd_byte *) bfd_malloc (sec->size + 1);
+  if (entry->contents == NULL
+      || !read_and_decompress_contents (abfd, sec, entry->contents,
+					sec->size))
+    {
+      free (entry->contents);
+      free (entry);
+      return NULL;
+    }
+  entry->contents[sec->size] = 0;
+  entry->filepos = sec->filepos;
+  entry->compressed_size = sec->compressed_size;
+  entry->size = sec->size;
+  entry->refcount = 0;
+  entry->next = abfd->decompressed_cache;
+  abfd->decompressed_cache = entry;
+  return entry;
+}
+
+/* Remove ENTRY, which must be unreferenced, from ABFD's cache and
+   return its contents, which the caller now owns.  */
+
+static bfd_byte *
+decompressed_cache_take (bfd *abfd, struct decompressed_cache_entry *entry)
+{
+  struct decompressed_cache_entry **pp;
+  bfd_byte *contents = entry->contents;
+
+  for (pp = &abfd->decompressed_cache; *pp != entry; pp = &(*pp)->next)
+    ;
+  *pp = entry->next;
+  free (entry);
+  return contents;
+}
+
+/* Free ABFD's cache.  Called when ABFD is closed.  */
+
+void
+_bfd_free_decompressed_cache (bfd *abfd)
+{
+  struct decompressed_cache_entry *entry, *next;
+
+  for (entry = abfd->decompressed_cache; entry != NULL; entry = next)
+    {
+      next = entry->next;
+      free (entry->contents);
+      free (entry);
+    }
+  abfd->decompressed_cache = NULL;
+}
+
 /* Compress data of the size specified in @var{uncompressed_size}
    and pointed to by @var{uncompressed_buffer} using zlib and store
    as the contents field.  This function assumes the contents
@@ -232,11 +451,7 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
 {
   bfd_size_type sz;
   bfd_byte *p = *ptr;
-  bool ret;
-  bfd_size_type save_size;
-  bfd_size_type save_rawsize;
-  bfd_byte *compressed_buffer;
-  unsigned int compression_header_size;
+  struct decompressed_cache_entry *entry;
 
   if (abfd->direction != write_direction && sec->rawsize != 0)
     sz = sec->rawsize;
@@ -299,49 +514,33 @@ bfd_get_full_section_contents (bfd *abfd, sec_ptr sec, bfd_byte **ptr)
       return true;
 
     case DECOMPRESS_SECTION_SIZED:
-      /* Read in the full compressed section contents.  */
-      compressed_buffer = (bfd_byte *) bfd_malloc (sec->compressed_size);
-      if (compressed_buffer == NULL)
-	return false;
-      save_rawsize = sec->rawsize;
-      save_size = sec->size;
-      /* Clear rawsize, set size to compressed size and set compress_status
-	 to COMPRESS_SECTION_NONE.  If the compressed size is bigger than
-	 the uncompressed size, bfd_get_section_contents will fail.  */
-      sec->rawsize = 0;
-      sec->size = sec->compressed_size;
-      sec->compress_status = COMPRESS_SECTION_NONE;
-      ret = bfd_get_section_contents (abfd, sec, compressed_buffer,
-				      0, sec->compressed_size);
-      /* Restore rawsize and size.  */
-      sec->rawsize = save_rawsize;
-      sec->size = save_size;
-      sec->compress_status = DECOMPRESS_SECTION_SIZED;
-      if (!ret)
-	goto fail_compressed;
+      /* The cache holds SEC->SIZE bytes, so it can't supply a
+	 different RAWSIZE.  Sections read here are not added to the
+	 cache, since the caller owns the buffer it is given.  */
+      entry = NULL;
+      if (sz == sec->size)
+	entry = decompressed_cache_lookup (abfd, sec);
+      if (entry != NULL && p == NULL && entry->refcount == 0)
+	{
+	  /* Nobody else is using the cached contents, so hand them
+	     over rather than copying them.  */
+	  *ptr = decompressed_cache_take (abfd, entry);
+	  return true;
+	}
 
       if (p == NULL)
 	p = (bfd_byte *) bfd_malloc (sz);
       if (p == NULL)
-	goto fail_compressed;
+	return false;
 
-      compression_header_size = bfd_get_compression_header_size (abfd, sec);
-      if (compression_header_size == 0)
-	/* Set header size to the zlib header size if it is a
-	   SHF_COMPRESSED section.  */
-	compression_header_size = 12;
-      if (!decompress_contents (compressed_buffer + compression_header_size,
-				sec->compressed_size - compression_header_size, p, sz))
+      if (entry != NULL)
+	memcpy (p, entry->contents, sz);
+      else if (!read_and_decompress_contents (abfd, sec, p, sz))
 	{
-	  bfd_set_error (bfd_error_bad_value);
 	  if (p != *ptr)
 	    free (p);
-	fail_compressed:
-	  free (compressed_buffer);
 	  return false;
 	}
-
-      free (compressed_buffer);
       *ptr = p;
       return true;
 
@@ -387,6 +586,232 @@ bfd_cache_section_contents (asection *sec, void *contents)
   sec->flags |= SEC_IN_MEMORY;
 }
 
+/*
+FUNCTION
+	bfd_acquire_decompressed_section_contents
+
+SYNOPSIS
+	bool bfd_acquire_decompressed_section_contents
+	  (bfd *abfd, asection *section, bfd_byte **ptr);
+
+DESCRIPTION
+	Decompress @var{section}, which must have been set up by
+	@code{bfd_init_section_decompress_status}, into a buffer shared
+	with other readers of the section and return the buffer in
+	@var{*ptr}.  The buffer holds the section contents followed by
+	a NUL byte, and must not be modified.  It remains valid until
+	it is released with
+	@code{bfd_release_decompressed_section_contents} or @var{abfd}
+	is closed.
+
+	Return @code{FALSE} if the section cannot be decompressed.
+*/
+
+bool
+bfd_acquire_decompressed_section_contents (bfd *abfd, sec_ptr sec,
+					   bfd_byte **ptr)
+{
+  struct decompressed_cache_entry *entry;
+
+  if (sec->compress_status != DECOMPRESS_SECTION_SIZED)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      return false;
+    }
+
+  entry = decompressed_cache_lookup (abfd, sec);
+  if (entry == NULL)
+    {
+      entry = decompressed_cache_add (abfd, sec);
+      if (entry == NULL)
+	return false;
+    }
+  entry->refcount++;
+  decompressed_cache_trim (abfd);
+  *ptr = entry->contents;
+  return true;
+}
+
+/*
+FUNCTION
+	bfd_release_decompressed_section_contents
+
+SYNOPSIS
+	void bfd_release_decompressed_section_contents
+	  (bfd *abfd, const bfd_byte *contents);
+
+DESCRIPTION
+	Drop a reference to @var{contents}, obtained from
+	@code{bfd_acquire_decompressed_section_contents} on @var{abfd}.
+	The contents may stay cached for later readers.
+*/
+
+void
+bfd_release_decompressed_section_contents (bfd *abfd,
+					   const bfd_byte *contents)
+{
+  struct decompressed_cache_entry *entry;
+
+  for (entry = abfd->decompressed_cache; entry != NULL; entry = entry->next)
+    if (entry->contents == contents)
+      {
+	if (entry->refcount != 0)
+	  entry->refcount--;
+	decompressed_cache_trim (abfd);
+	return;
+      }
+}
+
+/* The size of the pieces in which bfd_get_decompressed_section_contents
+   reads compressed data and discards unwanted decompressed data.  */
+#define DECOMPRESS_CHUNK_SIZE 65536
+
+/*
+FUNCTION
+	bfd_get_decompressed_section_contents
+
+SYNOPSIS
+	bool bfd_get_decompressed_section_contents
+	  (bfd *abfd, asection *section, void *location, file_ptr offset,
+	   bfd_size_type count);
+
+DESCRIPTION
+	Copy @var{count} bytes of the decompressed contents of
+	@var{section}, starting at @var{offset}, to @var{location}.
+	The section must have been set up by
+	@code{bfd_init_section_decompress_status}.  Unless the whole
+	section is already cached, only as much of the compressed data
+	as is needed to produce the requested bytes is read and
+	inflated, so reading a header at the start of a large section
+	is cheap.
+
+	Return @code{FALSE} if the section cannot be decompressed.
+*/
+
+bool
+bfd_get_decompressed_section_contents (bfd *abfd, sec_ptr sec,
+				       void *location, file_ptr offset,
+				       bfd_size_type count)
+{
+  struct decompressed_cache_entry *entry;
+  bfd_byte *inbuf, *scratch, *out;
+  bfd_size_type in_pos, skip;
+  z_stream strm;
+  int rc;
+
+  if (sec->compress_status != DECOMPRESS_SECTION_SIZED)
+    {
+      bfd_set_error (bfd_error_invalid_operation);
+      return false;
+    }
+
+  entry = decompressed_cache_lookup (abfd, sec);
+  if (entry != NULL
+      && (bfd_size_type) offset <= entry->size
+      && count <= entry->size - offset)
+    {
+      memcpy (location, entry->contents + offset, count);
+      return true;
+    }
+
+  inbuf = (bfd_byte *) bfd_malloc (2 * DECOMPRESS_CHUNK_SIZE);
+  if (inbuf == NULL)
+    return false;
+  scratch = inbuf + DECOMPRESS_CHUNK_SIZE;
+
+  /* The section may consist of several compressed buffers
+     concatenated together, as in decompress_contents.  */
+  memset (&strm, 0, sizeof strm);
+  rc = inflateInit (&strm);
+  in_pos = compressed_data_offset (abfd, sec);
+  skip = offset;
+  out = (bfd_byte *) location;
+  while (rc == Z_OK && count > 0)
+    {
+      unsigned int avail;
+
+      if (strm.avail_in == 0)
+	{
+	  bfd_size_type chunk;
+
+	  if (in_pos >= sec->compressed_size)
+	    break;
+	  chunk = sec->compressed_size - in_pos;
+	  if (chunk > DECOMPRESS_CHUNK_SIZE)
+	    chunk = DECOMPRESS_CHUNK_SIZE;
+	  if (!read_compressed_contents (abfd, sec, inbuf, in_pos, chunk))
+	    {
+	      inflateEnd (&strm);
+	      free (inbuf);
+	      return false;
+	    }
+	  in_pos += chunk;
+	  strm.next_in = inbuf;
+	  strm.avail_in = chunk;
+	}
+
+      if (skip > 0)
+	{
+	  strm.next_out = scratch;
+	  avail = skip < DECOMPRESS_CHUNK_SIZE ? skip : DECOMPRESS_CHUNK_SIZE;
+	}
+      else
+	{
+	  /* COUNT fits, as bfd_init_section_decompress_status rejects
+	     sections too large for a z_stream.  */
+	  strm.next_out = out;
+	  avail = count;
+	}
+      strm.avail_out = avail;
+      rc = inflate (&strm, Z_NO_FLUSH);
+      avail -= strm.avail_out;
+      if (skip > 0)
+	skip -= avail;
+      else
+	{
+	  out += avail;
+	  count -= avail;
+	}
+      if (rc == Z_STREAM_END)
+	rc = inflateReset (&strm);
+    }
+  inflateEnd (&strm);
+  free (inbuf);
+
+  if (count != 0)
+    {
+      bfd_set_error (bfd_error_bad_value);
+      return false;
+    }
+  return true;
+}
+
+/*
+FUNCTION
+	bfd_set_decompressed_cache_limit
+
+SYNOPSIS
+	bfd_size_type bfd_set_decompressed_cache_limit
+	  (bfd_size_type limit);
+
+DESCRIPTION
+	Set the total size of decompressed section contents each BFD
+	keeps for reuse to @var{limit} bytes.  Contents that are
+	currently acquired are not counted against the limit.  A limit
+	of zero disables caching.  A BFD's cache is brought within the
+	new limit the next time contents are acquired from or released
+	to it.  Return the previous limit.
+*/
+
+bfd_size_type
+bfd_set_decompressed_cache_limit (bfd_size_type limit)
+{
+  bfd_size_type old = decompressed_cache_limit;
+
+  decompressed_cache_limit = limit;
+  return old;
+}
+
 /*
 FUNCTION
 	bfd_is_section_compressed_with_header
@@ -36,6 +36,9 @@
 #include "elf-bfd.h"
 #include "dwarf2.h"
 #include "hashtab.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /* The data in the .debug_line statement prologue looks like this.  */
 
@@ -235,6 +238,27 @@ struct dwarf2_debug_file
 
   /* Root of a trie to map addresses to compilation units.  */
   struct trie_node *trie_root;
+
+  /* Section buffers above that were not malloc'd.  */
+  struct borrowed_section *borrowed_sections;
+};
+
+/* A section buffer that is mapped from the file, or shared with the
+   decompressed section cache, rather than read into a malloc'd
+   buffer of its own.  */
+
+struct borrowed_section
+{
+  struct borrowed_section *next;
+
+  /* The BFD the section belongs to, and its contents.  */
+  bfd *abfd;
+  bfd_byte *contents;
+
+  /* The page aligned mapping holding CONTENTS, or NULL if CONTENTS
+     were obtained from bfd_acquire_decompressed_section_contents.  */
+  void *map_addr;
+  bfd_size_type map_len;
 };
 
 struct dwarf2_debug
@@ -394,6 +418,14 @@ struct comp_unit
      already seen in this iteration.  */
   bool mark;
 
+  /* Used by _bfd_dwarf2_find_line_rows to walk the line table in step
+     with the rows: TRUE if the sequences and their lines are in
+     address order without overlap, and the current sequence and line
+     if so.  */
+  bool rows_in_step;
+  unsigned int row_seq;
+  unsigned int row_line;
+
  /* Base address of debug_addr section.  */
   size_t dwarf_addr_offset;
 
@@ -624,20 +656,144 @@ lookup_info_hash_table (struct info_hash_table *hash_table, const char *key)
   return entry ? entry->head : NULL;
 }
 
-/* Read a section into its appropriate place in the dwarf2_debug
-   struct (indicated by SECTION_BUFFER and SECTION_SIZE).  If SYMS is
-   not NULL, use bfd_simple_get_relocated_section_contents to read the
-   section contents, otherwise use bfd_get_section_contents.  Fail if
-   the located section does not contain at least OFFSET bytes.  */
+/* Sections smaller than this are always read rather than mapped.  */
+#define DWARF_MMAP_MIN_SIZE 65536
+
+/* Record that CONTENTS, a section of ABFD, were borrowed rather than
+   malloc'd for FILE.  MAP_ADDR and MAP_LEN describe the mapping, if
+   CONTENTS were mapped.  */
+
+static bool
+add_borrowed_section (struct dwarf2_debug_file *file, bfd *abfd,
+		      bfd_byte *contents, void *map_addr,
+		      bfd_size_type map_len)
+{
+  struct borrowed_section *b;
+
+  b = (struct borrowed_section *) bfd_malloc (sizeof (*b));
+  if (b == NULL)
+    return false;
+  b->abfd = abfd;
+  b->contents = contents;
+  b->map_addr = map_addr;
+  b->map_len = map_len;
+  b->next = file->borrowed_sections;
+  file->borrowed_sections = b;
+  return true;
+}
+
+/* Drop all the section buffers borrowed by FILE.  */
+
+static void
+release_borrowed_sections (struct dwarf2_debug_file *file)
+{
+  struct borrowed_section *b, *next;
+
+  for (b = file->borrowed_sections; b != NULL; b = next)
+    {
+      next = b->next;
+#ifdef HAVE_MMAP
+      if (b->map_addr != NULL)
+	munmap (b->map_addr, b->map_len);
+      else
+#endif
+	bfd_release_decompressed_section_contents (b->abfd, b->contents);
+      free (b);
+    }
+  file->borrowed_sections = NULL;
+}
+
+/* Free CONTENTS, a section buffer of FILE, unless it was borrowed.  */
+
+static void
+free_section_buffer (struct dwarf2_debug_file *file, bfd_byte *contents)
+{
+  struct borrowed_section *b;
+
+  for (b = file->borrowed_sections; b != NULL; b = b->next)
+    if (b->contents == contents)
+      return;
+  free (contents);
+}
+
+/* Try to provide the SIZE bytes of contents of MSEC, a section of
+   ABFD, without copying them.  Uncompressed sections are mapped
+   read-only from the file, so that only the parts of a large debug
+   section that are actually used are paged in.  Compressed sections
+   are shared with the decompressed section cache, which always
+   appends a NUL.  If NEED_NUL, a section is only mapped if it ends
+   with a NUL.  Return NULL if the contents must be read instead.  */
+
+static bfd_byte *
+borrow_section (struct dwarf2_debug_file *file, bfd *abfd, asection *msec,
+		bfd_size_type size, bool need_nul)
+{
+  bfd_byte *contents;
+
+  if ((msec->flags & (SEC_HAS_CONTENTS | SEC_IN_MEMORY)) != SEC_HAS_CONTENTS
+      || size < DWARF_MMAP_MIN_SIZE)
+    return NULL;
+
+  if (msec->compress_status == DECOMPRESS_SECTION_SIZED)
+    {
+      if (size != msec->size
+	  || !bfd_acquire_decompressed_section_contents (abfd, msec,
+							 &contents))
+	return NULL;
+      if (!add_borrowed_section (file, abfd, contents, NULL, 0))
+	{
+	  bfd_release_decompressed_section_contents (abfd, contents);
+	  return NULL;
+	}
+      return contents;
+    }
+
+#ifdef HAVE_MMAP
+  if (msec->compress_status == COMPRESS_SECTION_NONE
+      && msec->rawsize == 0
+      && size == msec->size
+      && (abfd->flags & BFD_IN_MEMORY) == 0
+      /* Accessing a mapping beyond the end of the file faults.  */
+      && msec->filepos >= 0
+      && (ufile_ptr) msec->filepos + size <= bfd_get_file_size (abfd))
+    {
+      void *map_addr;
+      bfd_size_type map_len;
+
+      contents = bfd_mmap (abfd, NULL, size, PROT_READ, MAP_PRIVATE,
+			   msec->filepos, &map_addr, &map_len);
+      if (contents == (bfd_byte *) -1)
+	return NULL;
+      if ((need_nul && contents[size - 1] != 0)
+	  || !add_borrowed_section (file, abfd, contents, map_addr, map_len))
+	{
+	  munmap (map_addr, map_len);
+	  return NULL;
+	}
+      return contents;
+    }
+#endif
+
+  return NULL;
+}
+
+/* Read a section into its appropriate place in the dwarf2_debug_file
+   struct FILE (indicated by SECTION_BUFFER and SECTION_SIZE).  If
+   FILE has symbols, use bfd_simple_get_relocated_section_contents to
+   read the section contents, otherwise use bfd_get_section_contents.
+   Sections that need no relocation may instead be borrowed, see
+   borrow_section.  Fail if the located section does not contain at
+   least OFFSET bytes.  */
 
 static bool
 read_section (bfd *abfd,
 	      const struct dwarf_debug_section *sec,
-	      asymbol **syms,
+	      struct dwarf2_debug_file *file,
 	      uint64_t offset,
 	      bfd_byte **section_buffer,
 	      bfd_size_type *section_size)
 {
+  asymbol **syms = file->syms;
   const char *section_name = sec->uncompressed_name;
   bfd_byte *contents = *section_buffer;
 
@@ -677,6 +833,27 @@ read_section (bfd *abfd,
 	  return false;
 	}
       *section_size = amt;
+
+      /* Relocations are applied in the same cases as
+	 bfd_simple_get_relocated_section_contents does.  */
+      if (syms == NULL
+	  || (abfd->flags & (HAS_RELOC | EXEC_P | DYNAMIC)) != HAS_RELOC
+	  || (msec->flags & SEC_RELOC) == 0)
+	{
+	  /* Strings are looked up by offset in these sections without
+	     checking for termination.  */
+	  bool need_nul = (strcmp (sec->uncompressed_name, ".debug_str") == 0
+			   || strcmp (sec->uncompressed_name,
+				      ".debug_line_str") == 0);
+
+	  contents = borrow_section (file, abfd, msec, amt, need_nul);
+	  if (contents != NULL)
+	    {
+	      *section_buffer = contents;
+	      goto check_offset;
+	    }
+	}
+
       /* Paranoia - alloc one extra so that we can make sure a string
 	 section is NUL terminated.  */
       amt += 1;
@@ -701,6 +878,7 @@ read_section (bfd *abfd,
       *section_buffer = contents;
     }
 
+ check_offset:
   /* It is possible to get a bad value for the offset into the section
      that the client wants.  Validate it here to avoid trouble later.  */
   if (offset != 0 && offset >= *section_size)
@@ -864,7 +1042,7 @@ read_indirect_string (struct comp_unit *unit,
     offset = read_8_bytes (unit->abfd, ptr, buf_end);
 
   if (! read_section (unit->abfd, &stash->debug_sections[debug_str],
-		      file->syms, offset,
+		      file, offset,
 		      &file->dwarf_str_buffer, &file->dwarf_str_size))
     return NULL;
 
@@ -898,7 +1076,7 @@ read_indirect_line_string (struct comp_unit *unit,
     offset = read_8_bytes (unit->abfd, ptr, buf_end);
 
   if (! read_section (unit->abfd, &stash->debug_sections[debug_line_str],
-		      file->syms, offset,
+		      file, offset,
 		      &file->dwarf_line_str_buffer,
 		      &file->dwarf_line_str_size))
     return NULL;
@@ -957,7 +1135,7 @@ read_alt_indirect_string (struct comp_unit *unit,
 
   if (! read_section (unit->stash->alt.bfd_ptr,
 		      stash->debug_sections + debug_str_alt,
-		      stash->alt.syms, offset,
+		      &stash->alt, offset,
 		      &stash->alt.dwarf_str_buffer,
 		      &stash->alt.dwarf_str_size))
     return NULL;
@@ -1002,7 +1180,7 @@ read_alt_indirect_ref (struct comp_unit *unit, uint64_t offset)
 
   if (! read_section (unit->stash->alt.bfd_ptr,
 		      stash->debug_sections + debug_info_alt,
-		      stash->alt.syms, offset,
+		      &stash->alt, offset,
 		      &stash->alt.dwarf_info_buffer,
 		      &stash->alt.dwarf_info_size))
     return NULL;
@@ -1152,7 +1330,7 @@ read_abbrevs (bfd *abfd, uint64_t offset, struct dwarf2_debug *stash,
     return ((struct abbrev_offset_entry *) (*slot))->abbrevs;
 
   if (! read_section (abfd, &stash->debug_sections[debug_abbrev],
-		      file->syms, offset,
+		      file, offset,
 		      &file->dwarf_abbrev_buffer,
 		      &file->dwarf_abbrev_size))
     return NULL;
@@ -1365,7 +1543,7 @@ read_indexed_address (uint64_t idx, struct comp_unit *unit)
     return 0;
 
   if (!read_section (unit->abfd, &stash->debug_sections[debug_addr],
-		     file->syms, 0,
+		     file, 0,
 		     &file->dwarf_addr_buffer, &file->dwarf_addr_size))
     return 0;
 
@@ -1403,12 +1581,12 @@ read_indexed_string (uint64_t idx, struct comp_unit *unit)
     return NULL;
 
   if (!read_section (unit->abfd, &stash->debug_sections[debug_str],
-		     file->syms, 0,
+		     file, 0,
 		     &file->dwarf_str_buffer, &file->dwarf_str_size))
     return NULL;
 
   if (!read_section (unit->abfd, &stash->debug_sections[debug_str_offsets],
-		     file->syms, 0,
+		     file, 0,
 		     &file->dwarf_str_offsets_buffer,
 		     &file->dwarf_str_offsets_size))
     return NULL;
@@ -2615,7 +2793,7 @@ decode_line_info (struct comp_unit *unit)
     return file->line_table;
 
   if (! read_section (abfd, &stash->debug_sections[debug_line],
-		      file->syms, unit->line_offset,
+		      file, unit->line_offset,
 		      &file->dwarf_line_buffer, &file->dwarf_line_size))
     return NULL;
 
@@ -3074,7 +3252,7 @@ read_debug_ranges (struct comp_unit * unit)
   struct dwarf2_debug_file *file = unit->file;
 
   return read_section (unit->abfd, &stash->debug_sections[debug_ranges],
-		       file->syms, 0,
+		       file, 0,
 		       &file->dwarf_ranges_buffer, &file->dwarf_ranges_size);
 }
 
@@ -3087,7 +3265,7 @@ read_debug_rnglists (struct comp_unit * unit)
   struct dwarf2_debug_file *file = unit->file;
 
   return read_section (unit->abfd, &stash->debug_sections[debug_rnglists],
-		       file->syms, 0,
+		       file, 0,
 		       &file->dwarf_rnglists_buffer, &file->dwarf_rnglists_size);
 }
 
@@ -5417,7 +5595,7 @@ _bfd_dwarf2_slurp_debug_info (bfd *abfd, bfd *debug_bfd,
       /* Case 1: only one info section.  */
       total_size = msec->size;
       if (! read_section (debug_bfd, &stash->debug_sections[debug_info],
-			  symbols, 0,
+			  &stash->f, 0,
 			  &stash->f.dwarf_info_buffer, &total_size))
 	return false;
     }
@@ -5907,6 +6085,358 @@ _bfd_dwarf2_find_nearest_line (bfd *abfd,
   return found;
 }
 
+/* Row boundaries being collected by _bfd_dwarf2_find_line_rows.  */
+
+struct line_row_set
+{
+  struct bfd_line_row *rows;
+  size_t count;
+  size_t alloc;
+  /* The address of the section, and its size in address units.  */
+  bfd_vma base;
+  bfd_vma limit;
+};
+
+/* Add a row starting at OFFSET within the section to SET.  */
+
+static bool
+line_row_add (struct line_row_set *set, bfd_vma offset)
+{
+  if (offset >= set->limit)
+    return true;
+
+  if (set->count == set->alloc)
+    {
+      size_t alloc = set->alloc ? set->alloc * 2 : 256;
+      struct bfd_line_row *rows;
+
+      rows = bfd_realloc (set->rows, alloc * sizeof (*rows));
+      if (rows == NULL)
+	return false;
+      set->rows = rows;
+      set->alloc = alloc;
+    }
+
+  set->rows[set->count++].address = offset;
+  return true;
+}
+
+/* Likewise for a row starting at address ADDR.  */
+
+static bool
+line_row_add_addr (struct line_row_set *set, bfd_vma addr)
+{
+  if (addr < set->base)
+    return true;
+  return line_row_add (set, addr - set->base);
+}
+
+/* Add to SET the places in SEC where _bfd_elf_find_function may find
+   a different symbol in SYMS, or may stop using its cached one.  */
+
+static bool
+line_row_add_syms (struct line_row_set *set, bfd *abfd,
+		   asymbol **syms, asection *sec)
+{
+  const struct elf_backend_data *bed;
+  asymbol **p;
+
+  if (syms == NULL || bfd_get_flavour (abfd) != bfd_target_elf_flavour)
+    return true;
+
+  bed = get_elf_backend_data (abfd);
+  for (p = syms; *p != NULL; p++)
+    {
+      asymbol *sym = *p;
+      bfd_vma code_off;
+      bfd_size_type size;
+
+      if ((sym->flags & BSF_FILE) != 0)
+	continue;
+
+      size = bed->maybe_function_sym (sym, sec, &code_off);
+      if (size != 0
+	  && (!line_row_add (set, code_off)
+	      || !line_row_add (set, sym->value)
+	      || !line_row_add (set, sym->value + size)))
+	return false;
+    }
+  return true;
+}
+
+static int
+compare_line_rows (const void *a, const void *b)
+{
+  const struct bfd_line_row *ra = (const struct bfd_line_row *) a;
+  const struct bfd_line_row *rb = (const struct bfd_line_row *) b;
+
+  if (ra->address < rb->address)
+    return -1;
+  return ra->address > rb->address;
+}
+
+/* Like lookup_address_in_line_info_table, but for addresses that
+   never decrease between calls, so that UNIT's line table can be
+   walked once instead of searched for every address.  */
+
+static bool
+lookup_address_in_line_rows (struct comp_unit *unit,
+			     bfd_vma addr,
+			     const char **filename_ptr,
+			     unsigned int *linenumber_ptr,
+			     unsigned int *discriminator_ptr)
+{
+  struct line_info_table *table = unit->line_table;
+  struct line_sequence *seq;
+  struct line_info *info;
+
+  if (!unit->rows_in_step)
+    return lookup_address_in_line_info_table (table, addr, filename_ptr,
+					      linenumber_ptr,
+					      discriminator_ptr);
+
+  while (unit->row_seq < table->num_sequences
+	 && addr >= table->sequences[unit->row_seq].last_line->address)
+    {
+      unit->row_seq++;
+      unit->row_line = 0;
+    }
+  if (unit->row_seq == table->num_sequences)
+    goto fail;
+
+  seq = &table->sequences[unit->row_seq];
+  if (addr < seq->low_pc)
+    goto fail;
+
+  while (unit->row_line + 1 < seq->num_lines
+	 && addr >= seq->line_info_lookup[unit->row_line + 1]->address)
+    unit->row_line++;
+
+  info = seq->line_info_lookup[unit->row_line];
+  if (addr >= info->address
+      && !(info->end_sequence || info == seq->last_line))
+    {
+      *filename_ptr = info->filename;
+      *linenumber_ptr = info->line;
+      *discriminator_ptr = info->discriminator;
+      return true;
+    }
+
+ fail:
+  *filename_ptr = NULL;
+  return false;
+}
+
+/* Fill in ROW, at address ADDR, as _bfd_dwarf2_find_nearest_line
+   would when it finds a function with a linkage name in the first
+   unit of the trie that covers ADDR.  Otherwise leave the row without
+   a function name for the caller to look up.  */
+
+static void
+line_row_fill (struct dwarf2_debug *stash, struct bfd_line_row *row,
+	       bfd_vma addr)
+{
+  struct trie_node *trie = stash->f.trie_root;
+  unsigned int bits = VMA_BITS - 8;
+  const struct trie_leaf *leaf;
+  unsigned int i;
+
+  row->filename = NULL;
+  row->functionname = NULL;
+  row->line = 0;
+  row->discriminator = 0;
+
+  while (trie && trie->num_room_in_leaf == 0)
+    {
+      int ch = (addr >> bits) & 0xff;
+      trie = ((struct trie_interior *) trie)->children[ch];
+      bits -= 8;
+    }
+  if (trie == NULL)
+    return;
+
+  leaf = (struct trie_leaf *) trie;
+  for (i = 0; i < leaf->num_stored_in_leaf; ++i)
+    leaf->ranges[i].unit->mark = false;
+
+  for (i = 0; i < leaf->num_stored_in_leaf; ++i)
+    {
+      struct comp_unit *unit = leaf->ranges[i].unit;
+      struct funcinfo *function = NULL;
+      bool line_p, func_p;
+
+      if (unit->mark
+	  || addr < leaf->ranges[i].low_pc
+	  || addr >= leaf->ranges[i].high_pc)
+	continue;
+      unit->mark = true;
+
+      if (!comp_unit_maybe_decode_line_info (unit))
+	continue;
+
+      func_p = lookup_address_in_function_table (unit, addr, &function);
+      line_p = lookup_address_in_line_rows (unit, addr, &row->filename,
+					    &row->line, &row->discriminator);
+      if (line_p || func_p)
+	{
+	  if (function != NULL
+	      && function->is_linkage
+	      && function->name != NULL)
+	    row->functionname = function->name;
+	  return;
+	}
+    }
+}
+
+/* Return in *ROWS_PTR and *COUNT_PTR the rows of the line number
+   table covering SECTION, as described for bfd_find_line_rows.
+   A row starts at every line table entry, at every bound of a
+   compilation unit or function range, and at every place where the
+   symbol search done when DWARF has no function name may give a
+   different answer.  Between two such places a lookup by
+   _bfd_dwarf2_find_nearest_line takes the same path to the same
+   result.  The rows are filled in by walking the line tables once
+   alongside them, except that rows needing that symbol search, or
+   not covered by the units' ranges, are left without a function name
+   for the caller to look up one at a time.  */
+
+bool
+_bfd_dwarf2_find_line_rows (bfd *abfd,
+			    asymbol **symbols,
+			    asection *section,
+			    const struct dwarf_debug_section *debug_sections,
+			    void **pinfo,
+			    struct bfd_line_row **rows_ptr,
+			    size_t *count_ptr)
+{
+  struct dwarf2_debug *stash;
+  struct line_row_set set;
+  struct comp_unit *each;
+  asymbol **syms;
+  asection *sec;
+  size_t i, n;
+  bool ok = false;
+
+  *rows_ptr = NULL;
+  *count_ptr = 0;
+
+  if ((section->flags & SEC_CODE) == 0)
+    return false;
+
+  if (! _bfd_dwarf2_slurp_debug_info (abfd, NULL, debug_sections,
+				      symbols, pinfo,
+				      (abfd->flags & (EXEC_P | DYNAMIC)) == 0))
+    return false;
+
+  stash = (struct dwarf2_debug *) *pinfo;
+  memset (&set, 0, sizeof (set));
+  if (! stash->f.info_ptr)
+    goto out;
+
+  /* Every unit has to be known for the rows to be complete.  Lookups
+     that miss in the units read so far read the rest anyway.  */
+  while (stash_comp_unit (stash, &stash->f) != NULL)
+    ;
+
+  if (section->output_section)
+    set.base = section->output_section->vma + section->output_offset;
+  else
+    set.base = section->vma;
+  set.limit = bfd_get_section_limit (abfd, section);
+
+  if (!line_row_add (&set, 0))
+    goto out;
+
+  for (each = stash->f.all_comp_units; each; each = each->next_unit)
+    {
+      each->rows_in_step = false;
+      each->row_seq = 0;
+      each->row_line = 0;
+    }
+
+  for (each = stash->f.all_comp_units; each; each = each->next_unit)
+    {
+      struct line_info_table *table;
+      struct funcinfo *func;
+      struct arange *arange;
+      bool wanted = each->arange.high == 0;
+
+      for (arange = &each->arange; arange != NULL; arange = arange->next)
+	if (arange->high > set.base && arange->low < set.base + set.limit)
+	  wanted = true;
+      if (!wanted || !comp_unit_maybe_decode_line_info (each))
+	continue;
+
+      for (arange = &each->arange; arange != NULL; arange = arange->next)
+	if (arange->high != 0
+	    && (!line_row_add_addr (&set, arange->low)
+		|| !line_row_add_addr (&set, arange->high)))
+	  goto out;
+
+      table = each->line_table;
+      each->rows_in_step = true;
+      for (n = 0; n < table->num_sequences; n++)
+	{
+	  struct line_sequence *seq = &table->sequences[n];
+
+	  if (!build_line_info_table (table, seq)
+	      || !line_row_add_addr (&set, seq->low_pc))
+	    goto out;
+	  if (n > 0 && seq->low_pc < seq[-1].last_line->address)
+	    each->rows_in_step = false;
+	  for (i = 0; i < seq->num_lines; i++)
+	    {
+	      if (i > 0
+		  && (seq->line_info_lookup[i]->address
+		      < seq->line_info_lookup[i - 1]->address))
+		each->rows_in_step = false;
+	      if (!line_row_add_addr (&set,
+				      seq->line_info_lookup[i]->address))
+		goto out;
+	    }
+	}
+
+      for (func = each->function_table; func != NULL; func = func->prev_func)
+	for (arange = &func->arange; arange != NULL; arange = arange->next)
+	  if (arange->high != 0
+	      && (!line_row_add_addr (&set, arange->low)
+		  || !line_row_add_addr (&set, arange->high)))
+	    goto out;
+    }
+
+  /* The symbols searched when DWARF does not name the function.  */
+  sec = section;
+  syms = symbols;
+  _bfd_dwarf2_stash_syms (stash, abfd, &sec, &syms);
+  if (!line_row_add_syms (&set, abfd, syms, sec)
+      || (syms != symbols
+	  && !line_row_add_syms (&set, abfd, symbols, section)))
+    goto out;
+
+  qsort (set.rows, set.count, sizeof (*set.rows), compare_line_rows);
+  for (i = n = 0; i < set.count; i++)
+    if (n == 0 || set.rows[i].address != set.rows[n - 1].address)
+      set.rows[n++] = set.rows[i];
+  set.count = n;
+
+  for (i = 0; i < set.count; i++)
+    line_row_fill (stash, &set.rows[i], set.base + set.rows[i].address);
+  ok = true;
+
+ out:
+  if ((abfd->flags & (EXEC_P | DYNAMIC)) == 0)
+    unset_sections (stash);
+
+  if (!ok)
+    {
+      free (set.rows);
+      return false;
+    }
+  *rows_ptr = set.rows;
+  *count_ptr = set.count;
+  return true;
+}
+
 bool
 _bfd_dwarf2_find_inliner_info (bfd *abfd ATTRIBUTE_UNUSED,
 			       const char **filename_ptr,
@@ -5990,12 +6520,13 @@ _bfd_dwarf2_cleanup_debug_info (bfd *abfd, void **pinfo)
 	}
       htab_delete (file->abbrev_offsets);
 
-      free (file->dwarf_line_str_buffer);
-      free (file->dwarf_str_buffer);
-      free (file->dwarf_ranges_buffer);
-      free (file->dwarf_line_buffer);
-      free (file->dwarf_abbrev_buffer);
-      free (file->dwarf_info_buffer);
+      free_section_buffer (file, file->dwarf_line_str_buffer);
+      free_section_buffer (file, file->dwarf_str_buffer);
+      free_section_buffer (file, file->dwarf_ranges_buffer);
+      free_section_buffer (file, file->dwarf_line_buffer);
+      free_section_buffer (file, file->dwarf_abbrev_buffer);
+      free_section_buffer (file, file->dwarf_info_buffer);
+      release_borrowed_sections (file);
       if (file == &stash->alt)
 	break;
       file = &stash->alt;
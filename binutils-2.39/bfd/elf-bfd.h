@@ -1514,6 +1514,10 @@ struct elf_backend_data
   bfd_size_type (*maybe_function_sym) (const asymbol *sym, asection *sec,
 				       bfd_vma *code_off);
 
+  /* Find the line number table rows of SEC, for bfd_find_line_rows.  */
+  bool (*find_line_rows) (bfd *abfd, asymbol **syms, asection *sec,
+			  struct bfd_line_row **rows, size_t *count);
+
   /* Given NAME, the name of a relocation section stripped of its
      .rel/.rela prefix, return the section in ABFD to which the
      relocations apply.  */
@@ -1988,6 +1992,14 @@ struct elf_obj_tdata
   Elf_Internal_Shdr dynverref_hdr;
   Elf_Internal_Shdr dynverdef_hdr;
   elf_section_list * symtab_shndx_list;
+
+  /* The external symbols of symtab_hdr, when they are used as
+     minisymbols.  They are mapped from the file if minisym_map_addr
+     is non-NULL, otherwise read into memory.  */
+  void *minisym_table;
+  void *minisym_map_addr;
+  bfd_size_type minisym_map_len;
+
   bfd_vma gp;				/* The gp value */
   unsigned int gp_size;			/* The gp size */
   unsigned int num_elf_sections;	/* elf_sect_ptr size */
@@ -2067,9 +2079,11 @@ struct elf_obj_tdata
   Elf_Internal_Shdr **group_sect_ptr;
   unsigned int num_group;
 
-  /* Index into group_sect_ptr, updated by setup_group when finding a
-     section's group.  Used to optimize subsequent group searches.  */
-  unsigned int group_search_offset;
+  /* Indexed by ELF section index, one more than the index into
+     group_sect_ptr of the group containing the section, or zero if the
+     section is not in any group.  Built by setup_group when it reads
+     the group sections.  */
+  unsigned int *sect_group_index;
 
   unsigned int symtab_section, dynsymtab_section;
   unsigned int dynversym_section, dynverdef_section, dynverref_section;
@@ -2335,12 +2349,12 @@ extern bool _bfd_elf_find_nearest_line
    const char **, const char **, unsigned int *, unsigned int *);
 extern bool _bfd_elf_find_line
   (bfd *, asymbol **, asymbol *, const char **, unsigned int *);
+extern bool _bfd_elf_find_line_rows
+  (bfd *, asymbol **, asection *, struct bfd_line_row **, size_t *);
 extern bool _bfd_elf_find_inliner_info
   (bfd *, const char **, const char **, unsigned int *);
 extern asymbol *_bfd_elf_find_function
   (bfd *, asymbol **, asection *, bfd_vma, const char **, const char **);
-#define _bfd_elf_read_minisymbols _bfd_generic_read_minisymbols
-#define _bfd_elf_minisymbol_to_symbol _bfd_generic_minisymbol_to_symbol
 extern int _bfd_elf_sizeof_headers
   (bfd *, struct bfd_link_info *);
 extern bool _bfd_elf_new_section_hook
@@ -2571,6 +2585,10 @@ extern void bfd_elf32_swap_dyn_out
   (bfd *, const Elf_Internal_Dyn *, void *);
 extern long bfd_elf32_slurp_symbol_table
   (bfd *, asymbol **, bool);
+extern long bfd_elf32_read_minisymbols
+  (bfd *, bool, void **, unsigned int *);
+extern asymbol *bfd_elf32_minisymbol_to_symbol
+  (bfd *, bool, const void *, asymbol *);
 extern bool bfd_elf32_write_shdrs_and_ehdr
   (bfd *);
 extern int bfd_elf32_write_out_phdrs
@@ -2619,6 +2637,10 @@ extern void bfd_elf64_swap_dyn_out
   (bfd *, const Elf_Internal_Dyn *, void *);
 extern long bfd_elf64_slurp_symbol_table
   (bfd *, asymbol **, bool);
+extern long bfd_elf64_read_minisymbols
+  (bfd *, bool, void **, unsigned int *);
+extern asymbol *bfd_elf64_minisymbol_to_symbol
+  (bfd *, bool, const void *, asymbol *);
 extern bool bfd_elf64_write_shdrs_and_ehdr
   (bfd *);
 extern int bfd_elf64_write_out_phdrs
@@ -44,6 +44,9 @@ SECTION
 #include "libiberty.h"
 #include "safe-ctype.h"
 #include "elf-linux-core.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #ifdef CORE_HEADER
 #include CORE_HEADER
@@ -592,10 +595,12 @@ group_signature (bfd *abfd, Elf_Internal_Shdr *ghdr)
   return bfd_elf_sym_name (abfd, hdr, &isym, NULL);
 }
 
-/* Set next_in_group list pointer, and group name for NEWSECT.  */
+/* Set next_in_group list pointer, and group name for NEWSECT, whose
+   section header HDR has index SHINDEX.  */
 
 static bool
-setup_group (bfd *abfd, Elf_Internal_Shdr *hdr, asection *newsect)
+setup_group (bfd *abfd, Elf_Internal_Shdr *hdr, unsigned int shindex,
+	     asection *newsect)
 {
   unsigned int num_group = elf_tdata (abfd)->num_group;
 
@@ -642,6 +647,13 @@ setup_group (bfd *abfd, Elf_Internal_Shdr *hdr, asection *newsect)
 	    = (Elf_Internal_Shdr **) bfd_zalloc (abfd, amt);
 	  if (elf_tdata (abfd)->group_sect_ptr == NULL)
 	    return false;
+	  /* Also map each section to its group, so that finding the
+	     group of a section does not mean searching every group.  */
+	  amt = shnum * sizeof (unsigned int);
+	  elf_tdata (abfd)->sect_group_index
+	    = (unsigned int *) bfd_zalloc (abfd, amt);
+	  if (elf_tdata (abfd)->sect_group_index == NULL)
+	    return false;
 	  num_group = 0;
 
 	  for (i = 0; i < shnum; i++)
@@ -722,6 +734,10 @@ setup_group (bfd *abfd, Elf_Internal_Shdr *hdr, asection *newsect)
 			       abfd, i);
 			  dest->shdr = NULL;
 			}
+		      /* If a section claims to be in more than one group,
+			 the first group wins.  */
+		      else if (elf_tdata (abfd)->sect_group_index[idx] == 0)
+			elf_tdata (abfd)->sect_group_index[idx] = num_group;
 		    }
 		}
 	    }
@@ -744,22 +760,19 @@ setup_group (bfd *abfd, Elf_Internal_Shdr *hdr, asection *newsect)
 	}
     }
 
-  if (num_group != (unsigned) -1)
+  if (num_group != (unsigned) -1
+      && shindex < elf_numsections (abfd)
+      && elf_elfsections (abfd)[shindex] == hdr
+      && elf_tdata (abfd)->sect_group_index[shindex] != 0)
     {
-      unsigned int search_offset = elf_tdata (abfd)->group_search_offset;
-      unsigned int j;
+      unsigned int i = elf_tdata (abfd)->sect_group_index[shindex] - 1;
+      Elf_Internal_Shdr *shdr = elf_tdata (abfd)->group_sect_ptr[i];
 
-      for (j = 0; j < num_group; j++)
+      if (shdr != NULL)
 	{
-	  /* Begin search from previous found group.  */
-	  unsigned i = (j + search_offset) % num_group;
-
-	  Elf_Internal_Shdr *shdr = elf_tdata (abfd)->group_sect_ptr[i];
 	  Elf_Internal_Group *idx;
 	  bfd_size_type n_elt;
-
-	  if (shdr == NULL)
-	    continue;
+	  asection *s = NULL;
 
 	  idx = (Elf_Internal_Group *) shdr->contents;
 	  if (idx == NULL || shdr->sh_size < 4)
@@ -772,55 +785,40 @@ setup_group (bfd *abfd, Elf_Internal_Shdr *hdr, asection *newsect)
 	      bfd_set_error (bfd_error_bad_value);
 	      return false;
 	    }
-	  n_elt = shdr->sh_size / 4;
 
-	  /* Look through this group's sections to see if current
-	     section is a member.  */
+	  /* We are a member of this group.  Go looking through other
+	     members to see if any others are linked via next_in_group.  */
+	  n_elt = shdr->sh_size / 4;
 	  while (--n_elt != 0)
-	    if ((++idx)->shdr == hdr)
-	      {
-		asection *s = NULL;
-
-		/* We are a member of this group.  Go looking through
-		   other members to see if any others are linked via
-		   next_in_group.  */
-		idx = (Elf_Internal_Group *) shdr->contents;
-		n_elt = shdr->sh_size / 4;
-		while (--n_elt != 0)
-		  if ((++idx)->shdr != NULL
-		      && (s = idx->shdr->bfd_section) != NULL
-		      && elf_next_in_group (s) != NULL)
-		    break;
-		if (n_elt != 0)
-		  {
-		    /* Snarf the group name from other member, and
-		       insert current section in circular list.  */
-		    elf_group_name (newsect) = elf_group_name (s);
-		    elf_next_in_group (newsect) = elf_next_in_group (s);
-		    elf_next_in_group (s) = newsect;
-		  }
-		else
-		  {
-		    const char *gname;
-
-		    gname = group_signature (abfd, shdr);
-		    if (gname == NULL)
-		      return false;
-		    elf_group_name (newsect) = gname;
+	    if ((++idx)->shdr != NULL
+		&& (s = idx->shdr->bfd_section) != NULL
+		&& elf_next_in_group (s) != NULL)
+	      break;
+	  if (n_elt != 0)
+	    {
+	      /* Snarf the group name from other member, and
+		 insert current section in circular list.  */
+	      elf_group_name (newsect) = elf_group_name (s);
+	      elf_next_in_group (newsect) = elf_next_in_group (s);
+	      elf_next_in_group (s) = newsect;
+	    }
+	  else
+	    {
+	      const char *gname;
 
-		    /* Start a circular list with one element.  */
-		    elf_next_in_group (newsect) = newsect;
-		  }
+	      gname = group_signature (abfd, shdr);
+	      if (gname == NULL)
+		return false;
+	      elf_group_name (newsect) = gname;
 
-		/* If the group section has been created, point to the
-		   new member.  */
-		if (shdr->bfd_section != NULL)
-		  elf_next_in_group (shdr->bfd_section) = newsect;
+	      /* Start a circular list with one element.  */
+	      elf_next_in_group (newsect) = newsect;
+	    }
 
-		elf_tdata (abfd)->group_search_offset = i;
-		j = num_group - 1;
-		break;
-	      }
+	  /* If the group section has been created, point to the
+	     new member.  */
+	  if (shdr->bfd_section != NULL)
+	    elf_next_in_group (shdr->bfd_section) = newsect;
 	}
     }
 
@@ -1055,7 +1053,7 @@ _bfd_elf_make_section_from_shdr (bfd *abfd,
   if ((hdr->sh_flags & SHF_STRINGS) != 0)
     flags |= SEC_STRINGS;
   if (hdr->sh_flags & SHF_GROUP)
-    if (!setup_group (abfd, hdr, newsect))
+    if (!setup_group (abfd, hdr, shindex, newsect))
       return false;
   if ((hdr->sh_flags & SHF_TLS) != 0)
     flags |= SEC_THREAD_LOCAL;
@@ -9354,6 +9352,57 @@ _bfd_elf_find_line (bfd *abfd, asymbol **symbols, asymbol *symbol,
 					&elf_tdata (abfd)->dwarf2_find_line_info);
 }
 
+/* Find the line number table rows of SECTION.  The rows describe
+   only what _bfd_elf_find_nearest_line finds in DWARF and the symbol
+   table, so fail if the target looks elsewhere or there are older
+   kinds of line information that might be consulted.  */
+
+bool
+_bfd_elf_find_line_rows (bfd *abfd, asymbol **symbols, asection *section,
+			 struct bfd_line_row **rows, size_t *count)
+{
+  size_t i, n;
+
+  if (abfd->xvec->_bfd_find_nearest_line != _bfd_elf_find_nearest_line
+      || bfd_get_section_by_name (abfd, ".debug") != NULL
+      || bfd_get_section_by_name (abfd, ".stab") != NULL)
+    return false;
+
+  if (!_bfd_dwarf2_find_line_rows (abfd, symbols, section,
+				   dwarf_debug_sections,
+				   &elf_tdata (abfd)->dwarf2_find_line_info,
+				   rows, count))
+    return false;
+
+  /* Look up the rows that DWARF alone could not fill in, merging
+     those that find the same line.  */
+  for (i = n = 0; i < *count; i++)
+    {
+      struct bfd_line_row *row = &(*rows)[n];
+
+      *row = (*rows)[i];
+      if (row->functionname == NULL
+	  && !_bfd_elf_find_nearest_line (abfd, symbols, section,
+					  row->address, &row->filename,
+					  &row->functionname, &row->line,
+					  &row->discriminator))
+	{
+	  row->filename = NULL;
+	  row->functionname = NULL;
+	  row->line = 0;
+	  row->discriminator = 0;
+	}
+      if (n == 0
+	  || row->filename != row[-1].filename
+	  || row->functionname != row[-1].functionname
+	  || row->line != row[-1].line
+	  || row->discriminator != row[-1].discriminator)
+	n++;
+    }
+  *count = n;
+  return true;
+}
+
 /* After a call to bfd_find_nearest_line, successive calls to
    bfd_find_inliner_info can be used to get source information about
    each level of function inlining that terminated at the address
@@ -9582,6 +9631,12 @@ _bfd_elf_close_and_cleanup (bfd *abfd)
       if (elf_tdata (abfd)->o != NULL && elf_shstrtab (abfd) != NULL)
 	_bfd_elf_strtab_free (elf_shstrtab (abfd));
       _bfd_dwarf2_cleanup_debug_info (abfd, &tdata->dwarf2_find_line_info);
+#ifdef HAVE_MMAP
+      if (tdata->minisym_map_addr != NULL)
+	munmap (tdata->minisym_map_addr, tdata->minisym_map_len);
+      else
+#endif
+	free (tdata->minisym_table);
     }
 
   return _bfd_generic_close_and_cleanup (abfd);
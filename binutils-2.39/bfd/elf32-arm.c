@@ -6411,6 +6411,330 @@ set_cmse_veneer_addr_from_implib (struct bfd_link_info *info,
   return ret;
 }
 
+/* A branch that might need a stub.  The relocs of each input bfd are
+   only read once, by elf32_arm_find_branch_sites, and later iterations
+   of elf32_arm_size_stubs only check again the branches whose location
+   or destination moved.  */
+
+struct arm_branch_site
+{
+  /* The branch and the section and bfd it is in.  */
+  bfd *input_bfd;
+  asection *section;
+  Elf_Internal_Rela rel;
+
+  /* The call target, its name, value and section.  */
+  struct elf32_arm_link_hash_entry *hash;
+  const char *sym_name;
+  asection *sym_sec;
+  bfd_vma sym_value;
+  unsigned char st_type;
+  enum arm_st_branch_type sym_branch_type;
+
+  /* The destination is DEST_VALUE within DEST_SEC, or the absolute
+     address DEST_VALUE if DEST_SEC is NULL.  */
+  asection *dest_sec;
+  bfd_vma dest_value;
+
+  /* The location and destination of the branch when it was last
+     checked, the branch type arm_type_of_stub chose for it, and
+     whether it needed a stub.  */
+  bool checked;
+  bfd_vma location;
+  bfd_vma destination;
+  enum arm_st_branch_type branch_type;
+  bool has_stub;
+};
+
+/* Append to *SITES, which has room for *ALLOC entries of which *COUNT
+   are used, the branches in INPUT_BFD which might need a stub.  */
+
+static bool
+elf32_arm_find_branch_sites (bfd *output_bfd,
+			     struct bfd_link_info *info,
+			     bfd *input_bfd,
+			     struct arm_branch_site **sites,
+			     unsigned int *count,
+			     unsigned int *alloc)
+{
+  struct elf32_arm_link_hash_table *htab = elf32_arm_hash_table (info);
+  Elf_Internal_Shdr *symtab_hdr = &elf_tdata (input_bfd)->symtab_hdr;
+  Elf_Internal_Sym *local_syms = NULL;
+  asection *section;
+  bool ret = false;
+
+  /* Walk over each section attached to the input bfd.  */
+  for (section = input_bfd->sections;
+       section != NULL;
+       section = section->next)
+    {
+      Elf_Internal_Rela *internal_relocs, *irelaend, *irela;
+
+      /* If there aren't any relocs, then there's nothing more
+	 to do.  */
+      if ((section->flags & SEC_RELOC) == 0
+	  || section->reloc_count == 0
+	  || (section->flags & SEC_CODE) == 0)
+	continue;
+
+      /* If this section is a link-once section that will be
+	 discarded, then don't create any stubs.  */
+      if (section->output_section == NULL
+	  || section->output_section->owner != output_bfd)
+	continue;
+
+      /* Get the relocs.  */
+      internal_relocs
+	= _bfd_elf_link_read_relocs (input_bfd, section, NULL,
+				     NULL, info->keep_memory);
+      if (internal_relocs == NULL)
+	goto error_ret_free_local;
+
+      /* Now examine each relocation.  */
+      irela = internal_relocs;
+      irelaend = irela + section->reloc_count;
+      for (; irela < irelaend; irela++)
+	{
+	  unsigned int r_type, r_indx;
+	  struct arm_branch_site *site;
+	  asection *sym_sec, *dest_sec;
+	  bfd_vma sym_value, dest_value;
+	  struct elf32_arm_link_hash_entry *hash;
+	  const char *sym_name;
+	  unsigned char st_type;
+	  enum arm_st_branch_type branch_type;
+
+	  r_type = ELF32_R_TYPE (irela->r_info);
+	  r_indx = ELF32_R_SYM (irela->r_info);
+
+	  if (r_type >= (unsigned int) R_ARM_max)
+	    {
+	      bfd_set_error (bfd_error_bad_value);
+	    error_ret_free_internal:
+	      if (elf_section_data (section)->relocs == NULL)
+		free (internal_relocs);
+	      goto error_ret_free_local;
+	    }
+
+	  hash = NULL;
+	  if (r_indx >= symtab_hdr->sh_info)
+	    hash = elf32_arm_hash_entry
+	      (elf_sym_hashes (input_bfd)
+	       [r_indx - symtab_hdr->sh_info]);
+
+	  /* Only look for stubs on branch instructions, or
+	     non-relaxed TLSCALL  */
+	  if ((r_type != (unsigned int) R_ARM_CALL)
+	      && (r_type != (unsigned int) R_ARM_THM_CALL)
+	      && (r_type != (unsigned int) R_ARM_JUMP24)
+	      && (r_type != (unsigned int) R_ARM_THM_JUMP19)
+	      && (r_type != (unsigned int) R_ARM_THM_XPC22)
+	      && (r_type != (unsigned int) R_ARM_THM_JUMP24)
+	      && (r_type != (unsigned int) R_ARM_PLT32)
+	      && !((r_type == (unsigned int) R_ARM_TLS_CALL
+		    || r_type == (unsigned int) R_ARM_THM_TLS_CALL)
+		   && r_type == (elf32_arm_tls_transition
+				 (info, r_type,
+				  (struct elf_link_hash_entry *) hash))
+		   && ((hash ? hash->tls_type
+			: (elf32_arm_local_got_tls_type
+			   (input_bfd)[r_indx]))
+		       & GOT_TLS_GDESC) != 0))
+	    continue;
+
+	  /* Now determine the call target, its name, value,
+	     section.  */
+	  sym_sec = NULL;
+	  sym_value = 0;
+	  dest_sec = NULL;
+	  dest_value = 0;
+	  sym_name = NULL;
+
+	  if (r_type == (unsigned int) R_ARM_TLS_CALL
+	      || r_type == (unsigned int) R_ARM_THM_TLS_CALL)
+	    {
+	      /* A non-relaxed TLS call.  The target is the
+		 plt-resident trampoline and nothing to do
+		 with the symbol.  */
+	      BFD_ASSERT (htab->tls_trampoline > 0);
+	      sym_sec = htab->root.splt;
+	      sym_value = htab->tls_trampoline;
+	      hash = 0;
+	      st_type = STT_FUNC;
+	      branch_type = ST_BRANCH_TO_ARM;
+	    }
+	  else if (!hash)
+	    {
+	      /* It's a local symbol.  */
+	      Elf_Internal_Sym *sym;
+
+	      if (local_syms == NULL)
+		{
+		  local_syms
+		    = (Elf_Internal_Sym *) symtab_hdr->contents;
+		  if (local_syms == NULL)
+		    local_syms
+		      = bfd_elf_get_elf_syms (input_bfd, symtab_hdr,
+					      symtab_hdr->sh_info, 0,
+					      NULL, NULL, NULL);
+		  if (local_syms == NULL)
+		    goto error_ret_free_internal;
+		}
+
+	      sym = local_syms + r_indx;
+	      if (sym->st_shndx == SHN_UNDEF)
+		sym_sec = bfd_und_section_ptr;
+	      else if (sym->st_shndx == SHN_ABS)
+		sym_sec = bfd_abs_section_ptr;
+	      else if (sym->st_shndx == SHN_COMMON)
+		sym_sec = bfd_com_section_ptr;
+	      else
+		sym_sec =
+		  bfd_section_from_elf_index (input_bfd, sym->st_shndx);
+
+	      if (!sym_sec)
+		/* This is an undefined symbol.  It can never
+		   be resolved.  */
+		continue;
+
+	      if (ELF_ST_TYPE (sym->st_info) != STT_SECTION)
+		sym_value = sym->st_value;
+	      dest_sec = sym_sec;
+	      dest_value = sym_value + irela->r_addend;
+	      st_type = ELF_ST_TYPE (sym->st_info);
+	      branch_type =
+		ARM_GET_SYM_BRANCH_TYPE (sym->st_target_internal);
+	      sym_name
+		= bfd_elf_string_from_elf_section (input_bfd,
+						   symtab_hdr->sh_link,
+						   sym->st_name);
+	    }
+	  else
+	    {
+	      /* It's an external symbol.  */
+	      while (hash->root.root.type == bfd_link_hash_indirect
+		     || hash->root.root.type == bfd_link_hash_warning)
+		hash = ((struct elf32_arm_link_hash_entry *)
+			hash->root.root.u.i.link);
+
+	      if (hash->root.root.type == bfd_link_hash_defined
+		  || hash->root.root.type == bfd_link_hash_defweak)
+		{
+		  sym_sec = hash->root.root.u.def.section;
+		  sym_value = hash->root.root.u.def.value;
+
+		  /* For a destination in a shared library,
+		     use the PLT stub as target address to
+		     decide whether a branch stub is
+		     needed.  */
+		  if (htab->root.splt != NULL
+		      && hash->root.plt.offset != (bfd_vma) -1)
+		    {
+		      sym_sec = htab->root.splt;
+		      sym_value = hash->root.plt.offset;
+		      if (sym_sec->output_section != NULL)
+			{
+			  dest_sec = sym_sec;
+			  dest_value = sym_value;
+			}
+		    }
+		  else if (sym_sec->output_section != NULL)
+		    {
+		      dest_sec = sym_sec;
+		      dest_value = sym_value + irela->r_addend;
+		    }
+		}
+	      else if ((hash->root.root.type == bfd_link_hash_undefined)
+		       || (hash->root.root.type == bfd_link_hash_undefweak))
+		{
+		  /* For a shared library, use the PLT stub as
+		     target address to decide whether a long
+		     branch stub is needed.
+		     For absolute code, they cannot be handled.  */
+		  if (htab->root.splt != NULL
+		      && hash->root.plt.offset != (bfd_vma) -1)
+		    {
+		      sym_sec = htab->root.splt;
+		      sym_value = hash->root.plt.offset;
+		      if (sym_sec->output_section != NULL)
+			{
+			  dest_sec = sym_sec;
+			  dest_value = sym_value;
+			}
+		    }
+		  else
+		    continue;
+		}
+	      else
+		{
+		  bfd_set_error (bfd_error_bad_value);
+		  goto error_ret_free_internal;
+		}
+	      st_type = hash->root.type;
+	      branch_type =
+		ARM_GET_SYM_BRANCH_TYPE (hash->root.target_internal);
+	      sym_name = hash->root.root.root.string;
+	    }
+
+	  if (*count == *alloc)
+	    {
+	      *alloc = *alloc ? *alloc * 2 : 64;
+	      site = (struct arm_branch_site *)
+		bfd_realloc (*sites, sizeof (**sites) * *alloc);
+	      if (site == NULL)
+		goto error_ret_free_internal;
+	      *sites = site;
+	    }
+
+	  site = *sites + (*count)++;
+	  site->input_bfd = input_bfd;
+	  site->section = section;
+	  site->rel = *irela;
+	  site->hash = hash;
+	  site->sym_name = sym_name;
+	  site->sym_sec = sym_sec;
+	  site->sym_value = sym_value;
+	  site->st_type = st_type;
+	  site->sym_branch_type = branch_type;
+	  site->dest_sec = dest_sec;
+	  site->dest_value = dest_value;
+	  site->checked = false;
+	  site->location = 0;
+	  site->destination = 0;
+	  site->branch_type = branch_type;
+	  site->has_stub = false;
+	}
+
+      /* We're done with the internal relocs, free them.  */
+      if (elf_section_data (section)->relocs == NULL)
+	free (internal_relocs);
+    }
+
+  ret = true;
+
+ error_ret_free_local:
+  if (local_syms != NULL
+      && symtab_hdr->contents != (unsigned char *) local_syms)
+    {
+      if (!ret || !info->keep_memory)
+	free (local_syms);
+      else
+	symtab_hdr->contents = (unsigned char *) local_syms;
+    }
+  return ret;
+}
+
+/* Return the output address of the PLT section SPLT, or zero if there
+   is none.  */
+
+static bfd_vma
+elf32_arm_plt_address (asection *splt)
+{
+  if (splt == NULL || splt->output_section == NULL)
+    return 0;
+  return splt->output_section->vma + splt->output_offset;
+}
+
 /* Determine and set the size of the stub section for a final link.
 
    The basic idea here is to examine all the relocations looking for
@@ -6437,6 +6761,9 @@ elf32_arm_size_stubs (bfd *output_bfd,
   unsigned int num_a8_fixes = 0, a8_fix_table_size = 10;
   struct a8_erratum_reloc *a8_relocs = NULL;
   unsigned int num_a8_relocs = 0, a8_reloc_table_size = 10, i;
+  struct arm_branch_site *sites = NULL;
+  unsigned int num_sites = 0, sites_alloc = 0;
+  bfd_vma splt_addr = 0, iplt_addr = 0;
 
   if (htab == NULL)
     return false;
@@ -6508,6 +6835,15 @@ elf32_arm_size_stubs (bfd *output_bfd,
       enum elf32_arm_stub_type stub_type;
       bool stub_changed = false;
       unsigned prev_num_a8_fixes = num_a8_fixes;
+      unsigned int site_indx = 0;
+      bool plt_moved;
+
+      /* Branches through the PLT are checked against its address
+	 rather than their recorded destination.  */
+      plt_moved = (splt_addr != elf32_arm_plt_address (htab->root.splt)
+		   || iplt_addr != elf32_arm_plt_address (htab->root.iplt));
+      splt_addr = elf32_arm_plt_address (htab->root.splt);
+      iplt_addr = elf32_arm_plt_address (htab->root.iplt);
 
       num_a8_fixes = 0;
       for (input_bfd = info->input_bfds, bfd_indx = 0;
@@ -6515,8 +6851,6 @@ elf32_arm_size_stubs (bfd *output_bfd,
 	   input_bfd = input_bfd->link.next, bfd_indx++)
 	{
 	  Elf_Internal_Shdr *symtab_hdr;
-	  asection *section;
-	  Elf_Internal_Sym *local_syms = NULL;
 
 	  if (!is_arm_elf (input_bfd))
 	    continue;
@@ -6525,8 +6859,6 @@ elf32_arm_size_stubs (bfd *output_bfd,
 		  || (elf_dyn_lib_class (input_bfd) & DYN_AS_NEEDED) != 0))
 	    continue;
 
-	  num_a8_relocs = 0;
-
 	  /* We'll need the symbol table in a second.  */
 	  symtab_hdr = &elf_tdata (input_bfd)->symtab_hdr;
 	  if (symtab_hdr->sh_info == 0)
@@ -6541,312 +6873,111 @@ elf32_arm_size_stubs (bfd *output_bfd,
 	      sym_hashes = elf_sym_hashes (input_bfd);
 	      if (!cmse_scan (input_bfd, htab, out_attr, sym_hashes,
 			      &cmse_stub_created))
-		goto error_ret_free_local;
+		goto error_ret_free;
 
 	      if (cmse_stub_created != 0)
 		stub_changed = true;
 	    }
 
-	  /* Walk over each section attached to the input bfd.  */
-	  for (section = input_bfd->sections;
-	       section != NULL;
-	       section = section->next)
-	    {
-	      Elf_Internal_Rela *internal_relocs, *irelaend, *irela;
-
-	      /* If there aren't any relocs, then there's nothing more
-		 to do.  */
-	      if ((section->flags & SEC_RELOC) == 0
-		  || section->reloc_count == 0
-		  || (section->flags & SEC_CODE) == 0)
-		continue;
-
-	      /* If this section is a link-once section that will be
-		 discarded, then don't create any stubs.  */
-	      if (section->output_section == NULL
-		  || section->output_section->owner != output_bfd)
-		continue;
+	  if (first_veneer_scan
+	      && !elf32_arm_find_branch_sites (output_bfd, info, input_bfd,
+					       &sites, &num_sites,
+					       &sites_alloc))
+	    goto error_ret_free;
 
-	      /* Get the relocs.  */
-	      internal_relocs
-		= _bfd_elf_link_read_relocs (input_bfd, section, NULL,
-					     NULL, info->keep_memory);
-	      if (internal_relocs == NULL)
-		goto error_ret_free_local;
-
-	      /* Now examine each relocation.  */
-	      irela = internal_relocs;
-	      irelaend = irela + section->reloc_count;
-	      for (; irela < irelaend; irela++)
+	  num_a8_relocs = 0;
+	  for (; site_indx < num_sites
+		 && sites[site_indx].input_bfd == input_bfd; site_indx++)
+	    {
+	      struct arm_branch_site *site = &sites[site_indx];
+	      asection *section = site->section;
+	      unsigned int r_type = ELF32_R_TYPE (site->rel.r_info);
+	      bfd_vma from, destination;
+
+	      from = (section->output_section->vma
+		      + section->output_offset
+		      + site->rel.r_offset);
+	      destination = site->dest_value;
+	      if (site->dest_sec != NULL)
+		destination += (site->dest_sec->output_offset
+				+ site->dest_sec->output_section->vma);
+
+	      /* Unless the branch, its destination or the PLT moved, the
+		 answer is the same as last time round.  */
+	      if (!site->checked
+		  || plt_moved
+		  || site->location != from
+		  || site->destination != destination)
 		{
-		  unsigned int r_type, r_indx;
-		  asection *sym_sec;
-		  bfd_vma sym_value;
-		  bfd_vma destination;
-		  struct elf32_arm_link_hash_entry *hash;
-		  const char *sym_name;
-		  unsigned char st_type;
-		  enum arm_st_branch_type branch_type;
-		  bool created_stub = false;
-
-		  r_type = ELF32_R_TYPE (irela->r_info);
-		  r_indx = ELF32_R_SYM (irela->r_info);
-
-		  if (r_type >= (unsigned int) R_ARM_max)
-		    {
-		      bfd_set_error (bfd_error_bad_value);
-		    error_ret_free_internal:
-		      if (elf_section_data (section)->relocs == NULL)
-			free (internal_relocs);
-		    /* Fall through.  */
-		    error_ret_free_local:
-		      if (symtab_hdr->contents != (unsigned char *) local_syms)
-			free (local_syms);
-		      return false;
-		    }
-
-		  hash = NULL;
-		  if (r_indx >= symtab_hdr->sh_info)
-		    hash = elf32_arm_hash_entry
-		      (elf_sym_hashes (input_bfd)
-		       [r_indx - symtab_hdr->sh_info]);
-
-		  /* Only look for stubs on branch instructions, or
-		     non-relaxed TLSCALL  */
-		  if ((r_type != (unsigned int) R_ARM_CALL)
-		      && (r_type != (unsigned int) R_ARM_THM_CALL)
-		      && (r_type != (unsigned int) R_ARM_JUMP24)
-		      && (r_type != (unsigned int) R_ARM_THM_JUMP19)
-		      && (r_type != (unsigned int) R_ARM_THM_XPC22)
-		      && (r_type != (unsigned int) R_ARM_THM_JUMP24)
-		      && (r_type != (unsigned int) R_ARM_PLT32)
-		      && !((r_type == (unsigned int) R_ARM_TLS_CALL
-			    || r_type == (unsigned int) R_ARM_THM_TLS_CALL)
-			   && r_type == (elf32_arm_tls_transition
-					 (info, r_type,
-					  (struct elf_link_hash_entry *) hash))
-			   && ((hash ? hash->tls_type
-				: (elf32_arm_local_got_tls_type
-				   (input_bfd)[r_indx]))
-			       & GOT_TLS_GDESC) != 0))
-		    continue;
-
-		  /* Now determine the call target, its name, value,
-		     section.  */
-		  sym_sec = NULL;
-		  sym_value = 0;
-		  destination = 0;
-		  sym_name = NULL;
-
-		  if (r_type == (unsigned int) R_ARM_TLS_CALL
-		      || r_type == (unsigned int) R_ARM_THM_TLS_CALL)
-		    {
-		      /* A non-relaxed TLS call.  The target is the
-			 plt-resident trampoline and nothing to do
-			 with the symbol.  */
-		      BFD_ASSERT (htab->tls_trampoline > 0);
-		      sym_sec = htab->root.splt;
-		      sym_value = htab->tls_trampoline;
-		      hash = 0;
-		      st_type = STT_FUNC;
-		      branch_type = ST_BRANCH_TO_ARM;
-		    }
-		  else if (!hash)
-		    {
-		      /* It's a local symbol.  */
-		      Elf_Internal_Sym *sym;
-
-		      if (local_syms == NULL)
-			{
-			  local_syms
-			    = (Elf_Internal_Sym *) symtab_hdr->contents;
-			  if (local_syms == NULL)
-			    local_syms
-			      = bfd_elf_get_elf_syms (input_bfd, symtab_hdr,
-						      symtab_hdr->sh_info, 0,
-						      NULL, NULL, NULL);
-			  if (local_syms == NULL)
-			    goto error_ret_free_internal;
-			}
-
-		      sym = local_syms + r_indx;
-		      if (sym->st_shndx == SHN_UNDEF)
-			sym_sec = bfd_und_section_ptr;
-		      else if (sym->st_shndx == SHN_ABS)
-			sym_sec = bfd_abs_section_ptr;
-		      else if (sym->st_shndx == SHN_COMMON)
-			sym_sec = bfd_com_section_ptr;
-		      else
-			sym_sec =
-			  bfd_section_from_elf_index (input_bfd, sym->st_shndx);
-
-		      if (!sym_sec)
-			/* This is an undefined symbol.  It can never
-			   be resolved.  */
-			continue;
-
-		      if (ELF_ST_TYPE (sym->st_info) != STT_SECTION)
-			sym_value = sym->st_value;
-		      destination = (sym_value + irela->r_addend
-				     + sym_sec->output_offset
-				     + sym_sec->output_section->vma);
-		      st_type = ELF_ST_TYPE (sym->st_info);
-		      branch_type =
-			ARM_GET_SYM_BRANCH_TYPE (sym->st_target_internal);
-		      sym_name
-			= bfd_elf_string_from_elf_section (input_bfd,
-							   symtab_hdr->sh_link,
-							   sym->st_name);
-		    }
-		  else
-		    {
-		      /* It's an external symbol.  */
-		      while (hash->root.root.type == bfd_link_hash_indirect
-			     || hash->root.root.type == bfd_link_hash_warning)
-			hash = ((struct elf32_arm_link_hash_entry *)
-				hash->root.root.u.i.link);
-
-		      if (hash->root.root.type == bfd_link_hash_defined
-			  || hash->root.root.type == bfd_link_hash_defweak)
-			{
-			  sym_sec = hash->root.root.u.def.section;
-			  sym_value = hash->root.root.u.def.value;
-
-			  struct elf32_arm_link_hash_table *globals =
-						  elf32_arm_hash_table (info);
-
-			  /* For a destination in a shared library,
-			     use the PLT stub as target address to
-			     decide whether a branch stub is
-			     needed.  */
-			  if (globals != NULL
-			      && globals->root.splt != NULL
-			      && hash != NULL
-			      && hash->root.plt.offset != (bfd_vma) -1)
-			    {
-			      sym_sec = globals->root.splt;
-			      sym_value = hash->root.plt.offset;
-			      if (sym_sec->output_section != NULL)
-				destination = (sym_value
-					       + sym_sec->output_offset
-					       + sym_sec->output_section->vma);
-			    }
-			  else if (sym_sec->output_section != NULL)
-			    destination = (sym_value + irela->r_addend
-					   + sym_sec->output_offset
-					   + sym_sec->output_section->vma);
-			}
-		      else if ((hash->root.root.type == bfd_link_hash_undefined)
-			       || (hash->root.root.type == bfd_link_hash_undefweak))
-			{
-			  /* For a shared library, use the PLT stub as
-			     target address to decide whether a long
-			     branch stub is needed.
-			     For absolute code, they cannot be handled.  */
-			  struct elf32_arm_link_hash_table *globals =
-			    elf32_arm_hash_table (info);
-
-			  if (globals != NULL
-			      && globals->root.splt != NULL
-			      && hash != NULL
-			      && hash->root.plt.offset != (bfd_vma) -1)
-			    {
-			      sym_sec = globals->root.splt;
-			      sym_value = hash->root.plt.offset;
-			      if (sym_sec->output_section != NULL)
-				destination = (sym_value
-					       + sym_sec->output_offset
-					       + sym_sec->output_section->vma);
-			    }
-			  else
-			    continue;
-			}
-		      else
-			{
-			  bfd_set_error (bfd_error_bad_value);
-			  goto error_ret_free_internal;
-			}
-		      st_type = hash->root.type;
-		      branch_type =
-			ARM_GET_SYM_BRANCH_TYPE (hash->root.target_internal);
-		      sym_name = hash->root.root.root.string;
-		    }
-
-		  do
+		  site->checked = true;
+		  site->location = from;
+		  site->destination = destination;
+		  site->branch_type = site->sym_branch_type;
+		  site->has_stub = false;
+
+		  /* Determine what (if any) linker stub is needed.  */
+		  stub_type = arm_type_of_stub (info, section, &site->rel,
+						site->st_type,
+						&site->branch_type,
+						site->hash, destination,
+						site->sym_sec, input_bfd,
+						site->sym_name);
+		  if (stub_type != arm_stub_none)
 		    {
 		      bool new_stub;
 		      struct elf32_arm_stub_hash_entry *stub_entry;
 
-		      /* Determine what (if any) linker stub is needed.  */
-		      stub_type = arm_type_of_stub (info, section, irela,
-						    st_type, &branch_type,
-						    hash, destination, sym_sec,
-						    input_bfd, sym_name);
-		      if (stub_type == arm_stub_none)
-			break;
-
-		      /* We've either created a stub for this reloc already,
-			 or we are about to.  */
+		      /* We've either created a stub for this reloc
+			 already, or we are about to.  */
 		      stub_entry =
-			elf32_arm_create_stub (htab, stub_type, section, irela,
-					       sym_sec, hash,
-					       (char *) sym_name, sym_value,
-					       branch_type, &new_stub);
-
-		      created_stub = stub_entry != NULL;
-		      if (!created_stub)
-			goto error_ret_free_internal;
-		      else if (!new_stub)
-			break;
-		      else
+			elf32_arm_create_stub (htab, stub_type, section,
+					       &site->rel, site->sym_sec,
+					       site->hash,
+					       (char *) site->sym_name,
+					       site->sym_value,
+					       site->branch_type, &new_stub);
+		      if (stub_entry == NULL)
+			goto error_ret_free;
+
+		      site->has_stub = true;
+		      if (new_stub)
 			stub_changed = true;
 		    }
-		  while (0);
-
-		  /* Look for relocations which might trigger Cortex-A8
-		     erratum.  */
-		  if (htab->fix_cortex_a8
-		      && (r_type == (unsigned int) R_ARM_THM_JUMP24
-			  || r_type == (unsigned int) R_ARM_THM_JUMP19
-			  || r_type == (unsigned int) R_ARM_THM_CALL
-			  || r_type == (unsigned int) R_ARM_THM_XPC22))
-		    {
-		      bfd_vma from = section->output_section->vma
-				     + section->output_offset
-				     + irela->r_offset;
+		}
 
-		      if ((from & 0xfff) == 0xffe)
-			{
-			  /* Found a candidate.  Note we haven't checked the
-			     destination is within 4K here: if we do so (and
-			     don't create an entry in a8_relocs) we can't tell
-			     that a branch should have been relocated when
-			     scanning later.  */
-			  if (num_a8_relocs == a8_reloc_table_size)
-			    {
-			      a8_reloc_table_size *= 2;
-			      a8_relocs = (struct a8_erratum_reloc *)
-				  bfd_realloc (a8_relocs,
-					       sizeof (struct a8_erratum_reloc)
-					       * a8_reloc_table_size);
-			    }
+	      /* Look for relocations which might trigger Cortex-A8
+		 erratum.  */
+	      if (htab->fix_cortex_a8
+		  && (r_type == (unsigned int) R_ARM_THM_JUMP24
+		      || r_type == (unsigned int) R_ARM_THM_JUMP19
+		      || r_type == (unsigned int) R_ARM_THM_CALL
+		      || r_type == (unsigned int) R_ARM_THM_XPC22)
+		  && (from & 0xfff) == 0xffe)
+		{
+		  /* Found a candidate.  Note we haven't checked the
+		     destination is within 4K here: if we do so (and
+		     don't create an entry in a8_relocs) we can't tell
+		     that a branch should have been relocated when
+		     scanning later.  */
+		  if (num_a8_relocs == a8_reloc_table_size)
+		    {
+		      a8_reloc_table_size *= 2;
+		      a8_relocs = (struct a8_erratum_reloc *)
+			  bfd_realloc (a8_relocs,
+				       sizeof (struct a8_erratum_reloc)
+				       * a8_reloc_table_size);
+		    }
 
-			  a8_relocs[num_a8_relocs].from = from;
-			  a8_relocs[num_a8_relocs].destination = destination;
-			  a8_relocs[num_a8_relocs].r_type = r_type;
-			  a8_relocs[num_a8_relocs].branch_type = branch_type;
-			  a8_relocs[num_a8_relocs].sym_name = sym_name;
-			  a8_relocs[num_a8_relocs].non_a8_stub = created_stub;
-			  a8_relocs[num_a8_relocs].hash = hash;
+		  a8_relocs[num_a8_relocs].from = from;
+		  a8_relocs[num_a8_relocs].destination = destination;
+		  a8_relocs[num_a8_relocs].r_type = r_type;
+		  a8_relocs[num_a8_relocs].branch_type = site->branch_type;
+		  a8_relocs[num_a8_relocs].sym_name = site->sym_name;
+		  a8_relocs[num_a8_relocs].non_a8_stub = site->has_stub;
+		  a8_relocs[num_a8_relocs].hash = site->hash;
 
-			  num_a8_relocs++;
-			}
-		    }
+		  num_a8_relocs++;
 		}
-
-	      /* We're done with the internal relocs, free them.  */
-	      if (elf_section_data (section)->relocs == NULL)
-		free (internal_relocs);
 	    }
 
 	  if (htab->fix_cortex_a8)
@@ -6862,16 +6993,7 @@ elf32_arm_size_stubs (bfd *output_bfd,
 					  a8_relocs, num_a8_relocs,
 					  prev_num_a8_fixes, &stub_changed)
 		  != 0)
-		goto error_ret_free_local;
-	    }
-
-	  if (local_syms != NULL
-	      && symtab_hdr->contents != (unsigned char *) local_syms)
-	    {
-	      if (!info->keep_memory)
-		free (local_syms);
-	      else
-		symtab_hdr->contents = (unsigned char *) local_syms;
+		goto error_ret_free;
 	    }
 	}
 
@@ -6947,7 +7069,7 @@ elf32_arm_size_stubs (bfd *output_bfd,
 			 a8_fixes[i].section, htab, a8_fixes[i].stub_type);
 
 	    if (stub_sec == NULL)
-	      return false;
+	      goto error_ret_free;
 
 	    stub_sec->size
 	      += find_stub_size_and_template (a8_fixes[i].stub_type, NULL,
@@ -6960,6 +7082,8 @@ elf32_arm_size_stubs (bfd *output_bfd,
       first_veneer_scan = false;
     }
 
+  free (sites);
+
   /* Add stubs for Cortex-A8 erratum fixes now.  */
   if (htab->fix_cortex_a8)
     {
@@ -7013,6 +7137,10 @@ elf32_arm_size_stubs (bfd *output_bfd,
       htab->num_a8_erratum_fixes = 0;
     }
   return ret;
+
+ error_ret_free:
+  free (sites);
+  return false;
 }
 
 /* Build all the stubs associated with the current output file.  The
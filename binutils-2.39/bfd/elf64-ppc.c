@@ -3243,6 +3243,12 @@ struct ppc_link_hash_table
       /* A temp section list pointer.  */
       asection *list;
     } u;
+
+    /* Used by ppc64_elf_size_stubs to remember which branches in a
+       code section did not need a stub, and the section address at
+       the time.  */
+    struct ppc_branch_check *branch_check;
+    bfd_vma branch_sec_addr;
   } *sec_info;
 
   /* Linked list of groups.  */
@@ -3522,6 +3528,32 @@ tocsave_htab_eq (const void *p1, const void *p2)
   return e1->sec == e2->sec && e1->offset == e2->offset;
 }
 
+/* A branch that did not need a stub when its destination, somewhere
+   in DEST_SEC, was at DEST_ADDR.  Its location is known not to have
+   changed since then if its section hasn't moved.  */
+
+struct ppc_branch_check
+{
+  asection *dest_sec;
+  bfd_vma dest_addr;
+};
+
+/* Free the branch checks made by ppc64_elf_size_stubs.  */
+
+static void
+free_branch_checks (struct ppc_link_hash_table *htab)
+{
+  unsigned int id;
+
+  if (htab->sec_info == NULL)
+    return;
+  for (id = 0; id < htab->sec_info_arr_size; id++)
+    {
+      free (htab->sec_info[id].branch_check);
+      htab->sec_info[id].branch_check = NULL;
+    }
+}
+
 /* Destroy a ppc64 ELF linker hash table.  */
 
 static void
@@ -3532,6 +3564,7 @@ ppc64_elf_link_hash_table_free (bfd *obfd)
   htab = (struct ppc_link_hash_table *) obfd->link.hash;
   if (htab->tocsave_htab)
     htab_delete (htab->tocsave_htab);
+  free_branch_checks (htab);
   bfd_hash_table_free (&htab->branch_hash_table);
   bfd_hash_table_free (&htab->stub_hash_table);
   _bfd_elf_link_hash_table_free (obfd);
@@ -13665,6 +13698,32 @@ got_and_plt_relr (struct elf_link_hash_entry *h, void *inf)
   return true;
 }
 
+/* Return the array with one struct ppc_branch_check per reloc of
+   SECTION, discarding what it says if SECTION has moved since the last
+   call.  */
+
+static struct ppc_branch_check *
+get_branch_checks (struct ppc_link_hash_table *htab, asection *section)
+{
+  bfd_vma sec_addr = section->output_section->vma + section->output_offset;
+  struct ppc_branch_check *checks;
+  size_t amt;
+
+  amt = section->reloc_count * sizeof (*checks);
+  checks = htab->sec_info[section->id].branch_check;
+  if (checks == NULL)
+    {
+      checks = bfd_zmalloc (amt);
+      if (checks == NULL)
+	return NULL;
+      htab->sec_info[section->id].branch_check = checks;
+    }
+  else if (htab->sec_info[section->id].branch_sec_addr != sec_addr)
+    memset (checks, 0, amt);
+  htab->sec_info[section->id].branch_sec_addr = sec_addr;
+  return checks;
+}
+
 /* Determine and set the size of the stub section for a final link.
 
    The basic idea here is to examine all the relocations looking for
@@ -13805,6 +13864,7 @@ ppc64_elf_size_stubs (struct bfd_link_info *info)
 	       section = section->next)
 	    {
 	      Elf_Internal_Rela *internal_relocs, *irelaend, *irela;
+	      struct ppc_branch_check *checks;
 	      bool is_opd;
 
 	      /* If there aren't any relocs, then there's nothing more
@@ -13834,6 +13894,15 @@ ppc64_elf_size_stubs (struct bfd_link_info *info)
 
 	      is_opd = ppc64_elf_section_data (section)->sec_type == sec_opd;
 
+	      checks = NULL;
+	      if ((section->flags & SEC_CODE) != 0
+		  && section->id < htab->sec_info_arr_size)
+		{
+		  checks = get_branch_checks (htab, section);
+		  if (checks == NULL)
+		    goto error_ret_free_internal;
+		}
+
 	      /* Now examine each relocation.  */
 	      irela = internal_relocs;
 	      irelaend = irela + section->reloc_count;
@@ -13856,6 +13925,7 @@ ppc64_elf_size_stubs (struct bfd_link_info *info)
 		  const asection *id_sec;
 		  struct _opd_sec_data *opd;
 		  struct plt_entry *plt_ent;
+		  struct ppc_branch_check *check = NULL;
 
 		  r_type = ELF64_R_TYPE (irela->r_info);
 		  r_indx = ELF64_R_SYM (irela->r_info);
@@ -13878,9 +13948,21 @@ ppc64_elf_size_stubs (struct bfd_link_info *info)
 		    case R_PPC64_REL14:
 		    case R_PPC64_REL14_BRTAKEN:
 		    case R_PPC64_REL14_BRNTAKEN:
-		      if ((section->flags & SEC_CODE) != 0)
-			break;
-		      continue;
+		      if ((section->flags & SEC_CODE) == 0)
+			continue;
+		      if (checks != NULL)
+			{
+			  /* A branch that didn't need a stub last time
+			     still doesn't if neither end has moved.  */
+			  check = checks + (irela - internal_relocs);
+			  if (check->dest_sec != NULL
+			      && (check->dest_addr
+				  == (check->dest_sec->output_section->vma
+				      + check->dest_sec->output_offset)))
+			    continue;
+			  check->dest_sec = NULL;
+			}
+		      break;
 
 		    case R_PPC64_ADDR64:
 		    case R_PPC64_TOC:
@@ -14083,7 +14165,21 @@ ppc64_elf_size_stubs (struct bfd_link_info *info)
 		    }
 
 		  if (stub_type.main == ppc_stub_none)
-		    continue;
+		    {
+		      /* Destinations found via opd entries are not
+			 simply an offset into SYM_SEC.  */
+		      if (check != NULL && opd == NULL)
+			{
+			  asection *dest_sec = bfd_abs_section_ptr;
+
+			  if (ok_dest)
+			    dest_sec = sym_sec;
+			  check->dest_sec = dest_sec;
+			  check->dest_addr = (dest_sec->output_section->vma
+					      + dest_sec->output_offset);
+			}
+		      continue;
+		    }
 
 		  /* __tls_get_addr calls might be eliminated.  */
 		  if (stub_type.main != ppc_stub_plt_call
@@ -14368,6 +14464,8 @@ ppc64_elf_size_stubs (struct bfd_link_info *info)
       (*htab->params->layout_sections_again) ();
     }
 
+  free_branch_checks (htab);
+
   if (htab->glink_eh_frame != NULL
       && htab->glink_eh_frame->size != 0)
     {
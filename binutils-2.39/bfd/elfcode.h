@@ -72,6 +72,9 @@
 #include "libbfd.h"
 #include "elf-bfd.h"
 #include "libiberty.h"
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 /* Renaming structures, typedefs, macros and functions to be size-specific.  */
 #define Elf_External_Ehdr	NAME(Elf,External_Ehdr)
@@ -106,6 +109,8 @@
 #define elf_canonicalize_reloc		NAME(bfd_elf,canonicalize_reloc)
 #define elf_slurp_symbol_table		NAME(bfd_elf,slurp_symbol_table)
 #define elf_canonicalize_symtab		NAME(bfd_elf,canonicalize_symtab)
+#define elf_read_minisymbols		NAME(bfd_elf,read_minisymbols)
+#define elf_minisymbol_to_symbol	NAME(bfd_elf,minisymbol_to_symbol)
 #define elf_canonicalize_dynamic_symtab \
   NAME(bfd_elf,canonicalize_dynamic_symtab)
 #define elf_get_synthetic_symtab \
@@ -1181,6 +1186,134 @@ elf_checksum_contents (bfd *abfd,
   return true;
 }
 
+/* Fill in SYM, which must be zeroed, from ISYM, a symbol read from the
+   symbol table HDR.  DYNAMIC is TRUE for the dynamic symbol table.  */
+
+static bool
+elf_translate_symbol (bfd *abfd, Elf_Internal_Shdr *hdr,
+		      Elf_Internal_Sym *isym, elf_symbol_type *sym,
+		      bool dynamic)
+{
+  memcpy (&sym->internal_elf_sym, isym, sizeof (Elf_Internal_Sym));
+
+  sym->symbol.the_bfd = abfd;
+  sym->symbol.name = bfd_elf_sym_name (abfd, hdr, isym, NULL);
+  sym->symbol.value = isym->st_value;
+
+  if (isym->st_shndx == SHN_UNDEF)
+    {
+      sym->symbol.section = bfd_und_section_ptr;
+    }
+  else if (isym->st_shndx == SHN_ABS)
+    {
+      sym->symbol.section = bfd_abs_section_ptr;
+    }
+  else if (isym->st_shndx == SHN_COMMON)
+    {
+      sym->symbol.section = bfd_com_section_ptr;
+      if ((abfd->flags & BFD_PLUGIN) != 0)
+	{
+	  asection *xc = bfd_get_section_by_name (abfd, "COMMON");
+
+	  if (xc == NULL)
+	    {
+	      flagword flags = (SEC_ALLOC | SEC_IS_COMMON | SEC_KEEP
+				| SEC_EXCLUDE);
+	      xc = bfd_make_section_with_flags (abfd, "COMMON", flags);
+	      if (xc == NULL)
+		return false;
+	    }
+	  sym->symbol.section = xc;
+	}
+      /* Elf puts the alignment into the `value' field, and
+	 the size into the `size' field.  BFD wants to see the
+	 size in the value field, and doesn't care (at the
+	 moment) about the alignment.  */
+      sym->symbol.value = isym->st_size;
+    }
+  else
+    {
+      sym->symbol.section
+	= bfd_section_from_elf_index (abfd, isym->st_shndx);
+      if (sym->symbol.section == NULL)
+	{
+	  /* This symbol is in a section for which we did not
+	     create a BFD section.  Just use bfd_abs_section,
+	     although it is wrong.  FIXME.  Note - there is
+	     code in elf.c:swap_out_syms that calls
+	     symbol_section_index() in the elf backend for
+	     cases like this.  */
+	  sym->symbol.section = bfd_abs_section_ptr;
+	}
+    }
+
+  /* If this is a relocatable file, then the symbol value is
+     already section relative.  */
+  if ((abfd->flags & (EXEC_P | DYNAMIC)) != 0)
+    sym->symbol.value -= sym->symbol.section->vma;
+
+  switch (ELF_ST_BIND (isym->st_info))
+    {
+    case STB_LOCAL:
+      sym->symbol.flags |= BSF_LOCAL;
+      break;
+    case STB_GLOBAL:
+      if (isym->st_shndx != SHN_UNDEF && isym->st_shndx != SHN_COMMON)
+	sym->symbol.flags |= BSF_GLOBAL;
+      break;
+    case STB_WEAK:
+      sym->symbol.flags |= BSF_WEAK;
+      break;
+    case STB_GNU_UNIQUE:
+      sym->symbol.flags |= BSF_GNU_UNIQUE;
+      break;
+    }
+
+  switch (ELF_ST_TYPE (isym->st_info))
+    {
+    case STT_SECTION:
+      /* Mark the input section symbol as used since it may be
+	 used for relocation and section group.
+	 NB: BSF_SECTION_SYM_USED is ignored by linker and may
+	 be cleared by objcopy for non-relocatable inputs.  */
+      sym->symbol.flags |= (BSF_SECTION_SYM
+			    | BSF_DEBUGGING
+			    | BSF_SECTION_SYM_USED);
+      break;
+    case STT_FILE:
+      sym->symbol.flags |= BSF_FILE | BSF_DEBUGGING;
+      break;
+    case STT_FUNC:
+      sym->symbol.flags |= BSF_FUNCTION;
+      break;
+    case STT_COMMON:
+      /* FIXME: Do we have to put the size field into the value field
+	 as we do with symbols in SHN_COMMON sections (see above) ?  */
+      sym->symbol.flags |= BSF_ELF_COMMON;
+      /* Fall through.  */
+    case STT_OBJECT:
+      sym->symbol.flags |= BSF_OBJECT;
+      break;
+    case STT_TLS:
+      sym->symbol.flags |= BSF_THREAD_LOCAL;
+      break;
+    case STT_RELC:
+      sym->symbol.flags |= BSF_RELC;
+      break;
+    case STT_SRELC:
+      sym->symbol.flags |= BSF_SRELC;
+      break;
+    case STT_GNU_IFUNC:
+      sym->symbol.flags |= BSF_GNU_INDIRECT_FUNCTION;
+      break;
+    }
+
+  if (dynamic)
+    sym->symbol.flags |= BSF_DYNAMIC;
+
+  return true;
+}
+
 long
 elf_slurp_symbol_table (bfd *abfd, asymbol **symptrs, bool dynamic)
 {
@@ -1283,122 +1416,8 @@ elf_slurp_symbol_table (bfd *abfd, asymbol **symptrs, bool dynamic)
       isymend = isymbuf + symcount;
       for (isym = isymbuf + 1, sym = symbase; isym < isymend; isym++, sym++)
 	{
-	  memcpy (&sym->internal_elf_sym, isym, sizeof (Elf_Internal_Sym));
-
-	  sym->symbol.the_bfd = abfd;
-	  sym->symbol.name = bfd_elf_sym_name (abfd, hdr, isym, NULL);
-	  sym->symbol.value = isym->st_value;
-
-	  if (isym->st_shndx == SHN_UNDEF)
-	    {
-	      sym->symbol.section = bfd_und_section_ptr;
-	    }
-	  else if (isym->st_shndx == SHN_ABS)
-	    {
-	      sym->symbol.section = bfd_abs_section_ptr;
-	    }
-	  else if (isym->st_shndx == SHN_COMMON)
-	    {
-	      sym->symbol.section = bfd_com_section_ptr;
-	      if ((abfd->flags & BFD_PLUGIN) != 0)
-		{
-		  asection *xc = bfd_get_section_by_name (abfd, "COMMON");
-
-		  if (xc == NULL)
-		    {
-		      flagword flags = (SEC_ALLOC | SEC_IS_COMMON | SEC_KEEP
-					| SEC_EXCLUDE);
-		      xc = bfd_make_section_with_flags (abfd, "COMMON", flags);
-		      if (xc == NULL)
-			goto error_return;
-		    }
-		  sym->symbol.section = xc;
-		}
-	      /* Elf puts the alignment into the `value' field, and
-		 the size into the `size' field.  BFD wants to see the
-		 size in the value field, and doesn't care (at the
-		 moment) about the alignment.  */
-	      sym->symbol.value = isym->st_size;
-	    }
-	  else
-	    {
-	      sym->symbol.section
-		= bfd_section_from_elf_index (abfd, isym->st_shndx);
-	      if (sym->symbol.section == NULL)
-		{
-		  /* This symbol is in a section for which we did not
-		     create a BFD section.  Just use bfd_abs_section,
-		     although it is wrong.  FIXME.  Note - there is
-		     code in elf.c:swap_out_syms that calls
-		     symbol_section_index() in the elf backend for
-		     cases like this.  */
-		  sym->symbol.section = bfd_abs_section_ptr;
-		}
-	    }
-
-	  /* If this is a relocatable file, then the symbol value is
-	     already section relative.  */
-	  if ((abfd->flags & (EXEC_P | DYNAMIC)) != 0)
-	    sym->symbol.value -= sym->symbol.section->vma;
-
-	  switch (ELF_ST_BIND (isym->st_info))
-	    {
-	    case STB_LOCAL:
-	      sym->symbol.flags |= BSF_LOCAL;
-	      break;
-	    case STB_GLOBAL:
-	      if (isym->st_shndx != SHN_UNDEF && isym->st_shndx != SHN_COMMON)
-		sym->symbol.flags |= BSF_GLOBAL;
-	      break;
-	    case STB_WEAK:
-	      sym->symbol.flags |= BSF_WEAK;
-	      break;
-	    case STB_GNU_UNIQUE:
-	      sym->symbol.flags |= BSF_GNU_UNIQUE;
-	      break;
-	    }
-
-	  switch (ELF_ST_TYPE (isym->st_info))
-	    {
-	    case STT_SECTION:
-	      /* Mark the input section symbol as used since it may be
-	         used for relocation and section group.
-		 NB: BSF_SECTION_SYM_USED is ignored by linker and may
-		 be cleared by objcopy for non-relocatable inputs.  */
-	      sym->symbol.flags |= (BSF_SECTION_SYM
-				    | BSF_DEBUGGING
-				    | BSF_SECTION_SYM_USED);
-	      break;
-	    case STT_FILE:
-	      sym->symbol.flags |= BSF_FILE | BSF_DEBUGGING;
-	      break;
-	    case STT_FUNC:
-	      sym->symbol.flags |= BSF_FUNCTION;
-	      break;
-	    case STT_COMMON:
-	      /* FIXME: Do we have to put the size field into the value field
-		 as we do with symbols in SHN_COMMON sections (see above) ?  */
-	      sym->symbol.flags |= BSF_ELF_COMMON;
-	      /* Fall through.  */
-	    case STT_OBJECT:
-	      sym->symbol.flags |= BSF_OBJECT;
-	      break;
-	    case STT_TLS:
-	      sym->symbol.flags |= BSF_THREAD_LOCAL;
-	      break;
-	    case STT_RELC:
-	      sym->symbol.flags |= BSF_RELC;
-	      break;
-	    case STT_SRELC:
-	      sym->symbol.flags |= BSF_SRELC;
-	      break;
-	    case STT_GNU_IFUNC:
-	      sym->symbol.flags |= BSF_GNU_INDIRECT_FUNCTION;
-	      break;
-	    }
-
-	  if (dynamic)
-	    sym->symbol.flags |= BSF_DYNAMIC;
+	  if (!elf_translate_symbol (abfd, hdr, isym, sym, dynamic))
+	    goto error_return;
 
 	  if (xver != NULL)
 	    {
@@ -1449,6 +1468,142 @@ elf_slurp_symbol_table (bfd *abfd, asymbol **symptrs, bool dynamic)
   return -1;
 }
 
+/* Symbol tables with fewer symbols than this are read in full even
+   for minisymbols; the memory saved would not be worth converting
+   symbols each time they are looked at.  */
+
+#define MINISYM_THRESHOLD (1000000 / sizeof (elf_symbol_type))
+
+/* Return TRUE if the minisymbols of ABFD are the external ELF symbols
+   themselves, rather than canonical BFD symbols.  Dynamic symbols need
+   version information, and some backends read or adjust the symbol
+   table as a whole, so those use canonical symbols, as do callers that
+   asked for them with BFD_CANONICAL_MINISYMS.  */
+
+static bool
+elf_external_minisymbols_p (bfd *abfd, bool dynamic)
+{
+  const struct elf_backend_data *ebd = get_elf_backend_data (abfd);
+
+  return (!dynamic
+	  && (abfd->flags & BFD_CANONICAL_MINISYMS) == 0
+	  && ebd->s->slurp_symbol_table == elf_slurp_symbol_table
+	  && ebd->elf_backend_symbol_table_processing == NULL
+	  && elf_symtab_shndx_list (abfd) == NULL
+	  && (elf_tdata (abfd)->symtab_hdr.sh_size / sizeof (Elf_External_Sym)
+	      >= MINISYM_THRESHOLD));
+}
+
+/* Return the external symbols of the symbol table of ABFD, which stay
+   in elf_tdata until ABFD is closed.  They are mapped from the file
+   where possible, and otherwise read into memory.  */
+
+static const Elf_External_Sym *
+elf_minisymbol_table (bfd *abfd)
+{
+  struct elf_obj_tdata *tdata = elf_tdata (abfd);
+  Elf_Internal_Shdr *hdr = &tdata->symtab_hdr;
+  bfd_size_type amt = hdr->sh_size;
+
+  if (tdata->minisym_table != NULL)
+    return (const Elf_External_Sym *) tdata->minisym_table;
+
+#ifdef HAVE_MMAP
+  if ((abfd->flags & BFD_IN_MEMORY) == 0
+      /* Accessing a mapping beyond the end of the file faults.  */
+      && hdr->sh_offset + amt <= bfd_get_file_size (abfd))
+    {
+      void *map_addr;
+      bfd_size_type map_len;
+      void *table;
+
+      table = bfd_mmap (abfd, NULL, amt, PROT_READ, MAP_PRIVATE,
+			hdr->sh_offset, &map_addr, &map_len);
+      if (table != (void *) -1)
+	{
+	  tdata->minisym_map_addr = map_addr;
+	  tdata->minisym_map_len = map_len;
+	  tdata->minisym_table = table;
+	  return (const Elf_External_Sym *) table;
+	}
+    }
+#endif
+
+  if (bfd_seek (abfd, hdr->sh_offset, SEEK_SET) != 0)
+    return NULL;
+  tdata->minisym_table = _bfd_malloc_and_read (abfd, amt, amt);
+  return (const Elf_External_Sym *) tdata->minisym_table;
+}
+
+/* Read the minisymbols of ABFD.  For a large symbol table these are
+   pointers to the external ELF symbols, which elf_minisymbol_table
+   maps from the file, and each is converted to a BFD symbol only when
+   elf_minisymbol_to_symbol is called on it.  Only the array of
+   pointers belongs to the caller.  */
+
+long
+elf_read_minisymbols (bfd *abfd,
+		      bool dynamic,
+		      void **minisymsp,
+		      unsigned int *sizep)
+{
+  Elf_Internal_Shdr *hdr = &elf_tdata (abfd)->symtab_hdr;
+  const Elf_External_Sym *table;
+  const Elf_External_Sym **syms;
+  bfd_size_type symcount, i;
+
+  if (!elf_external_minisymbols_p (abfd, dynamic))
+    return _bfd_generic_read_minisymbols (abfd, dynamic, minisymsp, sizep);
+
+  /* Skip the first symbol, which is a null dummy.  */
+  symcount = hdr->sh_size / sizeof (Elf_External_Sym) - 1;
+  table = elf_minisymbol_table (abfd);
+  if (table == NULL
+      || (syms = (const Elf_External_Sym **)
+	  bfd_malloc (symcount * sizeof (*syms))) == NULL)
+    {
+      bfd_set_error (bfd_error_no_symbols);
+      return -1;
+    }
+  for (i = 0; i < symcount; i++)
+    syms[i] = table + i + 1;
+
+  *minisymsp = syms;
+  *sizep = sizeof (*syms);
+  return symcount;
+}
+
+/* Convert MINISYM, read by elf_read_minisymbols, into a BFD symbol.
+   External ELF symbols are translated into SYM, which must have come
+   from bfd_make_empty_symbol.  */
+
+asymbol *
+elf_minisymbol_to_symbol (bfd *abfd,
+			  bool dynamic,
+			  const void *minisym,
+			  asymbol *sym)
+{
+  const struct elf_backend_data *ebd = get_elf_backend_data (abfd);
+  elf_symbol_type *elfsym = (elf_symbol_type *) sym;
+  Elf_Internal_Sym isym;
+
+  if (!elf_external_minisymbols_p (abfd, dynamic))
+    return _bfd_generic_minisymbol_to_symbol (abfd, dynamic, minisym, sym);
+
+  memset (elfsym, 0, sizeof (*elfsym));
+  if (!elf_swap_symbol_in (abfd, *(const Elf_External_Sym **) minisym,
+			   NULL, &isym)
+      || !elf_translate_symbol (abfd, &elf_tdata (abfd)->symtab_hdr,
+				&isym, elfsym, false))
+    return NULL;
+
+  /* Do some backend-specific processing on this symbol.  */
+  if (ebd->elf_backend_symbol_processing)
+    (*ebd->elf_backend_symbol_processing) (abfd, &elfsym->symbol);
+
+  return &elfsym->symbol;
+}
+
 /* Read relocations for ASECT from REL_HDR.  There are RELOC_COUNT of
    them.  */
 
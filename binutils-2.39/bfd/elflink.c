@@ -6337,6 +6337,145 @@ static const size_t elf_buckets[] =
   16411, 32771, 0
 };
 
+/* For the weight function we need some information about the
+   pagesize on the target.  This is information need not be 100%
+   accurate.  Since this information is not available (so far) we
+   define it here to a reasonable default value.  If it is crucial
+   to have a better value some day simply define this value.  */
+#ifndef BFD_TARGET_PAGESIZE
+#define BFD_TARGET_PAGESIZE	(4096)
+#endif
+
+/* compute_bucket_count evaluates table sizes exactly just below the
+   top of the BUCKET_COUNT_STEPS most promising page steps.  It tries
+   at least BUCKET_COUNT_WINDOW sizes per step, more if that doesn't
+   take counting BUCKET_COUNT_WORK symbols, and all of them if there
+   are few enough.  */
+#define BUCKET_COUNT_STEPS	2
+#define BUCKET_COUNT_WINDOW	64
+#define BUCKET_COUNT_WORK	(1UL << 25)
+
+/* Parameters and state of the search for the best hash table size.  */
+
+struct bucket_count_search
+{
+  unsigned long int *hashcodes;
+  unsigned long int nsyms;
+  bool gnu_hash;
+
+  /* We in any case need 2 + DYNSYMCOUNT entries for the size values
+     and the chains.  */
+  uint64_t base;
+
+  /* The number of hash table entries in a target page.  */
+  unsigned long int per_page;
+
+  /* Scratch space for the chain lengths.  */
+  unsigned long int *counts;
+
+  size_t best_size;
+  uint64_t best_cost;
+};
+
+/* Apply the size penalty of a table with SIZE buckets to COST.  */
+
+static uint64_t
+bucket_count_penalty (struct bucket_count_search *search, uint64_t cost,
+		      unsigned long int size)
+{
+  uint64_t fact = size / search->per_page + 1;
+
+  return cost * fact * fact;
+}
+
+/* Return the cost of a table with SIZE buckets.  We add the squares
+   of all the chain lengths, which favors many small chains over a few
+   long chains, and then penalize the overall size of the table.  */
+
+static uint64_t
+bucket_count_cost (struct bucket_count_search *search,
+		   unsigned long int size)
+{
+  unsigned long int *counts = search->counts;
+  uint64_t cost = search->base;
+  unsigned long int j;
+
+  /* Determine how often each hash bucket is used.  */
+  memset (counts, '\0', size * sizeof (unsigned long int));
+  for (j = 0; j < search->nsyms; ++j)
+    ++counts[search->hashcodes[j] % size];
+
+  for (j = 0; j < size; ++j)
+    cost += (uint64_t) counts[j] * counts[j];
+
+  return bucket_count_penalty (search, cost, size);
+}
+
+/* Return a lower bound for the cost of a table with SIZE buckets.  No
+   table does better than one with the symbols spread evenly over all
+   the buckets.  */
+
+static uint64_t
+bucket_count_min_cost (struct bucket_count_search *search,
+		       unsigned long int size)
+{
+  uint64_t q = search->nsyms / size;
+  uint64_t r = search->nsyms % size;
+
+  return bucket_count_penalty (search,
+			       search->base + q * q * size + r * (2 * q + 1),
+			       size);
+}
+
+/* Return the expected cost of a table with SIZE buckets if the hash
+   function distributes the symbols uniformly.  The expected sum of
+   the squares of the chain lengths is then NSYMS + NSYMS * (NSYMS - 1)
+   / SIZE.  */
+
+static uint64_t
+bucket_count_estimate (struct bucket_count_search *search,
+		       unsigned long int size)
+{
+  uint64_t nsyms = search->nsyms;
+
+  return bucket_count_penalty (search,
+			       (search->base + nsyms
+				+ nsyms * (nsyms - 1) / size),
+			       size);
+}
+
+/* Evaluate the table sizes from LO up to but not including HI, unless
+   they are sure not to beat the best one found so far.  Ties go to
+   the smaller table.  */
+
+static void
+bucket_count_try (struct bucket_count_search *search,
+		  unsigned long int lo, unsigned long int hi)
+{
+  unsigned long int i;
+
+  for (i = lo; i < hi; ++i)
+    {
+      uint64_t cost;
+
+      if (search->gnu_hash && (i & 31) == 0)
+	continue;
+
+      cost = bucket_count_min_cost (search, i);
+      if (cost > search->best_cost
+	  || (cost == search->best_cost && i > search->best_size))
+	continue;
+
+      cost = bucket_count_cost (search, i);
+      if (cost < search->best_cost
+	  || (cost == search->best_cost && i < search->best_size))
+	{
+	  search->best_cost = cost;
+	  search->best_size = i;
+	}
+    }
+}
+
 /* Compute bucket count for hashing table.  We do not use a static set
    of possible tables sizes anymore.  Instead we determine for all
    possible reasonable sizes of the table the outcome (i.e., the
@@ -6344,7 +6483,13 @@ static const size_t elf_buckets[] =
    weighting functions are not too simple to allow the table to grow
    without bounds.  Instead one of the weighting factors is the size.
    Therefore the result is always a good payoff between few collisions
-   (= short chain lengths) and table size.  */
+   (= short chain lengths) and table size.
+
+   Working out the cost of one size means hashing all the symbols, so
+   with many symbols only a few sizes can be tried.  The expected cost
+   only decreases with the size between the points where the size
+   penalty steps up, so the sizes tried exactly are those just below
+   the steps with the lowest expected cost.  */
 static size_t
 compute_bucket_count (struct bfd_link_info *info ATTRIBUTE_UNUSED,
 		      unsigned long int *hashcodes ATTRIBUTE_UNUSED,
@@ -6358,13 +6503,12 @@ compute_bucket_count (struct bfd_link_info *info ATTRIBUTE_UNUSED,
     {
       size_t minsize;
       size_t maxsize;
-      uint64_t best_chlen = ~((uint64_t) 0);
       bfd *dynobj = elf_hash_table (info)->dynobj;
       size_t dynsymcount = elf_hash_table (info)->dynsymcount;
       const struct elf_backend_data *bed = get_elf_backend_data (dynobj);
-      unsigned long int *counts;
+      struct bucket_count_search search;
+      unsigned long int window;
       bfd_size_type amt;
-      unsigned int no_improvement_count = 0;
 
       /* Possible optimization parameters: if we have NSYMS symbols we say
 	 that the hashing table must at least have NSYMS/4 and at most
@@ -6380,84 +6524,81 @@ compute_bucket_count (struct bfd_link_info *info ATTRIBUTE_UNUSED,
 	  if ((best_size & 31) == 0)
 	    ++best_size;
 	}
+      if (minsize >= maxsize)
+	return best_size;
 
       /* Create array where we count the collisions in.  We must use bfd_malloc
 	 since the size could be large.  */
       amt = maxsize;
       amt *= sizeof (unsigned long int);
-      counts = (unsigned long int *) bfd_malloc (amt);
-      if (counts == NULL)
+      search.counts = (unsigned long int *) bfd_malloc (amt);
+      if (search.counts == NULL)
 	return 0;
 
-      /* Compute the "optimal" size for the hash table.  The criteria is a
-	 minimal chain length.  The minor criteria is (of course) the size
-	 of the table.  */
-      for (i = minsize; i < maxsize; ++i)
+      search.hashcodes = hashcodes;
+      search.nsyms = nsyms;
+      search.gnu_hash = gnu_hash;
+      search.base = (2 + dynsymcount) * bed->s->sizeof_hash_entry;
+      search.per_page = BFD_TARGET_PAGESIZE / bed->s->sizeof_hash_entry;
+      search.best_size = best_size;
+      search.best_cost = ~((uint64_t) 0);
+
+      window = BUCKET_COUNT_WORK / (nsyms + maxsize) / BUCKET_COUNT_STEPS;
+      if (window < BUCKET_COUNT_WINDOW)
+	window = BUCKET_COUNT_WINDOW;
+
+      if (maxsize - minsize <= window * BUCKET_COUNT_STEPS)
+	bucket_count_try (&search, minsize, maxsize);
+      else
 	{
-	  /* Walk through the array of hashcodes and count the collisions.  */
-	  uint64_t max;
-	  unsigned long int j;
-	  unsigned long int fact;
+	  unsigned long int tops[BUCKET_COUNT_STEPS];
+	  uint64_t top_costs[BUCKET_COUNT_STEPS];
+	  unsigned int ntops = 0, k;
 
-	  if (gnu_hash && (i & 31) == 0)
-	    continue;
+	  /* Find the page steps whose largest size has the lowest
+	     expected cost.  */
+	  for (i = minsize; i < maxsize; i = (i / search.per_page + 1)
+					      * search.per_page)
+	    {
+	      unsigned long int top;
+	      uint64_t cost;
 
-	  memset (counts, '\0', i * sizeof (unsigned long int));
-
-	  /* Determine how often each hash bucket is used.  */
-	  for (j = 0; j < nsyms; ++j)
-	    ++counts[hashcodes[j] % i];
-
-	  /* For the weight function we need some information about the
-	     pagesize on the target.  This is information need not be 100%
-	     accurate.  Since this information is not available (so far) we
-	     define it here to a reasonable default value.  If it is crucial
-	     to have a better value some day simply define this value.  */
-# ifndef BFD_TARGET_PAGESIZE
-#  define BFD_TARGET_PAGESIZE	(4096)
-# endif
-
-	  /* We in any case need 2 + DYNSYMCOUNT entries for the size values
-	     and the chains.  */
-	  max = (2 + dynsymcount) * bed->s->sizeof_hash_entry;
-
-# if 1
-	  /* Variant 1: optimize for short chains.  We add the squares
-	     of all the chain lengths (which favors many small chain
-	     over a few long chains).  */
-	  for (j = 0; j < i; ++j)
-	    max += counts[j] * counts[j];
-
-	  /* This adds penalties for the overall size of the table.  */
-	  fact = i / (BFD_TARGET_PAGESIZE / bed->s->sizeof_hash_entry) + 1;
-	  max *= fact * fact;
-# else
-	  /* Variant 2: Optimize a lot more for small table.  Here we
-	     also add squares of the size but we also add penalties for
-	     empty slots (the +1 term).  */
-	  for (j = 0; j < i; ++j)
-	    max += (1 + counts[j]) * (1 + counts[j]);
-
-	  /* The overall size of the table is considered, but not as
-	     strong as in variant 1, where it is squared.  */
-	  fact = i / (BFD_TARGET_PAGESIZE / bed->s->sizeof_hash_entry) + 1;
-	  max *= fact;
-# endif
-
-	  /* Compare with current best results.  */
-	  if (max < best_chlen)
-	    {
-	      best_chlen = max;
-	      best_size = i;
-	      no_improvement_count = 0;
-	    }
-	  /* PR 11843: Avoid futile long searches for the best bucket size
-	     when there are a large number of symbols.  */
-	  else if (++no_improvement_count == 100)
-	    break;
+	      top = (i / search.per_page + 1) * search.per_page;
+	      if (top > maxsize)
+		top = maxsize;
+	      cost = bucket_count_estimate (&search, top - 1);
+
+	      for (k = ntops; k > 0 && cost < top_costs[k - 1]; --k)
+		if (k < BUCKET_COUNT_STEPS)
+		  {
+		    tops[k] = tops[k - 1];
+		    top_costs[k] = top_costs[k - 1];
+		  }
+	      if (k < BUCKET_COUNT_STEPS)
+		{
+		  tops[k] = top;
+		  top_costs[k] = cost;
+		  if (ntops < BUCKET_COUNT_STEPS)
+		    ++ntops;
+		}
+	    }
+
+	  /* Evaluate the sizes just below each of them.  */
+	  for (k = 0; k < ntops; ++k)
+	    {
+	      unsigned long int lo = tops[k] - 1;
+
+	      lo -= lo % search.per_page;
+	      if (lo < minsize)
+		lo = minsize;
+	      if (tops[k] - lo > window)
+		lo = tops[k] - window;
+	      bucket_count_try (&search, lo, tops[k]);
+	    }
 	}
 
-      free (counts);
+      best_size = search.best_size;
+      free (search.counts);
     }
   else
     {
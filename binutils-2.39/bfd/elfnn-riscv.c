@@ -2558,7 +2558,7 @@ riscv_elf_relocate_section (bfd *output_bfd,
 	case R_RISCV_PCREL_LO12_I:
 	case R_RISCV_PCREL_LO12_S:
 	  /* We don't allow section symbols plus addends as the auipc address,
-	     because then riscv_relax_delete_bytes would have to search through
+	     because then riscv_relax_resolve_delete_relocs would have to search
 	     all relocs to update these addends.  This is also ambiguous, as
 	     we do allow offsets to be added to the target address, which are
 	     not to be used to find the auipc address.  */
@@ -4023,96 +4023,198 @@ riscv_find_pcgp_lo_reloc (riscv_pcgp_relocs *p, bfd_vma hi_sec_off)
   return false;
 }
 
-static void
-riscv_update_pcgp_relocs (riscv_pcgp_relocs *p, asection *deleted_sec,
-			  bfd_vma deleted_addr, size_t deleted_count)
+/* Record that COUNT bytes at ADDR in the section are to be deleted.  The
+   deletion is recorded in REL, which must be a reloc that is no longer
+   needed, by turning it into an R_RISCV_DELETE.  The bytes are actually
+   removed by riscv_relax_resolve_delete_relocs once the whole section has
+   been scanned, so that a section with many relaxations is only compacted
+   once per pass.  */
+
+static bool
+riscv_relax_delete_bytes (Elf_Internal_Rela *rel,
+			  bfd_vma addr,
+			  size_t count)
 {
-  /* Bytes have already been deleted and toaddr should match the old section
-     size for our checks, so adjust it here.  */
-  bfd_vma toaddr = deleted_sec->size + deleted_count;
-  riscv_pcgp_lo_reloc *l;
-  riscv_pcgp_hi_reloc *h;
-
-  /* Update section offsets of corresponding pcrel_hi relocs for the pcrel_lo
-     entries where they occur after the deleted bytes.  */
-  for (l = p->lo; l != NULL; l = l->next)
-    if (l->hi_sec_off > deleted_addr
-	&& l->hi_sec_off < toaddr)
-      l->hi_sec_off -= deleted_count;
-
-  /* Update both section offsets, and symbol values of pcrel_hi relocs where
-     these values occur after the deleted bytes.  */
-  for (h = p->hi; h != NULL; h = h->next)
+  rel->r_info = ELFNN_R_INFO (0, R_RISCV_DELETE);
+  rel->r_offset = addr;
+  rel->r_addend = count;
+  return true;
+}
+
+/* A pending deletion of bytes, as recorded by an R_RISCV_DELETE reloc.
+   TOTAL is the number of bytes deleted by this and all the earlier
+   deletions, so that the distance any address moves is a prefix sum.  */
+
+typedef struct
+{
+  bfd_vma addr;
+  bfd_vma count;
+  bfd_vma total;
+} riscv_deletion;
+
+static int
+riscv_deletion_compare (const void *a, const void *b)
+{
+  const riscv_deletion *da = (const riscv_deletion *) a;
+  const riscv_deletion *db = (const riscv_deletion *) b;
+
+  if (da->addr != db->addr)
+    return da->addr < db->addr ? -1 : 1;
+  return 0;
+}
+
+/* Return the number of bytes deleted strictly below ADDR, given the N
+   sorted deletions in DELS.  */
+
+static bfd_vma
+riscv_deleted_below (const riscv_deletion *dels, size_t n, bfd_vma addr)
+{
+  size_t lo = 0, hi = n;
+
+  while (lo < hi)
     {
-      if (h->hi_sec_off > deleted_addr
-	  && h->hi_sec_off < toaddr)
-	h->hi_sec_off -= deleted_count;
-      if (h->sym_sec == deleted_sec
-	  && h->hi_addr > deleted_addr
-	  && h->hi_addr < toaddr)
-      h->hi_addr -= deleted_count;
+      size_t mid = lo + (hi - lo) / 2;
+      if (dels[mid].addr < addr)
+	lo = mid + 1;
+      else
+	hi = mid;
     }
+  return lo == 0 ? 0 : dels[lo - 1].total;
 }
 
-/* Delete some bytes from a section while relaxing.  */
+/* Adjust the VALUE and SIZE of a symbol defined in a section of original
+   size TOADDR, for the N sorted deletions in DELS.  This gives the same
+   result as applying each deletion in turn: the value moves down by the
+   bytes deleted below it, and the size shrinks by the bytes deleted
+   inside the symbol.  */
+
+static void
+riscv_adjust_symbol_for_deletions (const riscv_deletion *dels, size_t n,
+				   bfd_vma toaddr, bfd_vma *value,
+				   bfd_vma *size)
+{
+  bfd_vma start = *value;
+  bfd_vma end = start + *size;
+  bfd_vma below_start;
+
+  if (start > toaddr)
+    return;
+
+  below_start = riscv_deleted_below (dels, n, start);
+  *value -= below_start;
+  if (end <= toaddr)
+    *size -= riscv_deleted_below (dels, n, end) - below_start;
+}
+
+/* Delete the bytes for all the R_RISCV_DELETE relocs in SEC.  The contents
+   are compacted in a single sweep, and the relocs and the local and global
+   symbols defined in the section are each adjusted once, using the prefix
+   sums of the deleted byte counts.  */
 
 static bool
-riscv_relax_delete_bytes (bfd *abfd,
-			  asection *sec,
-			  bfd_vma addr,
-			  size_t count,
-			  struct bfd_link_info *link_info,
-			  riscv_pcgp_relocs *p)
+riscv_relax_resolve_delete_relocs (bfd *abfd,
+				   asection *sec,
+				   struct bfd_link_info *link_info,
+				   Elf_Internal_Rela *relocs)
 {
-  unsigned int i, symcount;
-  bfd_vma toaddr = sec->size;
   struct elf_link_hash_entry **sym_hashes = elf_sym_hashes (abfd);
   Elf_Internal_Shdr *symtab_hdr = &elf_tdata (abfd)->symtab_hdr;
-  unsigned int sec_shndx = _bfd_elf_section_from_bfd_section (abfd, sec);
-  struct bfd_elf_section_data *data = elf_section_data (sec);
-  bfd_byte *contents = data->this_hdr.contents;
+  unsigned int sec_shndx;
+  bfd_byte *contents = elf_section_data (sec)->this_hdr.contents;
+  bfd_vma toaddr = sec->size;
+  bfd_vma dst, total;
+  riscv_deletion *dels;
+  htab_t seen = NULL;
+  size_t n, m, k;
+  unsigned int i, symcount;
+
+  for (n = 0, i = 0; i < sec->reloc_count; i++)
+    if (ELFNN_R_TYPE (relocs[i].r_info) == R_RISCV_DELETE)
+      n++;
+  if (n == 0)
+    return true;
 
-  /* Actually delete the bytes.  */
-  sec->size -= count;
-  memmove (contents + addr, contents + addr + count, toaddr - addr - count);
+  dels = bfd_malloc (n * sizeof (*dels));
+  if (dels == NULL)
+    return false;
+
+  for (n = 0, i = 0; i < sec->reloc_count; i++)
+    if (ELFNN_R_TYPE (relocs[i].r_info) == R_RISCV_DELETE)
+      {
+	dels[n].addr = relocs[i].r_offset;
+	dels[n].count = relocs[i].r_addend;
+	relocs[i].r_info = ELFNN_R_INFO (0, R_RISCV_NONE);
+	n++;
+      }
+
+  /* The relocs are normally sorted by offset, in which case so are the
+     deletions.  */
+  for (k = 1; k < n; k++)
+    if (dels[k].addr < dels[k - 1].addr)
+      {
+	qsort (dels, n, sizeof (*dels), riscv_deletion_compare);
+	break;
+      }
+
+  /* Merge overlapping and adjacent deletions, so that no byte is deleted
+     twice and the runs of kept bytes between them are never negative.
+     Reject deletions that run past the end of the section.  */
+  for (m = 0, k = 0; k < n; k++)
+    {
+      if (dels[k].addr > toaddr || dels[k].count > toaddr - dels[k].addr)
+	{
+	  _bfd_error_handler
+	    /* xgettext:c-format */
+	    (_("%pB(%pA+%#" PRIx64 "): deletion of %" PRIu64 " bytes "
+	       "runs past the end of the section"),
+	     abfd, sec, (uint64_t) dels[k].addr, (uint64_t) dels[k].count);
+	  bfd_set_error (bfd_error_bad_value);
+	  free (dels);
+	  return false;
+	}
+      if (m > 0 && dels[k].addr <= dels[m - 1].addr + dels[m - 1].count)
+	{
+	  bfd_vma end = dels[k].addr + dels[k].count;
+
+	  if (end > dels[m - 1].addr + dels[m - 1].count)
+	    dels[m - 1].count = end - dels[m - 1].addr;
+	}
+      else
+	dels[m++] = dels[k];
+    }
+  n = m;
+
+  /* Actually delete the bytes, moving each run of kept bytes just once.  */
+  dst = dels[0].addr;
+  total = 0;
+  for (k = 0; k < n; k++)
+    {
+      bfd_vma src = dels[k].addr + dels[k].count;
+      bfd_vma end = k + 1 < n ? dels[k + 1].addr : toaddr;
+
+      memmove (contents + dst, contents + src, end - src);
+      dst += end - src;
+      total += dels[k].count;
+      dels[k].total = total;
+    }
+  sec->size -= total;
 
   /* Adjust the location of all of the relocs.  Note that we need not
      adjust the addends, since all PC-relative references must be against
      symbols, which we will adjust below.  */
   for (i = 0; i < sec->reloc_count; i++)
-    if (data->relocs[i].r_offset > addr && data->relocs[i].r_offset < toaddr)
-      data->relocs[i].r_offset -= count;
-
-  /* Adjust the hi_sec_off, and the hi_addr of any entries in the pcgp relocs
-     table for which these values occur after the deleted bytes.  */
-  if (p)
-    riscv_update_pcgp_relocs (p, sec, addr, count);
+    if (relocs[i].r_offset < toaddr)
+      relocs[i].r_offset -= riscv_deleted_below (dels, n,
+						 relocs[i].r_offset);
 
   /* Adjust the local symbols defined in this section.  */
+  sec_shndx = _bfd_elf_section_from_bfd_section (abfd, sec);
   for (i = 0; i < symtab_hdr->sh_info; i++)
     {
       Elf_Internal_Sym *sym = (Elf_Internal_Sym *) symtab_hdr->contents + i;
       if (sym->st_shndx == sec_shndx)
-	{
-	  /* If the symbol is in the range of memory we just moved, we
-	     have to adjust its value.  */
-	  if (sym->st_value > addr && sym->st_value <= toaddr)
-	    sym->st_value -= count;
-
-	  /* If the symbol *spans* the bytes we just deleted (i.e. its
-	     *end* is in the moved bytes but its *start* isn't), then we
-	     must adjust its size.
-
-	     This test needs to use the original value of st_value, otherwise
-	     we might accidentally decrease size when deleting bytes right
-	     before the symbol.  But since deleted relocs can't span across
-	     symbols, we can't have both a st_value and a st_size decrease,
-	     so it is simpler to just use an else.  */
-	  else if (sym->st_value <= addr
-		   && sym->st_value + sym->st_size > addr
-		   && sym->st_value + sym->st_size <= toaddr)
-	    sym->st_size -= count;
-	}
+	riscv_adjust_symbol_for_deletions (dels, n, toaddr, &sym->st_value,
+					   &sym->st_size);
     }
 
   /* Now adjust the global symbols defined in this section.  */
@@ -4132,43 +4234,54 @@ riscv_relax_delete_bytes (bfd *abfd,
 
 	 The same problem occurs with symbols that are versioned_hidden, as
 	 foo becomes an alias for foo@BAR, and hence they need the same
-	 treatment.  */
-      if (link_info->wrap_hash != NULL
-	  || sym_hash->versioned != unversioned)
+	 treatment.  Remember the symbols already checked in a hash table,
+	 which is only created once such a symbol is seen.  */
+      if (seen == NULL
+	  && (link_info->wrap_hash != NULL
+	      || sym_hash->versioned != unversioned))
+	{
+	  unsigned int j;
+
+	  seen = htab_create (symcount, htab_hash_pointer, htab_eq_pointer,
+			      NULL);
+	  if (seen == NULL)
+	    {
+	      free (dels);
+	      return false;
+	    }
+	  for (j = 0; j < i; j++)
+	    *htab_find_slot (seen, sym_hashes[j], INSERT) = sym_hashes[j];
+	}
+
+      if (seen != NULL)
 	{
-	  struct elf_link_hash_entry **cur_sym_hashes;
+	  void **slot = htab_find_slot (seen, sym_hash, INSERT);
 
-	  /* Loop only over the symbols which have already been checked.  */
-	  for (cur_sym_hashes = sym_hashes; cur_sym_hashes < &sym_hashes[i];
-	       cur_sym_hashes++)
+	  if (slot == NULL)
 	    {
-	      /* If the current symbol is identical to 'sym_hash', that means
-		 the symbol was already adjusted (or at least checked).  */
-	      if (*cur_sym_hashes == sym_hash)
-		break;
+	      htab_delete (seen);
+	      free (dels);
+	      return false;
 	    }
 	  /* Don't adjust the symbol again.  */
-	  if (cur_sym_hashes < &sym_hashes[i])
+	  if (*slot != NULL
+	      && (link_info->wrap_hash != NULL
+		  || sym_hash->versioned != unversioned))
 	    continue;
+	  *slot = sym_hash;
 	}
 
       if ((sym_hash->root.type == bfd_link_hash_defined
 	   || sym_hash->root.type == bfd_link_hash_defweak)
 	  && sym_hash->root.u.def.section == sec)
-	{
-	  /* As above, adjust the value if needed.  */
-	  if (sym_hash->root.u.def.value > addr
-	      && sym_hash->root.u.def.value <= toaddr)
-	    sym_hash->root.u.def.value -= count;
-
-	  /* As above, adjust the size if needed.  */
-	  else if (sym_hash->root.u.def.value <= addr
-		   && sym_hash->root.u.def.value + sym_hash->size > addr
-		   && sym_hash->root.u.def.value + sym_hash->size <= toaddr)
-	    sym_hash->size -= count;
-	}
+	riscv_adjust_symbol_for_deletions (dels, n, toaddr,
+					   &sym_hash->root.u.def.value,
+					   &sym_hash->size);
     }
 
+  if (seen != NULL)
+    htab_delete (seen);
+  free (dels);
   return true;
 }
 
@@ -4189,7 +4302,7 @@ _bfd_riscv_relax_call (bfd *abfd, asection *sec, asection *sym_sec,
 		       bfd_vma max_alignment,
 		       bfd_vma reserve_size ATTRIBUTE_UNUSED,
 		       bool *again,
-		       riscv_pcgp_relocs *pcgp_relocs,
+		       riscv_pcgp_relocs *pcgp_relocs ATTRIBUTE_UNUSED,
 		       bool undefined_weak ATTRIBUTE_UNUSED)
 {
   bfd_byte *contents = elf_section_data (sec)->this_hdr.contents;
@@ -4250,10 +4363,9 @@ _bfd_riscv_relax_call (bfd *abfd, asection *sec, asection *sym_sec,
   /* Replace the AUIPC.  */
   riscv_put_insn (8 * len, auipc, contents + rel->r_offset);
 
-  /* Delete unnecessary JALR.  */
+  /* Delete unnecessary JALR, reusing the R_RISCV_RELAX to record it.  */
   *again = true;
-  return riscv_relax_delete_bytes (abfd, sec, rel->r_offset + len, 8 - len,
-				   link_info, pcgp_relocs);
+  return riscv_relax_delete_bytes (rel + 1, rel->r_offset + len, 8 - len);
 }
 
 /* Traverse all output sections and return the max alignment.  */
@@ -4285,7 +4397,7 @@ _bfd_riscv_relax_lui (bfd *abfd,
 		      bfd_vma max_alignment,
 		      bfd_vma reserve_size,
 		      bool *again,
-		      riscv_pcgp_relocs *pcgp_relocs,
+		      riscv_pcgp_relocs *pcgp_relocs ATTRIBUTE_UNUSED,
 		      bool undefined_weak)
 {
   bfd_byte *contents = elf_section_data (sec)->this_hdr.contents;
@@ -4344,10 +4456,8 @@ _bfd_riscv_relax_lui (bfd *abfd,
 
 	case R_RISCV_HI20:
 	  /* We can delete the unnecessary LUI and reloc.  */
-	  rel->r_info = ELFNN_R_INFO (0, R_RISCV_NONE);
 	  *again = true;
-	  return riscv_relax_delete_bytes (abfd, sec, rel->r_offset, 4,
-					   link_info, pcgp_relocs);
+	  return riscv_relax_delete_bytes (rel, rel->r_offset, 4);
 
 	default:
 	  abort ();
@@ -4379,8 +4489,7 @@ _bfd_riscv_relax_lui (bfd *abfd,
       rel->r_info = ELFNN_R_INFO (ELFNN_R_SYM (rel->r_info), R_RISCV_RVC_LUI);
 
       *again = true;
-      return riscv_relax_delete_bytes (abfd, sec, rel->r_offset + 2, 2,
-				       link_info, pcgp_relocs);
+      return riscv_relax_delete_bytes (rel + 1, rel->r_offset + 2, 2);
     }
 
   return true;
@@ -4389,7 +4498,7 @@ _bfd_riscv_relax_lui (bfd *abfd,
 /* Relax non-PIC TLS references to TP-relative references.  */
 
 static bool
-_bfd_riscv_relax_tls_le (bfd *abfd,
+_bfd_riscv_relax_tls_le (bfd *abfd ATTRIBUTE_UNUSED,
 			 asection *sec,
 			 asection *sym_sec ATTRIBUTE_UNUSED,
 			 struct bfd_link_info *link_info,
@@ -4398,7 +4507,7 @@ _bfd_riscv_relax_tls_le (bfd *abfd,
 			 bfd_vma max_alignment ATTRIBUTE_UNUSED,
 			 bfd_vma reserve_size ATTRIBUTE_UNUSED,
 			 bool *again,
-			 riscv_pcgp_relocs *pcgp_relocs,
+			 riscv_pcgp_relocs *pcgp_relocs ATTRIBUTE_UNUSED,
 			 bool undefined_weak ATTRIBUTE_UNUSED)
 {
   /* See if this symbol is in range of tp.  */
@@ -4419,10 +4528,8 @@ _bfd_riscv_relax_tls_le (bfd *abfd,
     case R_RISCV_TPREL_HI20:
     case R_RISCV_TPREL_ADD:
       /* We can delete the unnecessary instruction and reloc.  */
-      rel->r_info = ELFNN_R_INFO (0, R_RISCV_NONE);
       *again = true;
-      return riscv_relax_delete_bytes (abfd, sec, rel->r_offset, 4, link_info,
-				       pcgp_relocs);
+      return riscv_relax_delete_bytes (rel, rel->r_offset, 4);
 
     default:
       abort ();
@@ -4435,7 +4542,7 @@ _bfd_riscv_relax_tls_le (bfd *abfd,
 static bool
 _bfd_riscv_relax_align (bfd *abfd, asection *sec,
 			asection *sym_sec,
-			struct bfd_link_info *link_info,
+			struct bfd_link_info *link_info ATTRIBUTE_UNUSED,
 			Elf_Internal_Rela *rel,
 			bfd_vma symval,
 			bfd_vma max_alignment ATTRIBUTE_UNUSED,
@@ -4468,12 +4575,13 @@ _bfd_riscv_relax_align (bfd *abfd, asection *sec,
       return false;
     }
 
-  /* Delete the reloc.  */
-  rel->r_info = ELFNN_R_INFO (0, R_RISCV_NONE);
-
   /* If the number of NOPs is already correct, there's nothing to do.  */
   if (nop_bytes == rel->r_addend)
-    return true;
+    {
+      /* Delete the reloc.  */
+      rel->r_info = ELFNN_R_INFO (0, R_RISCV_NONE);
+      return true;
+    }
 
   /* Write as many RISC-V NOPs as we need.  */
   for (pos = 0; pos < (nop_bytes & -4); pos += 4)
@@ -4483,10 +4591,9 @@ _bfd_riscv_relax_align (bfd *abfd, asection *sec,
   if (nop_bytes % 4 != 0)
     bfd_putl16 (RVC_NOP, contents + rel->r_offset + pos);
 
-  /* Delete the excess bytes.  */
-  return riscv_relax_delete_bytes (abfd, sec, rel->r_offset + nop_bytes,
-				   rel->r_addend - nop_bytes, link_info,
-				   NULL);
+  /* Delete the excess bytes, replacing the reloc.  */
+  return riscv_relax_delete_bytes (rel, rel->r_offset + nop_bytes,
+				   rel->r_addend - nop_bytes);
 }
 
 /* Relax PC-relative references to GP-relative references.  */
@@ -4500,7 +4607,7 @@ _bfd_riscv_relax_pc (bfd *abfd ATTRIBUTE_UNUSED,
 		     bfd_vma symval,
 		     bfd_vma max_alignment,
 		     bfd_vma reserve_size,
-		     bool *again ATTRIBUTE_UNUSED,
+		     bool *again,
 		     riscv_pcgp_relocs *pcgp_relocs,
 		     bool undefined_weak)
 {
@@ -4629,9 +4736,8 @@ _bfd_riscv_relax_pc (bfd *abfd ATTRIBUTE_UNUSED,
 				      sym_sec,
 				      undefined_weak);
 	  /* We can delete the unnecessary AUIPC and reloc.  */
-	  rel->r_info = ELFNN_R_INFO (0, R_RISCV_DELETE);
-	  rel->r_addend = 4;
-	  return true;
+	  *again = true;
+	  return riscv_relax_delete_bytes (rel, rel->r_offset, 4);
 
 	default:
 	  abort ();
@@ -4641,28 +4747,6 @@ _bfd_riscv_relax_pc (bfd *abfd ATTRIBUTE_UNUSED,
   return true;
 }
 
-/* Delete the bytes for R_RISCV_DELETE.  */
-
-static bool
-_bfd_riscv_relax_delete (bfd *abfd,
-			 asection *sec,
-			 asection *sym_sec ATTRIBUTE_UNUSED,
-			 struct bfd_link_info *link_info,
-			 Elf_Internal_Rela *rel,
-			 bfd_vma symval ATTRIBUTE_UNUSED,
-			 bfd_vma max_alignment ATTRIBUTE_UNUSED,
-			 bfd_vma reserve_size ATTRIBUTE_UNUSED,
-			 bool *again ATTRIBUTE_UNUSED,
-			 riscv_pcgp_relocs *pcgp_relocs ATTRIBUTE_UNUSED,
-			 bool undefined_weak ATTRIBUTE_UNUSED)
-{
-  if (!riscv_relax_delete_bytes (abfd, sec, rel->r_offset, rel->r_addend,
-				 link_info, NULL))
-    return false;
-  rel->r_info = ELFNN_R_INFO (0, R_RISCV_NONE);
-  return true;
-}
-
 /* Called by after_allocation to set the information of data segment
    before relaxing.  */
 
@@ -4677,8 +4761,11 @@ bfd_elfNN_riscv_set_data_segment_info (struct bfd_link_info *info,
 /* Relax a section.
 
    Pass 0: Shortens code sequences for LUI/CALL/TPREL/PCREL relocs.
-   Pass 1: Deletes the bytes that PCREL relaxation in pass 0 made obsolete.
-   Pass 2: Which cannot be disabled, handles code alignment directives.  */
+   Pass 1: Which cannot be disabled, handles code alignment directives.
+
+   The bytes made obsolete by either pass are not deleted straight away,
+   but recorded as R_RISCV_DELETE relocs and deleted all at once after the
+   section has been scanned.  */
 
 static bool
 _bfd_riscv_relax_section (bfd *abfd, asection *sec,
@@ -4692,6 +4779,7 @@ _bfd_riscv_relax_section (bfd *abfd, asection *sec,
   bool ret = false;
   unsigned int i;
   bfd_vma max_alignment, reserve_size = 0;
+  bfd_vma pending_deletes = 0;
   riscv_pcgp_relocs pcgp_relocs;
 
   *again = false;
@@ -4771,9 +4859,7 @@ _bfd_riscv_relax_section (bfd *abfd, asection *sec,
 	  /* Skip over the R_RISCV_RELAX.  */
 	  i++;
 	}
-      else if (info->relax_pass == 1 && type == R_RISCV_DELETE)
-	relax_func = _bfd_riscv_relax_delete;
-      else if (info->relax_pass == 2 && type == R_RISCV_ALIGN)
+      else if (info->relax_pass == 1 && type == R_RISCV_ALIGN)
 	relax_func = _bfd_riscv_relax_align;
       else
 	continue;
@@ -4926,12 +5012,27 @@ _bfd_riscv_relax_section (bfd *abfd, asection *sec,
 
       symval += sec_addr (sym_sec);
 
+      /* The alignment NOPs are placed according to the final addresses,
+	 so account for the bytes that earlier alignments in this section
+	 are going to delete.  */
+      if (relax_func == _bfd_riscv_relax_align)
+	symval -= pending_deletes;
+
       if (!relax_func (abfd, sec, sym_sec, info, rel, symval,
 		       max_alignment, reserve_size, again,
 		       &pcgp_relocs, undefined_weak))
 	goto fail;
+
+      if (relax_func == _bfd_riscv_relax_align
+	  && ELFNN_R_TYPE (rel->r_info) == R_RISCV_DELETE)
+	pending_deletes += rel->r_addend;
     }
 
+  /* Now delete all the bytes made obsolete by this pass.  */
+  if (data->relocs == relocs
+      && !riscv_relax_resolve_delete_relocs (abfd, sec, info, relocs))
+    goto fail;
+
   ret = true;
 
  fail:
@@ -1341,32 +1341,34 @@ riscv_recognized_prefixed_ext (const char *ext)
 }
 
 /* Canonical order for single letter extensions.  */
-static const char riscv_ext_canonical_order[] = "eigmafdqlcbkjtpvnh";
-
-/* Array is used to compare the orders of standard extensions quickly.  */
-static int riscv_ext_order[26] = {0};
-
-/* Init the riscv_ext_order array.  */
-
-static void
-riscv_init_ext_order (void)
+/* Array is used to compare the orders of standard extensions quickly.
+   The orders of all standard extensions are positive and follow the
+   canonical order "eigmafdqlcbkjtpvnh".  Some of the prefixed keyword
+   are not single letter, so we set their prefixed orders in the
+   riscv_compare_subsets directly, not through the riscv_ext_order.
+   The array is constant so that subset lists may be parsed from
+   several threads at once.  */
+static const int riscv_ext_order[26] =
 {
-  static bool inited = false;
-  if (inited)
-    return;
-
-  /* The orders of all standard extensions are positive.  */
-  int order = 1;
-
-  for (const char *ext = &riscv_ext_canonical_order[0]; *ext; ++ext)
-    riscv_ext_order[(*ext - 'a')] = order++;
-
-  /* Some of the prefixed keyword are not single letter, so we set
-     their prefixed orders in the riscv_compare_subsets directly,
-     not through the riscv_ext_order.  */
-
-  inited = true;
-}
+  ['e' - 'a'] = 1,
+  ['i' - 'a'] = 2,
+  ['g' - 'a'] = 3,
+  ['m' - 'a'] = 4,
+  ['a' - 'a'] = 5,
+  ['f' - 'a'] = 6,
+  ['d' - 'a'] = 7,
+  ['q' - 'a'] = 8,
+  ['l' - 'a'] = 9,
+  ['c' - 'a'] = 10,
+  ['b' - 'a'] = 11,
+  ['k' - 'a'] = 12,
+  ['j' - 'a'] = 13,
+  ['t' - 'a'] = 14,
+  ['p' - 'a'] = 15,
+  ['v' - 'a'] = 16,
+  ['n' - 'a'] = 17,
+  ['h' - 'a'] = 18,
+};
 
 /* Similar to the strcmp.  It returns an integer less than, equal to,
    or greater than zero if `subset2` is found, respectively, to be less
@@ -1947,10 +1949,6 @@ riscv_parse_subset (riscv_parse_subset_t *rps,
 {
   const char *p;
 
-  /* Init the riscv_ext_order array to compare the order of extensions
-     quickly.  */
-  riscv_init_ext_order ();
-
   if (arch == NULL)
     {
       riscv_set_default_arch (rps);
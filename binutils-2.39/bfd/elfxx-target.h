@@ -58,8 +58,6 @@
 #ifndef bfd_elfNN_find_inliner_info
 #define bfd_elfNN_find_inliner_info	_bfd_elf_find_inliner_info
 #endif
-#define bfd_elfNN_read_minisymbols	_bfd_elf_read_minisymbols
-#define bfd_elfNN_minisymbol_to_symbol	_bfd_elf_minisymbol_to_symbol
 #define bfd_elfNN_get_dynamic_symtab_upper_bound \
   _bfd_elf_get_dynamic_symtab_upper_bound
 #define bfd_elfNN_get_lineno		_bfd_elf_get_lineno
@@ -762,6 +760,9 @@
 #ifndef elf_backend_maybe_function_sym
 #define elf_backend_maybe_function_sym _bfd_elf_maybe_function_sym
 #endif
+#ifndef elf_backend_find_line_rows
+#define elf_backend_find_line_rows _bfd_elf_find_line_rows
+#endif
 
 #ifndef elf_backend_get_reloc_section
 #define elf_backend_get_reloc_section _bfd_elf_plt_get_reloc_section
@@ -904,6 +905,7 @@ static const struct elf_backend_data elfNN_bed =
   elf_backend_record_xhash_symbol,
   elf_backend_is_function_type,
   elf_backend_maybe_function_sym,
+  elf_backend_find_line_rows,
   elf_backend_get_reloc_section,
   elf_backend_copy_special_section_fields,
   elf_backend_link_order_error_handler,
@@ -179,6 +179,8 @@ extern bfd * _bfd_new_bfd
   (void) ATTRIBUTE_HIDDEN;
 extern bool _bfd_free_cached_info
   (bfd *) ATTRIBUTE_HIDDEN;
+extern void _bfd_free_decompressed_cache
+  (bfd *) ATTRIBUTE_HIDDEN;
 
 extern bool _bfd_bool_bfd_false
   (bfd *) ATTRIBUTE_HIDDEN;
@@ -586,6 +588,11 @@ extern int _bfd_dwarf2_find_nearest_line
    const char **, const char **, unsigned int *, unsigned int *,
    const struct dwarf_debug_section *, void **) ATTRIBUTE_HIDDEN;
 
+/* Find the line number table rows of a section.  */
+extern bool _bfd_dwarf2_find_line_rows
+  (bfd *, asymbol **, asection *, const struct dwarf_debug_section *,
+   void **, struct bfd_line_row **, size_t *) ATTRIBUTE_HIDDEN;
+
 /* Find the bias between DWARF addresses and real addresses.  */
 extern bfd_signed_vma _bfd_dwarf2_find_symbol_bias
   (asymbol **, void **) ATTRIBUTE_HIDDEN;
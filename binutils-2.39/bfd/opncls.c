@@ -123,6 +123,7 @@ _bfd_new_bfd_contained_in (bfd *obfd)
 static void
 _bfd_delete_bfd (bfd *abfd)
 {
+  _bfd_free_decompressed_cache (abfd);
   if (abfd->memory)
     {
       bfd_hash_table_free (&abfd->section_htab);
@@ -36,6 +36,7 @@
 #include "plugin.h"
 #include "libbfd.h"
 #include "libiberty.h"
+#include "elf/common.h"
 #include <dirent.h>
 
 #if !defined (HAVE_DLFCN_H) && defined (HAVE_WINDOWS_H)
@@ -127,15 +128,20 @@ message (int level ATTRIBUTE_UNUSED,
 struct plugin_list_entry
 {
   /* These must be initialized for each IR object with LTO wrapper.  */
-  ld_plugin_claim_file_handler claim_file;
   ld_plugin_all_symbols_read_handler all_symbols_read;
   ld_plugin_all_symbols_read_handler cleanup_handler;
   bool has_symbol_type;
 
   struct plugin_list_entry *next;
 
-  /* These can be reused for all IR objects.  */
+  /* These can be reused for all IR objects.  The plugin stays loaded
+     for the rest of the process once it has been opened, and its
+     onload function is only run once.  */
   const char *plugin_name;
+  void *handle;
+  ld_plugin_claim_file_handler claim_file;
+  bool onload_called;
+  bool onload_ok;
 };
 
 static const char *plugin_program_name;
@@ -340,7 +346,6 @@ try_load_plugin (const char *pname,
   int i;
   ld_plugin_onload onload;
   enum ld_plugin_status status;
-  bool result = false;
 
   /* NB: Each object is independent.  Reuse the previous plugin from
      the last run will lead to wrong result.  */
@@ -351,16 +356,21 @@ try_load_plugin (const char *pname,
   if (plugin_list_iter)
     pname = plugin_list_iter->plugin_name;
 
-  plugin_handle = dlopen (pname, RTLD_NOW);
-  if (!plugin_handle)
+  if (plugin_list_iter != NULL && plugin_list_iter->handle != NULL)
+    plugin_handle = plugin_list_iter->handle;
+  else
     {
-      /* If we are building a list of viable plugins, then
-	 we do not bother the user with the details of any
-	 plugins that cannot be loaded.  */
-      if (! build_list_p)
-	_bfd_error_handler ("Failed to load plugin '%s', reason: %s\n",
-			    pname, dlerror ());
-      return false;
+      plugin_handle = dlopen (pname, RTLD_NOW);
+      if (!plugin_handle)
+	{
+	  /* If we are building a list of viable plugins, then
+	     we do not bother the user with the details of any
+	     plugins that cannot be loaded.  */
+	  if (! build_list_p)
+	    _bfd_error_handler ("Failed to load plugin '%s', reason: %s\n",
+				pname, dlerror ());
+	  return false;
+	}
     }
 
   if (plugin_list_iter == NULL)
@@ -369,12 +379,16 @@ try_load_plugin (const char *pname,
       char *plugin_name = bfd_malloc (length_plugin_name);
 
       if (plugin_name == NULL)
-	goto short_circuit;
+	{
+	  dlclose (plugin_handle);
+	  return false;
+	}
       plugin_list_iter = bfd_malloc (sizeof *plugin_list_iter);
       if (plugin_list_iter == NULL)
 	{
 	  free (plugin_name);
-	  goto short_circuit;
+	  dlclose (plugin_handle);
+	  return false;
 	}
       /* Make a copy of PNAME since PNAME from load_plugin () will be
 	 freed.  */
@@ -384,55 +398,59 @@ try_load_plugin (const char *pname,
       plugin_list_iter->next = plugin_list;
       plugin_list = plugin_list_iter;
     }
+  plugin_list_iter->handle = plugin_handle;
 
   current_plugin = plugin_list_iter;
   if (build_list_p)
-    goto short_circuit;
+    return false;
+
+  if (!current_plugin->onload_called)
+    {
+      current_plugin->onload_called = true;
+
+      onload = dlsym (plugin_handle, "onload");
+      if (!onload)
+	return false;
 
-  onload = dlsym (plugin_handle, "onload");
-  if (!onload)
-    goto short_circuit;
+      i = 0;
+      tv[i].tv_tag = LDPT_MESSAGE;
+      tv[i].tv_u.tv_message = message;
 
-  i = 0;
-  tv[i].tv_tag = LDPT_MESSAGE;
-  tv[i].tv_u.tv_message = message;
+      ++i;
+      tv[i].tv_tag = LDPT_REGISTER_CLAIM_FILE_HOOK;
+      tv[i].tv_u.tv_register_claim_file = register_claim_file;
 
-  ++i;
-  tv[i].tv_tag = LDPT_REGISTER_CLAIM_FILE_HOOK;
-  tv[i].tv_u.tv_register_claim_file = register_claim_file;
+      ++i;
+      tv[i].tv_tag = LDPT_ADD_SYMBOLS;
+      tv[i].tv_u.tv_add_symbols = add_symbols;
 
-  ++i;
-  tv[i].tv_tag = LDPT_ADD_SYMBOLS;
-  tv[i].tv_u.tv_add_symbols = add_symbols;
+      ++i;
+      tv[i].tv_tag = LDPT_ADD_SYMBOLS_V2;
+      tv[i].tv_u.tv_add_symbols = add_symbols_v2;
 
-  ++i;
-  tv[i].tv_tag = LDPT_ADD_SYMBOLS_V2;
-  tv[i].tv_u.tv_add_symbols = add_symbols_v2;
+      ++i;
+      tv[i].tv_tag = LDPT_NULL;
+      tv[i].tv_u.tv_val = 0;
 
-  ++i;
-  tv[i].tv_tag = LDPT_NULL;
-  tv[i].tv_u.tv_val = 0;
+      /* LTO plugin will call handler hooks to set up plugin handlers.  */
+      status = (*onload)(tv);
 
-  /* LTO plugin will call handler hooks to set up plugin handlers.  */
-  status = (*onload)(tv);
+      current_plugin->onload_ok = status == LDPS_OK;
+    }
 
-  if (status != LDPS_OK)
-    goto short_circuit;
+  if (!current_plugin->onload_ok)
+    return false;
 
   abfd->plugin_format = bfd_plugin_no;
 
   if (!current_plugin->claim_file)
-    goto short_circuit;
+    return false;
 
   if (!try_claim (abfd))
-    goto short_circuit;
+    return false;
 
   abfd->plugin_format = bfd_plugin_yes;
-  result = true;
-
- short_circuit:
-  dlclose (plugin_handle);
-  return result;
+  return true;
 }
 
 /* There may be plugin libraries in lib/bfd-plugins.  */
@@ -567,14 +585,277 @@ load_plugin (bfd *abfd)
 }
 
 
+/* Return TRUE if NAME, a string table of SIZE bytes, mentions a
+   section used for LTO IR by GCC or LLVM.  */
+
+static bool
+lto_section_name_p (const char *name, bfd_size_type size)
+{
+  static const struct
+  {
+    const char *prefix;
+    size_t len;
+  } lto_prefixes[] =
+    {
+      { STRING_COMMA_LEN (".gnu.lto_") },
+      { STRING_COMMA_LEN (".gnu.offload_lto_") },
+      { STRING_COMMA_LEN (".llvm.lto") },
+      { STRING_COMMA_LEN (".llvmbc") }
+    };
+  bfd_size_type i;
+  unsigned int j;
+
+  /* Names may share a tail with longer names, so look everywhere
+     rather than only at the start of each string.  */
+  for (i = 0; i < size; i++)
+    if (name[i] == '.')
+      for (j = 0; j < sizeof (lto_prefixes) / sizeof (lto_prefixes[0]); j++)
+	if (size - i >= lto_prefixes[j].len
+	    && memcmp (name + i, lto_prefixes[j].prefix,
+		       lto_prefixes[j].len) == 0)
+	  return true;
+  return false;
+}
+
+/* Return TRUE if NAME, the file name of a plugin, is that of GCC's
+   LTO plugin.  */
+
+static bool
+gcc_lto_plugin_name_p (const char *name)
+{
+  const char *base = lbasename (name);
+
+  return (startswith (base, "liblto_plugin")
+	  || startswith (base, "cyglto_plugin"));
+}
+
+/* Return TRUE if every plugin that would be asked to claim ABFD is
+   GCC's LTO plugin.  Only then can maybe_lto_object_p be trusted:
+   other plugins, such as LLVM's, may claim ELF files that have none
+   of the sections GCC puts LTO IR in.  */
+
+static bool
+gcc_lto_plugins_only (bfd *abfd)
+{
+  struct plugin_list_entry *plugin_list_iter;
+
+  if (plugin_name)
+    return gcc_lto_plugin_name_p (plugin_name);
+
+  if (plugin_program_name == NULL)
+    return true;
+
+  build_plugin_list (abfd);
+
+  for (plugin_list_iter = plugin_list;
+       plugin_list_iter;
+       plugin_list_iter = plugin_list_iter->next)
+    if (!gcc_lto_plugin_name_p (plugin_list_iter->plugin_name))
+      return false;
+
+  return true;
+}
+
+/* Return FALSE if ABFD certainly cannot be claimed by GCC's LTO
+   plugin, without asking it.  That is the case for ELF objects none
+   of whose section names look like LTO sections.  LLVM bitcode and
+   anything we cannot parse cheaply is left for the plugin to decide.  */
+
+static bool
+maybe_lto_object_p (bfd *abfd)
+{
+  unsigned char ehdr[64];
+  unsigned char *shdr = NULL;
+  char *names = NULL;
+  bool is64, big;
+  bfd_vma shoff, stroff;
+  bfd_size_type strsize;
+  unsigned int shentsize, shnum, shstrndx;
+  bool result = true;
+
+#define GET16(p) (big ? bfd_getb16 (p) : bfd_getl16 (p))
+#define GET32(p) (big ? bfd_getb32 (p) : bfd_getl32 (p))
+#define GET64(p) (big ? bfd_getb64 (p) : bfd_getl64 (p))
+#define GETWORD(p) (is64 ? GET64 (p) : GET32 (p))
+
+  if (bfd_seek (abfd, 0, SEEK_SET) != 0
+      || bfd_bread (ehdr, 52, abfd) != 52)
+    return true;
+
+  /* LLVM bitcode, raw or inside the bitcode wrapper.  */
+  if (memcmp (ehdr, "BC\xc0\xde", 4) == 0
+      || memcmp (ehdr, "\xde\xc0\x17\x0b", 4) == 0)
+    return true;
+
+  if (ehdr[EI_MAG0] != ELFMAG0
+      || ehdr[EI_MAG1] != ELFMAG1
+      || ehdr[EI_MAG2] != ELFMAG2
+      || ehdr[EI_MAG3] != ELFMAG3
+      || (ehdr[EI_CLASS] != ELFCLASS32 && ehdr[EI_CLASS] != ELFCLASS64)
+      || (ehdr[EI_DATA] != ELFDATA2LSB && ehdr[EI_DATA] != ELFDATA2MSB))
+    return true;
+
+  is64 = ehdr[EI_CLASS] == ELFCLASS64;
+  big = ehdr[EI_DATA] == ELFDATA2MSB;
+#ifndef BFD64
+  if (is64)
+    return true;
+#endif
+  if (is64 && bfd_bread (ehdr + 52, 12, abfd) != 12)
+    return true;
+
+  if (is64)
+    {
+      shoff = GET64 (ehdr + 40);
+      shentsize = GET16 (ehdr + 58);
+      shnum = GET16 (ehdr + 60);
+      shstrndx = GET16 (ehdr + 62);
+    }
+  else
+    {
+      shoff = GET32 (ehdr + 32);
+      shentsize = GET16 (ehdr + 46);
+      shnum = GET16 (ehdr + 48);
+      shstrndx = GET16 (ehdr + 50);
+    }
+  if (shoff == 0
+      || shentsize != (is64 ? 64 : 40)
+      || bfd_seek (abfd, shoff, SEEK_SET) != 0)
+    return true;
+
+  shdr = bfd_malloc (shentsize);
+  if (shdr == NULL || bfd_bread (shdr, shentsize, abfd) != shentsize)
+    goto out;
+
+  /* Extended section numbering keeps the real values in section 0,
+     with e_shnum zero and e_shstrndx SHN_XINDEX.  */
+  if (shnum == 0)
+    shnum = GETWORD (shdr + (is64 ? 32 : 20));
+  if (shstrndx == 0xffff)
+    shstrndx = GET32 (shdr + (is64 ? 40 : 24));
+  if (shstrndx == 0 || shstrndx >= shnum)
+    goto out;
+
+  if (bfd_seek (abfd, shoff + (bfd_vma) shstrndx * shentsize, SEEK_SET) != 0
+      || bfd_bread (shdr, shentsize, abfd) != shentsize)
+    goto out;
+  stroff = GETWORD (shdr + (is64 ? 24 : 16));
+  strsize = GETWORD (shdr + (is64 ? 32 : 20));
+  if (bfd_seek (abfd, stroff, SEEK_SET) != 0)
+    goto out;
+  names = (char *) _bfd_malloc_and_read (abfd, strsize, strsize);
+  if (names == NULL)
+    goto out;
+
+  result = lto_section_name_p (names, strsize);
+
+ out:
+  free (names);
+  free (shdr);
+  return result;
+
+#undef GET16
+#undef GET32
+#undef GET64
+#undef GETWORD
+}
+
+/* The identity of a file, or archive member, that no plugin claimed.  */
+
+struct plugin_unclaimed_entry
+{
+  dev_t dev;
+  ino_t ino;
+  time_t mtime;
+  off_t size;
+  ufile_ptr origin;
+};
+
+/* Files no plugin would claim, so that opening one again need not
+   consult the plugins again.  */
+static htab_t plugin_unclaimed_htab;
+
+static hashval_t
+plugin_unclaimed_hash (const void *p)
+{
+  return iterative_hash (p, sizeof (struct plugin_unclaimed_entry), 0);
+}
+
+static int
+plugin_unclaimed_eq (const void *a, const void *b)
+{
+  return memcmp (a, b, sizeof (struct plugin_unclaimed_entry)) == 0;
+}
+
+/* Fill in KEY for ABFD.  Return FALSE if ABFD cannot be identified.  */
+
+static bool
+plugin_unclaimed_key (bfd *abfd, struct plugin_unclaimed_entry *key)
+{
+  bfd *iobfd = abfd;
+  struct stat st;
+
+  while (iobfd->my_archive
+	 && !bfd_is_thin_archive (iobfd->my_archive))
+    iobfd = iobfd->my_archive;
+  if ((iobfd->flags & BFD_IN_MEMORY) != 0
+      || bfd_stat (iobfd, &st) != 0)
+    return false;
+
+  /* Clear any padding, since entries are hashed and compared whole.  */
+  memset (key, 0, sizeof (*key));
+  key->dev = st.st_dev;
+  key->ino = st.st_ino;
+  key->mtime = st.st_mtime;
+  key->size = st.st_size;
+  key->origin = abfd->origin;
+  return true;
+}
+
 static bfd_cleanup
 bfd_plugin_object_p (bfd *abfd)
 {
+  struct plugin_unclaimed_entry key;
+  bool have_key;
+
   if (ld_plugin_object_p)
     return ld_plugin_object_p (abfd);
 
-  if (abfd->plugin_format == bfd_plugin_unknown && !load_plugin (abfd))
-    return NULL;
+  if (abfd->plugin_format == bfd_plugin_unknown)
+    {
+      if (gcc_lto_plugins_only (abfd) && !maybe_lto_object_p (abfd))
+	return NULL;
+
+      have_key = plugin_unclaimed_key (abfd, &key);
+      if (have_key
+	  && plugin_unclaimed_htab != NULL
+	  && htab_find (plugin_unclaimed_htab, &key) != NULL)
+	return NULL;
+
+      if (!load_plugin (abfd))
+	{
+	  if (have_key && plugin_unclaimed_htab == NULL)
+	    plugin_unclaimed_htab = htab_try_create (16,
+						     plugin_unclaimed_hash,
+						     plugin_unclaimed_eq,
+						     free);
+	  if (have_key && plugin_unclaimed_htab != NULL)
+	    {
+	      void **slot = htab_find_slot (plugin_unclaimed_htab, &key,
+					    INSERT);
+
+	      if (slot != NULL && *slot == NULL)
+		{
+		  *slot = bfd_malloc (sizeof (key));
+		  if (*slot != NULL)
+		    memcpy (*slot, &key, sizeof (key));
+		  else
+		    htab_clear_slot (plugin_unclaimed_htab, slot);
+		}
+	    }
+	  return NULL;
+	}
+    }
 
   return abfd->plugin_format == bfd_plugin_yes ? _bfd_no_cleanup : NULL;
 }
@@ -32,11 +32,16 @@
 #include "bucomm.h"
 #include "arsup.h"
 #include "filenames.h"
+#include "hashtab.h"
 #include "binemul.h"
 #include "plugin-api.h"
 #include "plugin.h"
 #include "ansidecl.h"
 
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
 #ifdef __GO32___
 #define EXT_NAME_LEN 3		/* Bufflen of addition to name if it's MS-DOS.  */
 #else
@@ -122,6 +127,11 @@ enum operations
 static bfd **
 get_pos_bfd (bfd **, enum pos, const char *);
 
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+static void
+extract_members_in_parallel (bfd *, char **, int);
+#endif
+
 /* For extract/delete only.  If COUNTED_NAME_MODE is TRUE, we only
    extract the COUNTED_NAME_COUNTER instance of that name.  */
 static bool counted_name_mode = 0;
@@ -143,6 +153,12 @@ static bool make_thin_archive = false;
 static char * libdeps = NULL;
 static bfd *  libdeps_bfd = NULL;
 
+/* The number of processes that may extract members at the same time.  */
+static int ar_jobs = 1;
+
+/* Whether open_output_file warns about member names it changes.  */
+static bool warn_member_names = true;
+
 static int show_version = 0;
 
 static int show_help = 0;
@@ -159,7 +175,8 @@ enum long_option_numbers
 {
   OPTION_PLUGIN = 201,
   OPTION_TARGET,
-  OPTION_OUTPUT
+  OPTION_OUTPUT,
+  OPTION_JOBS
 };
 
 static const char * output_dir = NULL;
@@ -171,6 +188,7 @@ static struct option long_options[] =
   {"target", required_argument, NULL, OPTION_TARGET},
   {"version", no_argument, &show_version, 1},
   {"output", required_argument, NULL, OPTION_OUTPUT},
+  {"jobs", required_argument, NULL, OPTION_JOBS},
   {"record-libdeps", required_argument, NULL, 'l'},
   {"thin", no_argument, NULL, 'T'},
   {NULL, no_argument, NULL, 0}
@@ -185,6 +203,28 @@ mri_emul (void)
   yyparse ();
 }
 
+/* The members of an archive with the same name, in archive order.  */
+
+struct member_name
+{
+  const char *name;
+  /* Indices of the first and last such member.  */
+  size_t first, last;
+};
+
+static hashval_t
+member_name_hash (const void *p)
+{
+  return filename_hash (((const struct member_name *) p)->name);
+}
+
+static int
+member_name_eq (const void *p1, const void *p2)
+{
+  return filename_eq (((const struct member_name *) p1)->name,
+		      ((const struct member_name *) p2)->name);
+}
+
 /* If COUNT is 0, then FUNCTION is called once on each entry.  If nonzero,
    COUNT is the length of the FILES chain; FUNCTION is called on each entry
    whose name matches one in FILES.  */
@@ -194,6 +234,10 @@ map_over_members (bfd *arch, void (*function)(bfd *), char **files, int count)
 {
   bfd *head;
   int match_count;
+  bfd **members;
+  size_t *next_same;
+  size_t nmembers, i;
+  htab_t names;
 
   if (count == 0)
     {
@@ -209,21 +253,75 @@ map_over_members (bfd *arch, void (*function)(bfd *), char **files, int count)
      However we have to iterate over the filenames in order to notice where
      a filename is requested but does not exist in the archive.  Ditto
      mapping over each file each time -- we want to hack multiple
-     references.  */
+     references.  To avoid searching the whole archive for each of
+     them, the members are first chained together by name.  */
 
+  nmembers = 0;
   for (head = arch->archive_next; head; head = head->archive_next)
-    head->archive_pass = 0;
+    {
+      head->archive_pass = 0;
+      nmembers++;
+    }
+
+  members = (bfd **) xmalloc (nmembers * sizeof (*members) + 1);
+  next_same = (size_t *) xmalloc (nmembers * sizeof (*next_same) + 1);
+  names = htab_create_alloc (nmembers, member_name_hash, member_name_eq,
+			     free, xcalloc, free);
+
+  for (i = 0, head = arch->archive_next; head; i++, head = head->archive_next)
+    {
+      const char * filename;
+      struct member_name key, **slot;
+
+      PROGRESS (1);
+      members[i] = head;
+      next_same[i] = nmembers;
+
+      filename = bfd_get_filename (head);
+      if (filename == NULL)
+	{
+	  /* Some archive formats don't get the filenames filled in
+	     until the elements are opened.  */
+	  struct stat buf;
+	  bfd_stat_arch_elt (head, &buf);
+	  filename = bfd_get_filename (head);
+	  if (filename == NULL)
+	    continue;
+	}
+      else if (bfd_is_thin_archive (arch))
+	{
+	  /* Thin archives store full pathnames.  Need to normalize.  */
+	  filename = normalize (filename, arch);
+	}
+
+      key.name = filename;
+      slot = (struct member_name **) htab_find_slot (names, &key, INSERT);
+      if (*slot == NULL)
+	{
+	  *slot = (struct member_name *) xmalloc (sizeof (**slot));
+	  (*slot)->name = filename;
+	  (*slot)->first = i;
+	}
+      else
+	next_same[(*slot)->last] = i;
+      (*slot)->last = i;
+    }
 
   for (; count > 0; files++, count--)
     {
       bool found = false;
+      struct member_name key, *ent;
+
+      key.name = normalize (*files, arch);
+      ent = (struct member_name *) htab_find (names, &key);
 
       match_count = 0;
-      for (head = arch->archive_next; head; head = head->archive_next)
+      for (i = ent != NULL ? ent->first : nmembers;
+	   i < nmembers;
+	   i = next_same[i])
 	{
-	  const char * filename;
+	  head = members[i];
 
-	  PROGRESS (1);
 	  /* PR binutils/15796: Once an archive element has been matched
 	     do not match it again.  If the user provides multiple same-named
 	     parameters on the command line their intent is to match multiple
@@ -232,50 +330,36 @@ map_over_members (bfd *arch, void (*function)(bfd *), char **files, int count)
 	  if (head->archive_pass)
 	    continue;
 
-	  filename = bfd_get_filename (head);
-	  if (filename == NULL)
-	    {
-	      /* Some archive formats don't get the filenames filled in
-		 until the elements are opened.  */
-	      struct stat buf;
-	      bfd_stat_arch_elt (head, &buf);
-	    }
-	  else if (bfd_is_thin_archive (arch))
+	  ++match_count;
+	  if (counted_name_mode
+	      && match_count != counted_name_counter)
 	    {
-	      /* Thin archives store full pathnames.  Need to normalize.  */
-	      filename = normalize (filename, arch);
+	      /* Counting, and didn't match on count; go on to the
+		 next one.  */
+	      continue;
 	    }
 
-	  if (filename != NULL
-	      && !FILENAME_CMP (normalize (*files, arch), filename))
-	    {
-	      ++match_count;
-	      if (counted_name_mode
-		  && match_count != counted_name_counter)
-		{
-		  /* Counting, and didn't match on count; go on to the
-                     next one.  */
-		  continue;
-		}
-
-	      found = true;
-	      function (head);
-	      head->archive_pass = 1;
-	      /* PR binutils/15796: Once a file has been matched, do not
-		 match any more same-named files in the archive.  If the
-		 user does want to match multiple same-name files in an
-		 archive they should provide multiple same-name parameters
-		 to the ar command.  */
-	      break;
-	    }
+	  found = true;
+	  function (head);
+	  head->archive_pass = 1;
+	  /* PR binutils/15796: Once a file has been matched, do not
+	     match any more same-named files in the archive.  If the
+	     user does want to match multiple same-name files in an
+	     archive they should provide multiple same-name parameters
+	     to the ar command.  */
+	  break;
 	}
 
       if (!found)
 	/* xgettext:c-format */
 	fprintf (stderr, _("no entry %s in archive\n"), *files);
     }
+
+  htab_delete (names);
+  free (next_same);
+  free (members);
 }
-
+
 bool operation_alters_arch = false;
 
 static void
@@ -346,6 +430,7 @@ usage (int help)
   fprintf (s, _("  --output=DIRNAME - specify the output directory for extraction operations\n"));
   fprintf (s, _("  --record-libdeps=<text> - specify the dependencies of this library\n"));
   fprintf (s, _("  --thin       - make a thin archive\n"));
+  fprintf (s, _("  --jobs=<number> - extract up to <number> members at the same time\n"));
 #if BFD_SUPPORTS_PLUGINS
   fprintf (s, _(" optional:\n"));
   fprintf (s, _("  --plugin <p> - load the specified plugin\n"));
@@ -617,6 +702,19 @@ decode_options (int argc, char **argv)
 	case OPTION_OUTPUT:
 	  output_dir = optarg;
 	  break;
+	case OPTION_JOBS:
+	  {
+	    char *end;
+	    long jobs;
+
+	    errno = 0;
+	    jobs = strtol (optarg, &end, 0);
+	    if (end == optarg || *end != '\0' || errno != 0
+		|| jobs < 1 || jobs > INT_MAX)
+	      fatal (_("%s: invalid number of jobs"), optarg);
+	    ar_jobs = jobs;
+	  }
+	  break;
 	case 0:		/* A long option that just sets a flag.  */
 	  break;
         default:
@@ -843,6 +941,9 @@ main (int argc, char **argv)
 	    fatal (_("Value for `N' must be positive."));
 	}
 
+      if (ar_jobs > 1 && operation != extract)
+	fatal (_("`--jobs' is only meaningful with the `x' option."));
+
       inarch_filename = argv[arg_index++];
       if (inarch_filename == NULL)
 	usage (0);
@@ -917,6 +1018,13 @@ main (int argc, char **argv)
 	  break;
 
 	case extract:
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+	  if (ar_jobs > 1)
+	    {
+	      extract_members_in_parallel (arch, files, file_count);
+	      break;
+	    }
+#endif
 	  map_over_members (arch, extract_file, files, file_count);
 	  break;
 
@@ -1119,23 +1227,24 @@ print_contents (bfd *abfd)
 }
 
 
-static FILE * open_output_file (bfd *) ATTRIBUTE_RETURNS_NONNULL;
+/* Return the name of the file to which member ABFD is extracted.  */
 
-static FILE *
-open_output_file (bfd * abfd)
+static const char *
+member_output_name (bfd *abfd)
 {
-  output_filename = bfd_get_filename (abfd);
+  const char *name = bfd_get_filename (abfd);
 
   /* PR binutils/17533: Do not allow directory traversal
      outside of the current directory tree - unless the
      user has explicitly specified an output directory.  */
-  if (! is_valid_archive_path (output_filename))
+  if (! is_valid_archive_path (name))
     {
-      char * base = (char *) lbasename (output_filename);
+      const char *base = lbasename (name);
 
-      non_fatal (_("illegal output pathname for archive member: %s, using '%s' instead"),
-		 output_filename, base);
-      output_filename = base;
+      if (warn_member_names)
+	non_fatal (_("illegal output pathname for archive member: %s, using '%s' instead"),
+		   name, base);
+      name = base;
     }
 
   if (output_dir)
@@ -1146,12 +1255,22 @@ open_output_file (bfd * abfd)
 	{
 	  /* FIXME: There is a memory leak here, but it is not serious.  */
 	  if (IS_DIR_SEPARATOR (output_dir [len - 1]))
-	    output_filename = concat (output_dir, output_filename, NULL);
+	    name = concat (output_dir, name, NULL);
 	  else
-	    output_filename = concat (output_dir, "/", output_filename, NULL);
+	    name = concat (output_dir, "/", name, NULL);
 	}
     }
 
+  return name;
+}
+
+static FILE * open_output_file (bfd *) ATTRIBUTE_RETURNS_NONNULL;
+
+static FILE *
+open_output_file (bfd * abfd)
+{
+  output_filename = member_output_name (abfd);
+
   if (verbose)
     printf ("x - %s\n", output_filename);
 
@@ -1248,6 +1367,137 @@ extract_file (bfd *abfd)
   output_filename = NULL;
 }
 
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+
+/* The members collected by add_member_to_extract.  */
+static bfd **members_to_extract;
+static size_t members_to_extract_count;
+static size_t members_to_extract_max;
+
+static void
+add_member_to_extract (bfd *abfd)
+{
+  if (members_to_extract_count == members_to_extract_max)
+    {
+      members_to_extract_max = (members_to_extract_max == 0
+				? 64 : members_to_extract_max * 2);
+      members_to_extract
+	= (bfd **) xrealloc (members_to_extract,
+			     members_to_extract_max * sizeof (bfd *));
+    }
+  members_to_extract[members_to_extract_count++] = abfd;
+}
+
+/* Extract the members of ARCH that map_over_members would pass for
+   FILES and COUNT, spread over up to AR_JOBS child processes.  The
+   members that would be written to files of the same base name are
+   all extracted by one child, in archive order, so the last of them
+   still wins.  Names are reported here, in archive order, before any
+   member is extracted.  */
+
+static void
+extract_members_in_parallel (bfd *arch, char **files, int count)
+{
+  size_t n, i;
+  int *member_job;
+  pid_t *pids;
+  int jobs, j;
+  bool failed = false;
+
+  map_over_members (arch, add_member_to_extract, files, count);
+  n = members_to_extract_count;
+  if (n == 0)
+    return;
+
+  jobs = ar_jobs;
+  if ((size_t) jobs > n)
+    jobs = n;
+  member_job = (int *) xmalloc (n * sizeof (*member_job));
+  for (i = 0; i < n; i++)
+    {
+      bfd *abfd = members_to_extract[i];
+      struct stat buf;
+      const char *name;
+
+      /* Some archive formats only fill in the names of their
+	 members once they are examined.  */
+      if (bfd_stat_arch_elt (abfd, &buf) != 0)
+	/* xgettext:c-format */
+	fatal (_("internal stat error on %s"), bfd_get_filename (abfd));
+      name = member_output_name (abfd);
+      if (verbose)
+	printf ("x - %s\n", name);
+      member_job[i] = filename_hash (lbasename (name)) % jobs;
+    }
+  verbose = 0;
+  warn_member_names = false;
+
+  fflush (stdout);
+  fflush (stderr);
+  pids = (pid_t *) xmalloc (jobs * sizeof (*pids));
+  for (j = 0; j < jobs; j++)
+    {
+      pids[j] = fork ();
+      if (pids[j] == 0)
+	{
+	  /* Reopen the archive, so as not to share a file offset with
+	     the other processes.  */
+	  bfd_cache_close_all ();
+	  for (i = 0; i < n; i++)
+	    if (member_job[i] == j)
+	      extract_file (members_to_extract[i]);
+	  fflush (stdout);
+	  fflush (stderr);
+	  _exit (0);
+	}
+    }
+
+  for (j = 0; j < jobs; j++)
+    {
+      int wstatus;
+      pid_t pid;
+
+      if (pids[j] == -1)
+	{
+	  /* Do the job here instead.  */
+	  bfd_cache_close_all ();
+	  for (i = 0; i < n; i++)
+	    if (member_job[i] == j)
+	      extract_file (members_to_extract[i]);
+	  continue;
+	}
+
+      /* A signal such as SIGCHLD or SIGWINCH may interrupt the wait.  */
+      do
+	pid = waitpid (pids[j], &wstatus, 0);
+      while (pid == -1 && errno == EINTR);
+      if (pid != pids[j])
+	{
+	  non_fatal (_("%s: could not wait for child process: %s"),
+		     bfd_get_filename (arch), strerror (errno));
+	  failed = true;
+	}
+      else if (WIFSIGNALED (wstatus))
+	{
+	  non_fatal (_("%s: child process got fatal signal %d"),
+		     bfd_get_filename (arch), WTERMSIG (wstatus));
+	  failed = true;
+	}
+      else if (!WIFEXITED (wstatus) || WEXITSTATUS (wstatus) != 0)
+	failed = true;
+    }
+
+  free (pids);
+  free (member_job);
+  free (members_to_extract);
+  members_to_extract = NULL;
+  members_to_extract_count = members_to_extract_max = 0;
+  if (failed)
+    xexit (1);
+}
+
+#endif /* HAVE_FORK && HAVE_SYS_WAIT_H */
+
 static void
 write_archive (bfd *iarch)
 {
@@ -1315,6 +1565,110 @@ write_archive (bfd *iarch)
   free (new_name);
 }
 
+#ifdef HAVE_FTRUNCATE
+
+/* Add the members from NEW_HEAD on, which follow the original members
+   of IARCH, by writing them at the end of the archive file in place
+   rather than rewriting the whole archive.  If the new members add
+   symbols to the symbol map, the map is rewritten in place too, which
+   may move the original members up within the file; see
+   bfd_append_to_archive.  The archive then holds the same members and
+   symbols as write_archive would give, though the map may be padded.
+   Return false if the archive has to be rewritten after all.
+
+   Unlike write_archive, which builds the new archive in a temporary
+   file first, this changes the archive directly.  If appending fails
+   before any original member is moved, the archive is cut back to its
+   old size.  If ar is killed part way, or fails while members are
+   being moved, the archive can be left damaged.  */
+
+static bool
+append_archive (bfd *iarch, bfd *new_head)
+{
+  const char *name = bfd_get_filename (iarch);
+  struct stat buf;
+  bfd *abfd;
+  int fd, old_fd;
+  bool ok;
+
+  /* An archive with no members costs nothing to write in full, and
+     gets a map without padding.  */
+  if (bfd_is_thin_archive (iarch)
+      || make_thin_archive
+      || iarch->archive_next == new_head)
+    return false;
+
+  fd = open (name, O_RDWR | O_BINARY, 0);
+  if (fd < 0)
+    return false;
+  old_fd = dup (fd);
+  if (old_fd < 0 || fstat (fd, &buf) != 0)
+    {
+      if (old_fd >= 0)
+	close (old_fd);
+      close (fd);
+      return false;
+    }
+  abfd = bfd_fdopenr (name, bfd_get_target (iarch), fd);
+  if (abfd == NULL)
+    {
+      close (old_fd);
+      return false;
+    }
+  if (! bfd_check_format (abfd, bfd_archive))
+    {
+      bfd_close_all_done (abfd);
+      close (old_fd);
+      return false;
+    }
+
+  if (ar_truncate)
+    abfd->flags |= BFD_TRADITIONAL_FORMAT;
+  if (deterministic)
+    abfd->flags |= BFD_DETERMINISTIC_OUTPUT;
+  if (full_pathname)
+    abfd->flags |= BFD_ARCHIVE_FULL_PATH;
+
+  ok = bfd_append_to_archive (abfd, new_head, write_armap >= 0);
+  if (! ok && bfd_get_error () == bfd_error_invalid_operation)
+    {
+      bfd_close_all_done (abfd);
+      close (old_fd);
+      return false;
+    }
+  if (! ok)
+    bfd_nonfatal (name);
+
+  /* bfd_close would write out the archive contents.  */
+  if (! bfd_close_all_done (abfd) && ok)
+    {
+      bfd_nonfatal (name);
+      ok = false;
+    }
+
+  if (! ok)
+    {
+      if (ftruncate (old_fd, buf.st_size) != 0)
+	non_fatal (_("%s: cannot restore the archive's old size: %s"),
+		   name, strerror (errno));
+      xexit (1);
+    }
+
+  close (old_fd);
+  output_filename = NULL;
+  return true;
+}
+
+#else /* ! HAVE_FTRUNCATE */
+
+static bool
+append_archive (bfd *iarch ATTRIBUTE_UNUSED, bfd *new_head ATTRIBUTE_UNUSED)
+{
+  return false;
+}
+
+#endif /* HAVE_FTRUNCATE */
+
 /* Return a pointer to the pointer to the entry which should be rplacd'd
    into when altering.  DEFAULT_POS should be how to interpret pos_default,
    and should be a pos value.  */
@@ -1476,9 +1830,14 @@ static void
 replace_members (bfd *arch, char **files_to_move, bool quick)
 {
   bool changed = false;
+  bool appended_only = postype == pos_default;
   bfd **after_bfd;		/* New entries go after this one.  */
   bfd *current;
   bfd **current_ptr;
+  bfd **tail;			/* End of the original members.  */
+
+  for (tail = &arch->archive_next; *tail; tail = &(*tail)->archive_next)
+    continue;
 
   while (files_to_move && *files_to_move)
     {
@@ -1534,6 +1893,7 @@ replace_members (bfd *arch, char **files_to_move, bool quick)
 		      /* Snip out this entry from the chain.  */
 		      *current_ptr = (*current_ptr)->archive_next;
 		      changed = true;
+		      appended_only = false;
 		    }
 
 		  goto next_file;
@@ -1563,7 +1923,12 @@ replace_members (bfd *arch, char **files_to_move, bool quick)
     }
 
   if (changed)
-    write_archive (arch);
+    {
+      /* Adding members to the end of a large archive should not cost
+	 as much as rewriting it.  */
+      if (! appended_only || ! append_archive (arch, *tail))
+	write_archive (arch);
+    }
   else
     output_filename = NULL;
 }
@@ -866,19 +866,8 @@ static asymbol *sort_y;
    specially -- i.e., their sizes are used as their "values".  */
 
 static int
-non_numeric_forward (const void *P_x, const void *P_y)
+compare_symbol_names (const char *xn, const char *yn)
 {
-  asymbol *x, *y;
-  const char *xn, *yn;
-
-  x = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_x, sort_x);
-  y = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_y, sort_y);
-  if (x == NULL || y == NULL)
-    bfd_fatal (bfd_get_filename (sort_bfd));
-
-  xn = bfd_asymbol_name (x);
-  yn = bfd_asymbol_name (y);
-
   if (yn == NULL)
     return xn != NULL;
   if (xn == NULL)
@@ -894,6 +883,19 @@ non_numeric_forward (const void *P_x, const void *P_y)
   return strcoll (xn, yn);
 }
 
+static int
+non_numeric_forward (const void *P_x, const void *P_y)
+{
+  asymbol *x, *y;
+
+  x = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_x, sort_x);
+  y = bfd_minisymbol_to_symbol (sort_bfd, sort_dynamic, P_y, sort_y);
+  if (x == NULL || y == NULL)
+    bfd_fatal (bfd_get_filename (sort_bfd));
+
+  return compare_symbol_names (bfd_asymbol_name (x), bfd_asymbol_name (y));
+}
+
 static int
 non_numeric_reverse (const void *x, const void *y)
 {
@@ -939,6 +941,134 @@ static int (*(sorters[2][2])) (const void *, const void *) =
   { numeric_forward, numeric_reverse }
 };
 
+/* What the name and numeric sorts look at in a symbol, taken from it
+   once by sort_minisyms rather than on every comparison.  Converting an
+   ELF minisymbol to a symbol costs far more than comparing two keys;
+   sorting a million of them in place with sorters takes about three
+   times as long as building and sorting these keys.  */
+
+struct sort_key
+{
+  const char *name;
+  bfd_vma value;
+  bool undefined;
+  long index;
+};
+
+static int
+key_non_numeric_forward (const void *P_x, const void *P_y)
+{
+  const struct sort_key *x = (const struct sort_key *) P_x;
+  const struct sort_key *y = (const struct sort_key *) P_y;
+
+  return compare_symbol_names (x->name, y->name);
+}
+
+static int
+key_non_numeric_reverse (const void *x, const void *y)
+{
+  return - key_non_numeric_forward (x, y);
+}
+
+static int
+key_numeric_forward (const void *P_x, const void *P_y)
+{
+  const struct sort_key *x = (const struct sort_key *) P_x;
+  const struct sort_key *y = (const struct sort_key *) P_y;
+
+  if (x->undefined)
+    {
+      if (! y->undefined)
+	return -1;
+    }
+  else if (y->undefined)
+    return 1;
+  else if (x->value != y->value)
+    return x->value < y->value ? -1 : 1;
+
+  return key_non_numeric_forward (P_x, P_y);
+}
+
+static int
+key_numeric_reverse (const void *x, const void *y)
+{
+  return - key_numeric_forward (x, y);
+}
+
+static int (*(key_sorters[2][2])) (const void *, const void *) =
+{
+  { key_non_numeric_forward, key_non_numeric_reverse },
+  { key_numeric_forward, key_numeric_reverse }
+};
+
+/* Sort the SYMCOUNT minisymbols of SIZE bytes each in MINISYMS by name
+   or by value, in the same order as sorters would.  */
+
+static void
+sort_minisyms (bfd *abfd, bool is_dynamic, void *minisyms, long symcount,
+	       unsigned int size)
+{
+  struct sort_key *keys;
+  bfd_byte *base = (bfd_byte *) minisyms;
+  bfd_byte *tmp;
+  asymbol *sym;
+  long i;
+
+  if (symcount < 2)
+    return;
+
+  /* Minisymbols which are pointers to symbols BFD already holds, rather
+     than being converted into the symbol passed in, are as cheap to
+     compare directly.  */
+  sym = bfd_minisymbol_to_symbol (abfd, is_dynamic, base, sort_x);
+  if (sym == NULL)
+    bfd_fatal (bfd_get_filename (abfd));
+  if (sym != sort_x)
+    {
+      qsort (minisyms, symcount, size,
+	     sorters[sort_numerically][reverse_sort]);
+      return;
+    }
+
+  keys = (struct sort_key *) xmalloc (symcount * sizeof (*keys));
+  for (i = 0; i < symcount; i++)
+    {
+      sym = bfd_minisymbol_to_symbol (abfd, is_dynamic, base + i * size,
+				      sort_x);
+      if (sym == NULL)
+	bfd_fatal (bfd_get_filename (abfd));
+      keys[i].name = bfd_asymbol_name (sym);
+      keys[i].undefined = bfd_is_und_section (bfd_asymbol_section (sym));
+      keys[i].value = valueof (sym);
+      keys[i].index = i;
+    }
+
+  qsort (keys, symcount, sizeof (*keys),
+	 key_sorters[sort_numerically][reverse_sort]);
+
+  /* Move the minisymbols into the sorted order one cycle of the
+     permutation at a time, marking each slot filled with an index of
+     -1, so that no second array of minisymbols is needed.  */
+  tmp = (bfd_byte *) xmalloc (size);
+  for (i = 0; i < symcount; i++)
+    {
+      long j, k;
+
+      if (keys[i].index < 0)
+	continue;
+      memcpy (tmp, base + i * size, size);
+      for (j = i; (k = keys[j].index) != i; j = k)
+	{
+	  memcpy (base + j * size, base + k * size, size);
+	  keys[j].index = -1;
+	}
+      memcpy (base + j * size, tmp, size);
+      keys[j].index = -1;
+    }
+  free (tmp);
+  free (keys);
+}
+
 /* This sort routine is used by sort_symbols_by_size.  It is similar
    to numeric_forward, but when symbols have the same value it sorts
    by section VMA.  This simplifies the sort_symbols_by_size code
@@ -1519,8 +1649,7 @@ display_rel_file (bfd *abfd, bfd *archive_bfd)
 	bfd_fatal (bfd_get_filename (abfd));
 
       if (! sort_by_size)
-	qsort (minisyms, symcount, size,
-	       sorters[sort_numerically][reverse_sort]);
+	sort_minisyms (abfd, dynamic, minisyms, symcount, size);
       else
 	symcount = sort_symbols_by_size (abfd, dynamic, minisyms, symcount,
 					 size, &symsizes);
@@ -1669,6 +1798,10 @@ display_file (char *filename)
   if (line_numbers)
     file->flags |= BFD_DECOMPRESS;
 
+  /* Synthetic symbols can only be added to canonical symbols.  */
+  if (show_synthetic)
+    file->flags |= BFD_CANONICAL_MINISYMS;
+
   if (bfd_check_format (file, bfd_archive))
     {
       display_archive (file);
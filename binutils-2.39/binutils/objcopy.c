@@ -31,12 +31,22 @@
 #include "coff/internal.h"
 #include "libcoff.h"
 #include "safe-ctype.h"
+#include "sha1.h"
+#include "sha256.h"
 
 /* FIXME: See bfd/peXXigen.c for why we include an architecture specific
    header in generic PE code.  */
 #include "coff/i386.h"
 #include "coff/pe.h"
 
+#ifdef HAVE_SYS_WAIT_H
+#include <sys/wait.h>
+#endif
+
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
+
 static bfd_vma pe_file_alignment = (bfd_vma) -1;
 static bfd_vma pe_heap_commit = (bfd_vma) -1;
 static bfd_vma pe_heap_reserve = (bfd_vma) -1;
@@ -96,6 +106,7 @@ static bool verbose;		/* Print file and target names.  */
 static bool preserve_dates;	/* Preserve input file timestamp.  */
 static int deterministic = -1;		/* Enable deterministic archives.  */
 static int status = 0;			/* Exit status.  */
+static int strip_jobs = 1;		/* Number of files strip may process at once.  */
 
 static bool    merge_notes = false;	/* Merge note sections.  */
 
@@ -221,6 +232,42 @@ static struct section_add *dump_sections;
    This should be the filename to store in the .gnu_debuglink section.  */
 static const char * gnu_debuglink_filename = NULL;
 
+/* If non-NULL, the directory in which to store the OmniBOR Document files
+   of the output files (from --omnibor=<dir> or the OMNIBOR_DIR environment
+   variable).  */
+static const char *omnibor_dir = NULL;
+
+/* The '.note.omnibor' section of the input file being copied whose
+   contents are replaced by omnibor_note_contents in the output, if any.  */
+static asection *omnibor_input_section = NULL;
+static bfd_byte *omnibor_note_contents = NULL;
+
+#define GITOID_LENGTH_SHA1 20
+#define GITOID_LENGTH_SHA256 32
+
+/* If the output of the object being copied has no '.note.omnibor' section
+   to refer to its new OmniBOR Documents, their gitoids, which are recorded
+   in the mapping once the output file is complete.  */
+static bool omnibor_output_needs_mapping = false;
+static unsigned char omnibor_output_doc_sha1[GITOID_LENGTH_SHA1];
+static unsigned char omnibor_output_doc_sha256[GITOID_LENGTH_SHA256];
+
+/* The whole of the input file being copied, when OmniBOR information is
+   being recorded.  The input BFD reads from this image rather than from
+   the file, so that the gitoids of the input, or of its members, can be
+   calculated without reading the file again.  */
+
+struct omnibor_image
+{
+  bfd *abfd;
+  bfd_byte *data;
+  size_t size;
+  bool mapped;
+  struct stat st;
+};
+
+static struct omnibor_image omnibor_input;
+
 /* Whether to convert debugging information.  */
 static bool convert_debugging = false;
 
@@ -333,6 +380,7 @@ enum command_line_switch
   OPTION_IMAGE_BASE,
   OPTION_IMPURE,
   OPTION_INTERLEAVE_WIDTH,
+  OPTION_JOBS,
   OPTION_KEEPGLOBAL_SYMBOLS,
   OPTION_KEEP_FILE_SYMBOLS,
   OPTION_KEEP_SECTION,
@@ -344,6 +392,7 @@ enum command_line_switch
   OPTION_MERGE_NOTES,
   OPTION_NO_MERGE_NOTES,
   OPTION_NO_CHANGE_WARNINGS,
+  OPTION_OMNIBOR,
   OPTION_ONLY_KEEP_DEBUG,
   OPTION_PAD_TO,
   OPTION_PREFIX_ALLOC_SECTIONS,
@@ -390,12 +439,14 @@ static struct option strip_options[] =
   {"info", no_argument, 0, OPTION_FORMATS_INFO},
   {"input-format", required_argument, 0, 'I'}, /* Obsolete */
   {"input-target", required_argument, 0, 'I'},
+  {"jobs", required_argument, 0, OPTION_JOBS},
   {"keep-section-symbols", no_argument, 0, OPTION_KEEP_SECTION_SYMBOLS},
   {"keep-file-symbols", no_argument, 0, OPTION_KEEP_FILE_SYMBOLS},
   {"keep-section", required_argument, 0, OPTION_KEEP_SECTION},
   {"keep-symbol", required_argument, 0, 'K'},
   {"merge-notes", no_argument, 0, 'M'},
   {"no-merge-notes", no_argument, 0, OPTION_NO_MERGE_NOTES},
+  {"omnibor", required_argument, 0, OPTION_OMNIBOR},
   {"only-keep-debug", no_argument, 0, OPTION_ONLY_KEEP_DEBUG},
   {"output-file", required_argument, 0, 'o'},
   {"output-format", required_argument, 0, 'O'},	/* Obsolete */
@@ -476,6 +527,7 @@ static struct option copy_options[] =
   {"no-merge-notes", no_argument, 0, OPTION_NO_MERGE_NOTES},
   {"no-adjust-warnings", no_argument, 0, OPTION_NO_CHANGE_WARNINGS},
   {"no-change-warnings", no_argument, 0, OPTION_NO_CHANGE_WARNINGS},
+  {"omnibor", required_argument, 0, OPTION_OMNIBOR},
   {"only-keep-debug", no_argument, 0, OPTION_ONLY_KEEP_DEBUG},
   {"only-section", required_argument, 0, 'j'},
   {"output-format", required_argument, 0, 'O'},	/* Obsolete */
@@ -585,6 +637,7 @@ copy_usage (FILE *stream, int exit_status)
   fprintf (stream, _("\
   -j --only-section <name>         Only copy section <name> into the output\n\
      --add-gnu-debuglink=<file>    Add section .gnu_debuglink linking to <file>\n\
+     --omnibor=<dir>               Store the OmniBOR information in <dir>\n\
   -R --remove-section <name>       Remove section <name> from the output\n\
      --remove-relocations <name>   Remove relocations from section <name>\n\
   -S --strip-all                   Remove all symbol and relocation information\n\
@@ -730,6 +783,7 @@ strip_usage (FILE *stream, int exit_status)
      --strip-dwo                   Remove all DWO sections\n\
      --strip-unneeded              Remove all symbols not needed by relocations\n\
      --only-keep-debug             Strip everything but the debug information\n\
+     --omnibor=<dir>               Store the OmniBOR information in <dir>\n\
   -M  --merge-notes                Remove redundant entries in note sections (default)\n\
       --no-merge-notes             Do not attempt to remove redundant notes\n\
   -N --strip-symbol=<name>         Do not copy symbol <name>\n\
@@ -744,6 +798,7 @@ strip_usage (FILE *stream, int exit_status)
   -V --version                     Display this program's version number\n\
   -h --help                        Display this output\n\
      --info                        List object formats & architectures supported\n\
+     --jobs=<number>               Strip up to <number> files at the same time\n\
   -o <file>                        Place stripped output into <file>\n\
 "));
 
@@ -2590,6 +2645,867 @@ check_new_section_flags (flagword flags, bfd * abfd, const char * secname)
   return flags;
 }
 
+/* Write the hexadecimal form of the LEN byte gitoid GITOID to BUF.  */
+
+static void
+omnibor_gitoid_to_hex (const unsigned char *gitoid, unsigned int len,
+		       char *buf)
+{
+  static const char lut[] = "0123456789abcdef";
+  unsigned int i;
+
+  for (i = 0; i < len; i++)
+    {
+      buf[2 * i] = lut[gitoid[i] >> 4];
+      buf[2 * i + 1] = lut[gitoid[i] & 15];
+    }
+  buf[2 * len] = '\0';
+}
+
+/* Return the directory in which OmniBOR information is recorded, from
+   --omnibor=<dir> or the OMNIBOR_DIR environment variable, or NULL.  */
+
+static const char *
+omnibor_directory (void)
+{
+  const char *dir = omnibor_dir;
+
+  if (dir == NULL)
+    dir = getenv ("OMNIBOR_DIR");
+  if (dir == NULL || *dir == '\0')
+    return NULL;
+  return dir;
+}
+
+/* Read LEN bytes at POS in the file open on FD into BUF.  */
+
+static bool
+omnibor_read_at (int fd, off_t pos, void *buf, size_t len)
+{
+  char *p = (char *) buf;
+
+  if (lseek (fd, pos, SEEK_SET) != pos)
+    return false;
+  while (len != 0)
+    {
+      ssize_t n = read (fd, p, len);
+
+      if (n < 0 && errno == EINTR)
+	continue;
+      if (n <= 0)
+	return false;
+      p += n;
+      len -= n;
+    }
+  return true;
+}
+
+static void *
+omnibor_image_open (bfd *abfd ATTRIBUTE_UNUSED, void *closure)
+{
+  return closure;
+}
+
+static file_ptr
+omnibor_image_pread (bfd *abfd ATTRIBUTE_UNUSED, void *stream, void *buf,
+		     file_ptr nbytes, file_ptr offset)
+{
+  struct omnibor_image *image = (struct omnibor_image *) stream;
+
+  if (offset < 0 || nbytes < 0)
+    return -1;
+  if ((ufile_ptr) offset >= image->size)
+    return 0;
+  if ((ufile_ptr) nbytes > image->size - offset)
+    nbytes = image->size - offset;
+  memcpy (buf, image->data + offset, nbytes);
+  return nbytes;
+}
+
+static int
+omnibor_image_close (bfd *abfd, void *stream)
+{
+  struct omnibor_image *image = (struct omnibor_image *) stream;
+
+  /* Archive members share the stream of their archive, and are closed
+     before it.  */
+  if (abfd != image->abfd)
+    return 0;
+
+#ifdef HAVE_MMAP
+  if (image->mapped)
+    munmap (image->data, image->size);
+  else
+#endif
+    free (image->data);
+  image->abfd = NULL;
+  image->data = NULL;
+  return 0;
+}
+
+static int
+omnibor_image_stat (bfd *abfd ATTRIBUTE_UNUSED, void *stream,
+		    struct stat *sb)
+{
+  *sb = ((struct omnibor_image *) stream)->st;
+  return 0;
+}
+
+/* Open FILENAME for reading as a BFD of TARGET, like bfd_openr.  If
+   OmniBOR information is being recorded, the BFD reads from an image of
+   the whole file in omnibor_input, mapped into memory where possible.
+   If the image cannot be made, the file is read as usual.  */
+
+static bfd *
+omnibor_openr (const char *filename, const char *target)
+{
+  struct omnibor_image *image = &omnibor_input;
+  bfd *abfd;
+  int fd;
+
+  if (omnibor_directory () == NULL)
+    return bfd_openr (filename, target);
+
+  fd = open (filename, O_RDONLY | O_BINARY);
+  if (fd < 0)
+    return bfd_openr (filename, target);
+
+  memset (image, 0, sizeof (*image));
+  if (fstat (fd, &image->st) != 0
+      || !S_ISREG (image->st.st_mode)
+      || image->st.st_size <= 0
+      || (size_t) image->st.st_size != (uint64_t) image->st.st_size)
+    {
+      close (fd);
+      return bfd_openr (filename, target);
+    }
+  image->size = image->st.st_size;
+
+#ifdef HAVE_MMAP
+  image->data = (bfd_byte *) mmap (NULL, image->size, PROT_READ,
+				   MAP_PRIVATE, fd, 0);
+  if (image->data == (bfd_byte *) MAP_FAILED)
+    image->data = NULL;
+  else
+    image->mapped = true;
+#endif
+  if (image->data == NULL)
+    {
+      image->data = (bfd_byte *) malloc (image->size);
+      if (image->data != NULL
+	  && !omnibor_read_at (fd, 0, image->data, image->size))
+	{
+	  free (image->data);
+	  image->data = NULL;
+	}
+    }
+  close (fd);
+  if (image->data == NULL)
+    return bfd_openr (filename, target);
+
+  abfd = bfd_openr_iovec (filename, target, omnibor_image_open, image,
+			  omnibor_image_pread, omnibor_image_close,
+			  omnibor_image_stat);
+  if (abfd == NULL)
+    omnibor_image_close (NULL, image);
+  image->abfd = abfd;
+  return abfd;
+}
+
+/* Return the SIZE bytes of IBFD within omnibor_input, or NULL if IBFD
+   is not read from that image.  Members of normal archives are found at
+   their offset within the archive, as bfd_bread finds them.  */
+
+static const bfd_byte *
+omnibor_input_contents (bfd *ibfd, ufile_ptr size)
+{
+  ufile_ptr offset = 0;
+
+  while (ibfd->my_archive != NULL
+	 && !bfd_is_thin_archive (ibfd->my_archive))
+    {
+      offset += ibfd->origin;
+      ibfd = ibfd->my_archive;
+    }
+  offset += ibfd->origin;
+
+  if (omnibor_input.abfd == NULL
+      || ibfd != omnibor_input.abfd
+      || offset > omnibor_input.size
+      || size > omnibor_input.size - offset)
+    return NULL;
+  return omnibor_input.data + offset;
+}
+
+/* Calculate the SHA1 and SHA256 gitoids of the whole of the input file
+   IBFD.  Its contents are normally taken from omnibor_input, which holds
+   them already; otherwise, as for the members of thin archives, the file
+   is read once through IBFD.  */
+
+static bool
+omnibor_hash_input (bfd *ibfd, unsigned char *sha1, unsigned char *sha256)
+{
+  struct sha1_ctx ctx1;
+  struct sha256_ctx ctx256;
+  char header[64];
+  const bfd_byte *contents;
+  bfd_byte *buf;
+  ufile_ptr size, left;
+  int len;
+
+  size = bfd_get_file_size (ibfd);
+  if (size == 0)
+    return false;
+
+  len = sprintf (header, "blob %" PRIu64, (uint64_t) size) + 1;
+  sha1_init_ctx (&ctx1);
+  sha256_init_ctx (&ctx256);
+  sha1_process_bytes (header, len, &ctx1);
+  sha256_process_bytes (header, len, &ctx256);
+
+  contents = omnibor_input_contents (ibfd, size);
+  if (contents != NULL)
+    {
+      sha1_process_bytes (contents, size, &ctx1);
+      sha256_process_bytes (contents, size, &ctx256);
+    }
+  else
+    {
+      if (bfd_seek (ibfd, 0, SEEK_SET) != 0)
+	return false;
+      buf = (bfd_byte *) xmalloc (65536);
+      for (left = size; left != 0; )
+	{
+	  bfd_size_type chunk = left < 65536 ? left : 65536;
+
+	  if (bfd_bread (buf, chunk, ibfd) != chunk)
+	    {
+	      free (buf);
+	      return false;
+	    }
+	  sha1_process_bytes (buf, chunk, &ctx1);
+	  sha256_process_bytes (buf, chunk, &ctx256);
+	  left -= chunk;
+	}
+      free (buf);
+    }
+
+  sha1_finish_ctx (&ctx1, sha1);
+  sha256_finish_ctx (&ctx256, sha256);
+  return true;
+}
+
+/* Find the descriptor of the note of type TYPE, whose size must be LEN,
+   in the '.note.omnibor' section CONTENTS of SIZE bytes read from IBFD.  */
+
+static bfd_byte *
+omnibor_find_note (bfd *ibfd, bfd_byte *contents, bfd_size_type size,
+		   unsigned long type, unsigned int len)
+{
+  bfd_size_type off = 0;
+
+  while (size - off >= 12)
+    {
+      unsigned long namesz = bfd_get_32 (ibfd, contents + off);
+      unsigned long descsz = bfd_get_32 (ibfd, contents + off + 4);
+      unsigned long ntype = bfd_get_32 (ibfd, contents + off + 8);
+      bfd_size_type name_off = off + 12;
+      bfd_size_type desc_off = name_off + ((namesz + 3) & ~3ul);
+
+      if (desc_off < name_off || desc_off > size || descsz > size - desc_off)
+	break;
+      if (ntype == type
+	  && namesz == sizeof "OMNIBOR"
+	  && memcmp (contents + name_off, "OMNIBOR", sizeof "OMNIBOR") == 0
+	  && descsz == len)
+	return contents + desc_off;
+      off = desc_off + ((descsz + 3) & ~3ul);
+    }
+
+  return NULL;
+}
+
+/* The assembler can move the OmniBOR Document files of a hash function
+   into a pack, objects/gitoid_blob_<hash>/OMNIBOR_PACK_NAME, and connects
+   object files without a '.note.omnibor' section to their Documents
+   through an index, mapping/gitoid_blob_<hash>.idx, or with
+   OMNIBOR_MAPPING_FILES set, one file per object file in
+   mapping/gitoid_blob_<hash>.  See gas/depend.c for their formats.  */
+
+#define OMNIBOR_PACK_NAME "omnibor.pack"
+#define OMNIBOR_PACK_MAGIC "OMNIBPAK"
+#define OMNIBOR_PACK_VERSION 1
+#define OMNIBOR_PACK_HEADER_SIZE 24
+
+#define OMNIBOR_INDEX_MAGIC "OMNIBIDX"
+#define OMNIBOR_INDEX_VERSION 1
+#define OMNIBOR_INDEX_HEADER_SIZE 24
+
+/* Convert the hexadecimal gitoid HEX of LEN bytes to GITOID.  */
+
+static bool
+omnibor_gitoid_from_hex (const char *hex, unsigned int len,
+			 unsigned char *gitoid)
+{
+  unsigned int i;
+
+  for (i = 0; i < 2 * len; i++)
+    {
+      int c = hex[i], digit;
+
+      if (c >= '0' && c <= '9')
+	digit = c - '0';
+      else if (c >= 'a' && c <= 'f')
+	digit = c - 'a' + 10;
+      else
+	return false;
+      if (i % 2 == 0)
+	gitoid[i / 2] = digit << 4;
+      else
+	gitoid[i / 2] |= digit;
+    }
+  return true;
+}
+
+/* Return true if the pack PATH holds the Document whose gitoid of LEN
+   bytes is DOC.  */
+
+static bool
+omnibor_pack_contains (const char *path, unsigned int len,
+		       const unsigned char *doc)
+{
+  unsigned char header[OMNIBOR_PACK_HEADER_SIZE];
+  unsigned char entry[GITOID_LENGTH_SHA256 + 16];
+  size_t entry_size = len + 16;
+  bool found = false;
+  int fd;
+
+  fd = open (path, O_RDONLY | O_BINARY);
+  if (fd < 0)
+    return false;
+
+  if (omnibor_read_at (fd, 0, header, sizeof header)
+      && memcmp (header, OMNIBOR_PACK_MAGIC, 8) == 0
+      && bfd_getb32 (header + 8) == OMNIBOR_PACK_VERSION
+      && bfd_getb32 (header + 12) == len)
+    {
+      unsigned long lo = 0, hi = bfd_getb32 (header + 16);
+
+      while (lo < hi)
+	{
+	  unsigned long mid = lo + (hi - lo) / 2;
+	  int cmp;
+
+	  if (!omnibor_read_at (fd, OMNIBOR_PACK_HEADER_SIZE
+				+ (off_t) mid * entry_size,
+				entry, entry_size))
+	    break;
+	  cmp = memcmp (doc, entry, len);
+	  if (cmp == 0)
+	    {
+	      found = true;
+	      break;
+	    }
+	  if (cmp < 0)
+	    hi = mid;
+	  else
+	    lo = mid + 1;
+	}
+    }
+
+  close (fd);
+  return found;
+}
+
+/* Read the header of the mapping index open on FD, whose gitoids are LEN
+   bytes long, and set *COUNT to the number of its records and *SORTED
+   to the number of those which are sorted.  Return false if FD holds no
+   such index.  */
+
+static bool
+omnibor_index_header (int fd, unsigned int len, unsigned long *count,
+		      unsigned long *sorted)
+{
+  unsigned char header[OMNIBOR_INDEX_HEADER_SIZE];
+  struct stat st;
+
+  if (fstat (fd, &st) != 0
+      || st.st_size < OMNIBOR_INDEX_HEADER_SIZE
+      || !omnibor_read_at (fd, 0, header, sizeof header)
+      || memcmp (header, OMNIBOR_INDEX_MAGIC, 8) != 0
+      || bfd_getb32 (header + 8) != OMNIBOR_INDEX_VERSION
+      || bfd_getb32 (header + 12) != len)
+    return false;
+
+  /* A partial record left by an interrupted writer is ignored.  */
+  *count = (st.st_size - OMNIBOR_INDEX_HEADER_SIZE) / (2 * len);
+  *sorted = bfd_getb32 (header + 16);
+  if (*sorted > *count)
+    *sorted = *count;
+  return true;
+}
+
+/* Look KEY up in the mapping index open on FD, which holds COUNT records
+   of gitoids of LEN bytes, the first SORTED of them sorted.  If it is
+   found, store the gitoid of its Document in DOC.  */
+
+static bool
+omnibor_index_search (int fd, unsigned int len, unsigned long count,
+		      unsigned long sorted, const unsigned char *key,
+		      unsigned char *doc)
+{
+  unsigned char rec[2 * GITOID_LENGTH_SHA256];
+  size_t rec_size = 2 * len;
+  unsigned long i, lo, hi;
+
+  /* The records after the sorted ones were appended in order, and the
+     last one for a key wins.  */
+  for (i = count; i > sorted; i--)
+    {
+      if (!omnibor_read_at (fd, OMNIBOR_INDEX_HEADER_SIZE
+			    + (off_t) (i - 1) * rec_size, rec, rec_size))
+	return false;
+      if (memcmp (rec, key, len) == 0)
+	{
+	  memcpy (doc, rec + len, len);
+	  return true;
+	}
+    }
+
+  lo = 0;
+  hi = sorted;
+  while (lo < hi)
+    {
+      unsigned long mid = lo + (hi - lo) / 2;
+      int cmp;
+
+      if (!omnibor_read_at (fd, OMNIBOR_INDEX_HEADER_SIZE
+			    + (off_t) mid * rec_size, rec, rec_size))
+	return false;
+      cmp = memcmp (key, rec, len);
+      if (cmp == 0)
+	{
+	  memcpy (doc, rec + len, len);
+	  return true;
+	}
+      if (cmp < 0)
+	hi = mid;
+      else
+	lo = mid + 1;
+    }
+  return false;
+}
+
+/* Find the gitoid of the OmniBOR Document which the mapping in DIR gives
+   for the file whose gitoid is INPUT, and store it in DOC.  HASH_NAME and
+   LEN select the hash function.  */
+
+static bool
+omnibor_find_mapping (const char *dir, const char *hash_name,
+		      unsigned int len, const unsigned char *input,
+		      unsigned char *doc)
+{
+  char input_hex[2 * GITOID_LENGTH_SHA256 + 1];
+  char doc_hex[2 * GITOID_LENGTH_SHA256];
+  unsigned long count, sorted;
+  char *path;
+  bool found = false;
+  int fd;
+
+  path = concat (dir, "/mapping/gitoid_blob_", hash_name, ".idx",
+		 (const char *) NULL);
+  fd = open (path, O_RDONLY | O_BINARY);
+  free (path);
+  if (fd >= 0)
+    {
+      found = (omnibor_index_header (fd, len, &count, &sorted)
+	       && omnibor_index_search (fd, len, count, sorted, input, doc));
+      close (fd);
+    }
+  if (found)
+    return true;
+
+  omnibor_gitoid_to_hex (input, len, input_hex);
+  path = concat (dir, "/mapping/gitoid_blob_", hash_name, "/", input_hex,
+		 (const char *) NULL);
+  fd = open (path, O_RDONLY | O_BINARY);
+  free (path);
+  if (fd >= 0)
+    {
+      found = (omnibor_read_at (fd, 0, doc_hex, 2 * len)
+	       && omnibor_gitoid_from_hex (doc_hex, len, doc));
+      close (fd);
+    }
+  return found;
+}
+
+/* Record in the mapping in DIR that the file whose gitoid is OBJ is
+   described by the Document whose gitoid is DOC.  HASH_NAME and LEN
+   select the hash function.  Like the assembler, writers of an index
+   hold a lock on it and append their record; the assembler merges the
+   appended records into the sorted ones once there are enough of
+   them.  */
+
+static bool
+omnibor_add_mapping (const char *dir, const char *hash_name,
+		     unsigned int len, const unsigned char *obj,
+		     const unsigned char *doc)
+{
+  unsigned char rec[2 * GITOID_LENGTH_SHA256];
+  unsigned char old_doc[GITOID_LENGTH_SHA256];
+  unsigned long count, sorted;
+  struct stat st;
+  char *path;
+  bool ok;
+  int fd;
+
+  path = concat (dir, "/mapping", (const char *) NULL);
+  mkdir (dir, 0777);
+  mkdir (path, 0777);
+  free (path);
+
+  if (getenv ("OMNIBOR_MAPPING_FILES") != NULL)
+    {
+      char obj_hex[2 * GITOID_LENGTH_SHA256 + 1];
+      char doc_hex[2 * GITOID_LENGTH_SHA256 + 1];
+      FILE *f;
+
+      path = concat (dir, "/mapping/gitoid_blob_", hash_name,
+		     (const char *) NULL);
+      mkdir (path, 0777);
+      free (path);
+      omnibor_gitoid_to_hex (obj, len, obj_hex);
+      omnibor_gitoid_to_hex (doc, len, doc_hex);
+      path = concat (dir, "/mapping/gitoid_blob_", hash_name, "/", obj_hex,
+		     (const char *) NULL);
+      f = fopen (path, FOPEN_WT);
+      free (path);
+      ok = f != NULL && fprintf (f, "%s\n", doc_hex) >= 0;
+      if (f != NULL && fclose (f) != 0)
+	ok = false;
+      return ok;
+    }
+
+  path = concat (dir, "/mapping/gitoid_blob_", hash_name, ".idx",
+		 (const char *) NULL);
+  for (;;)
+    {
+      struct stat path_st;
+
+      fd = open (path, O_RDWR | O_CREAT | O_BINARY, 0666);
+      if (fd < 0)
+	{
+	  free (path);
+	  return false;
+	}
+#ifdef F_SETLKW
+      {
+	struct flock lock;
+
+	memset (&lock, 0, sizeof lock);
+	lock.l_type = F_WRLCK;
+	lock.l_whence = SEEK_SET;
+	while (fcntl (fd, F_SETLKW, &lock) != 0)
+	  if (errno != EINTR)
+	    {
+	      close (fd);
+	      free (path);
+	      return false;
+	    }
+      }
+#endif
+      /* While we waited for the lock, the assembler may have replaced
+	 the index with a compacted one.  */
+      if (fstat (fd, &st) == 0
+	  && stat (path, &path_st) == 0
+	  && path_st.st_dev == st.st_dev
+	  && path_st.st_ino == st.st_ino)
+	break;
+      close (fd);
+    }
+  free (path);
+
+  if (st.st_size < OMNIBOR_INDEX_HEADER_SIZE)
+    {
+      unsigned char header[OMNIBOR_INDEX_HEADER_SIZE];
+
+      /* A new index, or one whose creator died before writing its
+	 header.  */
+      memset (header, 0, sizeof header);
+      memcpy (header, OMNIBOR_INDEX_MAGIC, 8);
+      bfd_putb32 (OMNIBOR_INDEX_VERSION, header + 8);
+      bfd_putb32 (len, header + 12);
+      count = sorted = 0;
+      ok = (ftruncate (fd, 0) == 0
+	    && lseek (fd, 0, SEEK_SET) == 0
+	    && write (fd, header, sizeof header) == sizeof header);
+    }
+  else
+    /* Leave alone anything that is not an index we understand.  */
+    ok = omnibor_index_header (fd, len, &count, &sorted);
+
+  if (ok
+      && !(omnibor_index_search (fd, len, count, sorted, obj, old_doc)
+	   && memcmp (old_doc, doc, len) == 0))
+    {
+      off_t pos = OMNIBOR_INDEX_HEADER_SIZE + (off_t) count * 2 * len;
+
+      memcpy (rec, obj, len);
+      memcpy (rec + len, doc, len);
+      ok = (lseek (fd, pos, SEEK_SET) == pos
+	    && write (fd, rec, 2 * len) == (ssize_t) (2 * len));
+    }
+
+  /* Closing the file releases the lock.  */
+  if (close (fd) != 0)
+    ok = false;
+  return ok;
+}
+
+/* Store the OmniBOR Document file for an output file whose only dependency
+   is an input file with gitoid INPUT and whose '.note.omnibor' gitoid is
+   BOM in the directory DIR, and put the gitoid of the Document in
+   DOC.  HASH_NAME and LEN select the hash function.  */
+
+static bool
+omnibor_write_document (const char *dir, const char *hash_name,
+			unsigned int len, const unsigned char *input,
+			const unsigned char *bom, unsigned char *doc)
+{
+  char input_hex[2 * GITOID_LENGTH_SHA256 + 1];
+  char bom_hex[2 * GITOID_LENGTH_SHA256 + 1];
+  char doc_hex[2 * GITOID_LENGTH_SHA256 + 1];
+  char prefix[3];
+  char header[64];
+  char *contents, *path;
+  size_t size;
+  int hlen;
+  FILE *f;
+  bool ok;
+
+  omnibor_gitoid_to_hex (input, len, input_hex);
+  omnibor_gitoid_to_hex (bom, len, bom_hex);
+  contents = concat ("gitoid:blob:", hash_name, "\nblob ", input_hex,
+		     " bom ", bom_hex, "\n", (const char *) NULL);
+  size = strlen (contents);
+
+  hlen = sprintf (header, "blob %lu", (unsigned long) size) + 1;
+  if (len == GITOID_LENGTH_SHA1)
+    {
+      struct sha1_ctx ctx;
+
+      sha1_init_ctx (&ctx);
+      sha1_process_bytes (header, hlen, &ctx);
+      sha1_process_bytes (contents, size, &ctx);
+      sha1_finish_ctx (&ctx, doc);
+    }
+  else
+    {
+      struct sha256_ctx ctx;
+
+      sha256_init_ctx (&ctx);
+      sha256_process_bytes (header, hlen, &ctx);
+      sha256_process_bytes (contents, size, &ctx);
+      sha256_finish_ctx (&ctx, doc);
+    }
+  omnibor_gitoid_to_hex (doc, len, doc_hex);
+
+  /* A Document which has already been packed is not written again.  */
+  path = concat (dir, "/objects/gitoid_blob_", hash_name,
+		 "/" OMNIBOR_PACK_NAME, (const char *) NULL);
+  ok = omnibor_pack_contains (path, len, doc);
+  free (path);
+  if (ok)
+    {
+      free (contents);
+      return true;
+    }
+
+  /* The Document goes to objects/gitoid_blob_<hash>/<2 hex>/<rest>.  */
+  path = concat (dir, "/objects", (const char *) NULL);
+  mkdir (dir, 0777);
+  mkdir (path, 0777);
+  free (path);
+  path = concat (dir, "/objects/gitoid_blob_", hash_name, (const char *) NULL);
+  mkdir (path, 0777);
+  free (path);
+  prefix[0] = doc_hex[0];
+  prefix[1] = doc_hex[1];
+  prefix[2] = '\0';
+  path = concat (dir, "/objects/gitoid_blob_", hash_name, "/", prefix,
+		 (const char *) NULL);
+  mkdir (path, 0777);
+  free (path);
+  path = concat (dir, "/objects/gitoid_blob_", hash_name, "/", prefix, "/",
+		 doc_hex + 2, (const char *) NULL);
+
+  f = fopen (path, FOPEN_WB);
+  ok = (f != NULL
+	&& fwrite (contents, 1, size, f) == size);
+  if (f != NULL && fclose (f) != 0)
+    ok = false;
+
+  free (path);
+  free (contents);
+  return ok;
+}
+
+/* If OmniBOR information is being recorded and IBFD carries a
+   '.note.omnibor' section, or has no such section but the mapping gives
+   an OmniBOR Document for it, write a new OmniBOR Document for the
+   output, whose single dependency is IBFD.  If the note is copied to the
+   output, prepare the output '.note.omnibor' section contents referring
+   to the new Document; otherwise leave the output to be added to the
+   mapping by omnibor_record_output.  */
+
+static void
+omnibor_setup_note (bfd *ibfd)
+{
+  const char *dir = omnibor_directory ();
+  asection *isec;
+  bfd_byte *contents = NULL;
+  bfd_byte *note_sha1 = NULL, *note_sha256 = NULL;
+  unsigned char input_sha1[GITOID_LENGTH_SHA1];
+  unsigned char input_sha256[GITOID_LENGTH_SHA256];
+  unsigned char bom_sha1[GITOID_LENGTH_SHA1];
+  unsigned char bom_sha256[GITOID_LENGTH_SHA256];
+  unsigned char doc_sha1[GITOID_LENGTH_SHA1];
+  unsigned char doc_sha256[GITOID_LENGTH_SHA256];
+
+  omnibor_input_section = NULL;
+  omnibor_note_contents = NULL;
+  omnibor_output_needs_mapping = false;
+
+  if (dir == NULL || bfd_get_flavour (ibfd) != bfd_target_elf_flavour)
+    return;
+
+  isec = bfd_get_section_by_name (ibfd, ".note.omnibor");
+  if (isec != NULL)
+    {
+      if ((bfd_section_flags (isec) & SEC_HAS_CONTENTS) == 0
+	  || !bfd_malloc_and_get_section (ibfd, isec, &contents))
+	return;
+      note_sha1 = omnibor_find_note (ibfd, contents, bfd_section_size (isec),
+				     NT_GITOID_SHA1, GITOID_LENGTH_SHA1);
+      note_sha256 = omnibor_find_note (ibfd, contents,
+				       bfd_section_size (isec),
+				       NT_GITOID_SHA256, GITOID_LENGTH_SHA256);
+      if (note_sha1 == NULL || note_sha256 == NULL)
+	{
+	  free (contents);
+	  return;
+	}
+      memcpy (bom_sha1, note_sha1, GITOID_LENGTH_SHA1);
+      memcpy (bom_sha256, note_sha256, GITOID_LENGTH_SHA256);
+    }
+
+  if (!omnibor_hash_input (ibfd, input_sha1, input_sha256))
+    {
+      non_fatal (_("%s: could not record the OmniBOR information in %s"),
+		 bfd_get_archive_filename (ibfd), dir);
+      free (contents);
+      return;
+    }
+
+  /* Files assembled without embedding their OmniBOR information are
+     found through the mapping; others have no OmniBOR information.  */
+  if (isec == NULL
+      && (!omnibor_find_mapping (dir, "sha1", GITOID_LENGTH_SHA1,
+				 input_sha1, bom_sha1)
+	  || !omnibor_find_mapping (dir, "sha256", GITOID_LENGTH_SHA256,
+				    input_sha256, bom_sha256)))
+    return;
+
+  if (!omnibor_write_document (dir, "sha1", GITOID_LENGTH_SHA1,
+			       input_sha1, bom_sha1, doc_sha1)
+      || !omnibor_write_document (dir, "sha256", GITOID_LENGTH_SHA256,
+				  input_sha256, bom_sha256, doc_sha256))
+    {
+      non_fatal (_("%s: could not record the OmniBOR information in %s"),
+		 bfd_get_archive_filename (ibfd), dir);
+      free (contents);
+      return;
+    }
+
+  if (isec != NULL
+      && isec->output_section != NULL
+      && (bfd_section_flags (isec->output_section) & SEC_HAS_CONTENTS) != 0)
+    {
+      memcpy (note_sha1, doc_sha1, GITOID_LENGTH_SHA1);
+      memcpy (note_sha256, doc_sha256, GITOID_LENGTH_SHA256);
+      omnibor_input_section = isec;
+      omnibor_note_contents = contents;
+      return;
+    }
+
+  free (contents);
+  memcpy (omnibor_output_doc_sha1, doc_sha1, GITOID_LENGTH_SHA1);
+  memcpy (omnibor_output_doc_sha256, doc_sha256, GITOID_LENGTH_SHA256);
+  omnibor_output_needs_mapping = true;
+}
+
+/* If omnibor_setup_note left the output of the object just copied to be
+   added to the mapping, do so now that the output, FILENAME, is
+   complete.  The mapping is keyed by the gitoids of the output itself,
+   so unlike the input, the output has to be read to calculate them.  */
+
+static void
+omnibor_record_output (const char *filename)
+{
+  const char *dir = omnibor_directory ();
+  unsigned char obj_sha1[GITOID_LENGTH_SHA1];
+  unsigned char obj_sha256[GITOID_LENGTH_SHA256];
+  struct sha1_ctx ctx1;
+  struct sha256_ctx ctx256;
+  char header[64];
+  bfd_byte *buf;
+  struct stat st;
+  off_t left;
+  int fd, len;
+  bool ok;
+
+  if (!omnibor_output_needs_mapping)
+    return;
+  omnibor_output_needs_mapping = false;
+  if (dir == NULL)
+    return;
+
+  fd = open (filename, O_RDONLY | O_BINARY);
+  ok = fd >= 0 && fstat (fd, &st) == 0;
+  if (ok)
+    {
+      len = sprintf (header, "blob %" PRIu64, (uint64_t) st.st_size) + 1;
+      sha1_init_ctx (&ctx1);
+      sha256_init_ctx (&ctx256);
+      sha1_process_bytes (header, len, &ctx1);
+      sha256_process_bytes (header, len, &ctx256);
+
+      buf = (bfd_byte *) xmalloc (65536);
+      for (left = st.st_size; ok && left != 0; )
+	{
+	  size_t chunk = left < 65536 ? left : 65536;
+
+	  ok = omnibor_read_at (fd, st.st_size - left, buf, chunk);
+	  sha1_process_bytes (buf, chunk, &ctx1);
+	  sha256_process_bytes (buf, chunk, &ctx256);
+	  left -= chunk;
+	}
+      free (buf);
+      sha1_finish_ctx (&ctx1, obj_sha1);
+      sha256_finish_ctx (&ctx256, obj_sha256);
+    }
+  if (fd >= 0)
+    close (fd);
+
+  if (!ok
+      || !omnibor_add_mapping (dir, "sha1", GITOID_LENGTH_SHA1, obj_sha1,
+			       omnibor_output_doc_sha1)
+      || !omnibor_add_mapping (dir, "sha256", GITOID_LENGTH_SHA256,
+			       obj_sha256, omnibor_output_doc_sha256))
+    non_fatal (_("%s: could not record the OmniBOR information in %s"),
+	       filename, dir);
+}
+
 /* Copy object file IBFD onto OBFD.
    Returns TRUE upon success, FALSE otherwise.  */
 
@@ -3308,8 +4224,26 @@ copy_object (bfd *ibfd, bfd *obfd, const bfd_arch_info_type *input_arch)
   bfd_map_over_sections (ibfd, copy_relocations_in_section, obfd);
 
   /* This has to happen after the symbol table has been set.  */
+  omnibor_setup_note (ibfd);
   bfd_map_over_sections (ibfd, copy_section, obfd);
 
+  if (omnibor_input_section != NULL)
+    {
+      osec = omnibor_input_section->output_section;
+      if (!bfd_set_section_contents (obfd, osec, omnibor_note_contents, 0,
+				     bfd_section_size (omnibor_input_section)))
+	{
+	  bfd_nonfatal_message (NULL, obfd, osec, NULL);
+	  free (omnibor_note_contents);
+	  omnibor_input_section = NULL;
+	  omnibor_note_contents = NULL;
+	  return false;
+	}
+      free (omnibor_note_contents);
+      omnibor_input_section = NULL;
+      omnibor_note_contents = NULL;
+    }
+
   if (add_sections != NULL)
     {
       struct section_add *padd;
@@ -3687,6 +4621,8 @@ copy_archive (bfd *ibfd, bfd *obfd, const char *output_target,
 	{
 	  if (preserve_dates && stat_status == 0)
 	    set_times (output_name, &buf);
+	  if (ok_object)
+	    omnibor_record_output (output_name);
 
 	  /* Open the newly output file and attach to our list.  */
 	  output_bfd = bfd_openr (output_name, output_target);
@@ -3777,7 +4713,7 @@ copy_file (const char *input_filename, const char *output_filename, int ofd,
 
   /* To allow us to do "strip *" without dying on the first
      non-object file, failures are nonfatal.  */
-  ibfd = bfd_openr (input_filename, input_target);
+  ibfd = omnibor_openr (input_filename, input_target);
   if (ibfd == NULL || bfd_stat (ibfd, in_stat) != 0)
     {
       bfd_nonfatal_message (input_filename, NULL, NULL, NULL);
@@ -3896,6 +4832,7 @@ copy_file (const char *input_filename, const char *output_filename, int ofd,
 	  bfd_nonfatal_message (output_filename, NULL, NULL, NULL);
 	  return;
 	}
+      omnibor_record_output (output_filename);
 
       if (!bfd_close (ibfd))
 	{
@@ -4220,6 +5157,11 @@ skip_section (bfd *ibfd, sec_ptr isection, bool skip_copy)
   if (is_update_section (ibfd, isection))
     return true;
 
+  /* The contents of the '.note.omnibor' section are rewritten by
+     copy_object.  */
+  if (skip_copy && isection == omnibor_input_section)
+    return true;
+
   /* When merging a note section we skip the copying of the contents,
      but not the copying of the relocs associated with the contents.  */
   if (skip_copy && is_mergeable_note_section (ibfd, isection))
@@ -4675,6 +5617,204 @@ default_deterministic (void)
     deterministic = DEFAULT_AR_DETERMINISTIC;
 }
 
+/* Strip FILE, writing the result to OUTPUT_FILE if that is not NULL
+   and FILE otherwise.  Return the exit status for FILE.  */
+
+static int
+strip_file (char *file, char *output_file,
+	    char *input_target, char *output_target)
+{
+  struct stat statbuf;
+  char *tmpname;
+  int tmpfd = -1;
+  int copyfd = -1;
+
+  if (get_file_size (file) < 1)
+    return 1;
+
+  if (output_file == NULL
+      || filename_cmp (file, output_file) == 0)
+    {
+      tmpname = make_tempname (file, &tmpfd);
+      if (tmpfd >= 0)
+	copyfd = dup (tmpfd);
+    }
+  else
+    tmpname = output_file;
+
+  if (tmpname == NULL)
+    {
+      bfd_nonfatal_message (file, NULL, NULL,
+			    _("could not create temporary file to hold stripped copy"));
+      return 1;
+    }
+
+  status = 0;
+  copy_file (file, tmpname, tmpfd, &statbuf, input_target,
+	     output_target, NULL);
+  if (status == 0)
+    {
+      const char *oname = output_file ? output_file : file;
+      status = smart_rename (tmpname, oname, copyfd,
+			     &statbuf, preserve_dates) != 0;
+    }
+  else
+    {
+      if (copyfd >= 0)
+	close (copyfd);
+      unlink_if_ordinary (tmpname);
+    }
+  if (output_file != tmpname)
+    free (tmpname);
+
+  return status;
+}
+
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+
+/* A file being stripped by a child process.  What the child writes to
+   standard output and error is held in temporary files until it can
+   be shown in the order the files were given.  */
+
+struct strip_job
+{
+  char *file;
+  pid_t pid;
+  FILE *out;
+  FILE *err;
+};
+
+/* Start a child process stripping JOB->FILE.  If that is not possible,
+   JOB->PID is set to -1 and the file is stripped by this process when
+   its turn comes instead.  */
+
+static void
+start_strip_job (struct strip_job *job,
+		 char *input_target, char *output_target)
+{
+  job->pid = -1;
+  job->out = tmpfile ();
+  job->err = tmpfile ();
+  if (job->out != NULL && job->err != NULL)
+    {
+      fflush (stdout);
+      fflush (stderr);
+      job->pid = fork ();
+      if (job->pid == 0)
+	{
+	  int ret = 1;
+
+	  if (dup2 (fileno (job->out), fileno (stdout)) >= 0
+	      && dup2 (fileno (job->err), fileno (stderr)) >= 0)
+	    ret = strip_file (job->file, NULL, input_target, output_target);
+	  fflush (stdout);
+	  fflush (stderr);
+	  _exit (ret);
+	}
+    }
+
+  if (job->pid == -1)
+    {
+      if (job->out != NULL)
+	fclose (job->out);
+      if (job->err != NULL)
+	fclose (job->err);
+      job->out = NULL;
+      job->err = NULL;
+    }
+}
+
+/* Copy what a child process wrote to FROM on to TO.  */
+
+static void
+copy_strip_job_output (FILE *from, FILE *to)
+{
+  char buf[BUFSIZE];
+  size_t n;
+
+  rewind (from);
+  while ((n = fread (buf, 1, sizeof (buf), from)) != 0)
+    fwrite (buf, 1, n, to);
+  fclose (from);
+}
+
+/* Wait for JOB to finish and pass on its output.  Return the exit
+   status for its file.  */
+
+static int
+finish_strip_job (struct strip_job *job,
+		  char *input_target, char *output_target)
+{
+  int wstatus;
+  int wait_errno = 0;
+  pid_t pid;
+  int ret;
+
+  if (job->pid == -1)
+    return strip_file (job->file, NULL, input_target, output_target);
+
+  /* A signal such as SIGCHLD or SIGWINCH may interrupt the wait.  */
+  do
+    pid = waitpid (job->pid, &wstatus, 0);
+  while (pid == -1 && errno == EINTR);
+  if (pid != job->pid)
+    {
+      /* Passing on the child's output below may change errno.  */
+      wait_errno = errno;
+      wstatus = -1;
+    }
+
+  copy_strip_job_output (job->out, stdout);
+  fflush (stdout);
+  copy_strip_job_output (job->err, stderr);
+
+  ret = 1;
+  if (wstatus == -1)
+    non_fatal (_("%s: could not wait for child process: %s"),
+	       job->file, strerror (wait_errno));
+  else if (WIFSIGNALED (wstatus))
+    non_fatal (_("%s: child process got fatal signal %d"),
+	       job->file, WTERMSIG (wstatus));
+  else if (WIFEXITED (wstatus))
+    ret = WEXITSTATUS (wstatus);
+  return ret;
+}
+
+/* Strip the NFILES files in FILES, up to STRIP_JOBS at a time, each
+   by its own child process.  Return the exit status.  */
+
+static int
+strip_files_in_parallel (char **files, int nfiles,
+			 char *input_target, char *output_target)
+{
+  struct strip_job *jobs;
+  int started, done;
+  int ret = status;
+
+  if (strip_jobs > nfiles)
+    strip_jobs = nfiles;
+  jobs = (struct strip_job *) xmalloc (strip_jobs * sizeof (*jobs));
+
+  started = 0;
+  for (done = 0; done < nfiles; done++)
+    {
+      for (; started < nfiles && started - done < strip_jobs; started++)
+	{
+	  jobs[started % strip_jobs].file = files[started];
+	  start_strip_job (&jobs[started % strip_jobs],
+			   input_target, output_target);
+	}
+      if (finish_strip_job (&jobs[done % strip_jobs],
+			    input_target, output_target) != 0)
+	ret = 1;
+    }
+
+  free (jobs);
+  return ret;
+}
+
+#endif /* HAVE_FORK && HAVE_SYS_WAIT_H */
+
 static int
 strip_main (int argc, char *argv[])
 {
@@ -4765,6 +5905,9 @@ strip_main (int argc, char *argv[])
 	case OPTION_FORMATS_INFO:
 	  formats_info = true;
 	  break;
+	case OPTION_OMNIBOR:
+	  omnibor_dir = optarg;
+	  break;
 	case OPTION_ONLY_KEEP_DEBUG:
 	  strip_symbols = STRIP_NONDEBUG;
 	  break;
@@ -4774,6 +5917,19 @@ strip_main (int argc, char *argv[])
 	case OPTION_KEEP_SECTION_SYMBOLS:
 	  keep_section_symbols = true;
 	  break;
+	case OPTION_JOBS:
+	  {
+	    char *end;
+	    long jobs;
+
+	    errno = 0;
+	    jobs = strtol (optarg, &end, 0);
+	    if (end == optarg || *end != '\0' || errno != 0
+		|| jobs < 1 || jobs > INT_MAX)
+	      fatal (_("%s: invalid number of jobs"), optarg);
+	    strip_jobs = jobs;
+	  }
+	  break;
 	case 0:
 	  /* We've been given a long option.  */
 	  break;
@@ -4823,57 +5979,22 @@ strip_main (int argc, char *argv[])
       || (output_file != NULL && (i + 1) < argc))
     strip_usage (stderr, 1);
 
+#if defined (HAVE_FORK) && defined (HAVE_SYS_WAIT_H)
+  if (strip_jobs > 1 && i + 1 < argc)
+    {
+      status = strip_files_in_parallel (argv + i, argc - i,
+					input_target, output_target);
+      return status;
+    }
+#endif
+
   for (; i < argc; i++)
     {
       int hold_status = status;
-      struct stat statbuf;
-      char *tmpname;
-      int tmpfd = -1;
-      int copyfd = -1;
-
-      if (get_file_size (argv[i]) < 1)
-	{
-	  status = 1;
-	  continue;
-	}
-
-      if (output_file == NULL
-	  || filename_cmp (argv[i], output_file) == 0)
-	{
-	  tmpname = make_tempname (argv[i], &tmpfd);
-	  if (tmpfd >= 0)
-	    copyfd = dup (tmpfd);
-	}
-      else
-	tmpname = output_file;
 
-      if (tmpname == NULL)
-	{
-	  bfd_nonfatal_message (argv[i], NULL, NULL,
-				_("could not create temporary file to hold stripped copy"));
-	  status = 1;
-	  continue;
-	}
-
-      status = 0;
-      copy_file (argv[i], tmpname, tmpfd, &statbuf, input_target,
-		 output_target, NULL);
+      status = strip_file (argv[i], output_file, input_target, output_target);
       if (status == 0)
-	{
-	  const char *oname = output_file ? output_file : argv[i];
-	  status = smart_rename (tmpname, oname, copyfd,
-				 &statbuf, preserve_dates) != 0;
-	  if (status == 0)
-	    status = hold_status;
-	}
-      else
-	{
-	  if (copyfd >= 0)
-	    close (copyfd);
-	  unlink_if_ordinary (tmpname);
-	}
-      if (output_file != tmpname)
-	free (tmpname);
+	status = hold_status;
     }
 
   return status;
@@ -5195,6 +6316,10 @@ copy_main (int argc, char *argv[])
 	  strip_symbols = STRIP_UNNEEDED;
 	  break;
 
+	case OPTION_OMNIBOR:
+	  omnibor_dir = optarg;
+	  break;
+
 	case OPTION_ONLY_KEEP_DEBUG:
 	  strip_symbols = STRIP_NONDEBUG;
 	  break;
@@ -167,6 +167,12 @@ struct objdump_disasm_info
   disassembler_ftype disassemble_fn;
   arelent *reloc;
   const char *symbol;
+  /* The line number table rows of the section being disassembled, if
+     bfd_find_line_rows could provide them, and the row last shown, or
+     LINE_ROWS_COUNT if none.  */
+  struct bfd_line_row *line_rows;
+  size_t line_rows_count;
+  size_t line_row;
 };
 
 /* Architecture to disassemble for, or default if NULL.  */
@@ -1933,26 +1939,15 @@ dump_lines (struct print_file_list *p, unsigned int start, unsigned int end)
 }
 
 /* Show the line number, or the source line, in a disassembly
-   listing.  */
+   listing, given what bfd_find_nearest_line_discriminator found.  */
 
 static void
-show_line (bfd *abfd, asection *section, bfd_vma addr_offset)
+show_line_info (bfd *abfd, const char *filename, const char *functionname,
+		unsigned int linenumber, unsigned int discriminator)
 {
-  const char *filename;
-  const char *functionname;
-  unsigned int linenumber;
-  unsigned int discriminator;
   bool reloc;
   char *path = NULL;
 
-  if (! with_line_numbers && ! with_source_code)
-    return;
-
-  if (! bfd_find_nearest_line_discriminator (abfd, section, syms, addr_offset,
-					     &filename, &functionname,
-					     &linenumber, &discriminator))
-    return;
-
   if (filename != NULL && *filename == '\0')
     filename = NULL;
   if (functionname != NULL && *functionname == '\0')
@@ -2112,6 +2107,49 @@ show_line (bfd *abfd, asection *section, bfd_vma addr_offset)
     free (path);
 }
 
+/* Show the line number, or the source line, in a disassembly
+   listing.  */
+
+static void
+show_line (bfd *abfd, asection *section, bfd_vma addr_offset)
+{
+  const char *filename;
+  const char *functionname;
+  unsigned int linenumber;
+  unsigned int discriminator;
+
+  if (! with_line_numbers && ! with_source_code)
+    return;
+
+  if (! bfd_find_nearest_line_discriminator (abfd, section, syms, addr_offset,
+					     &filename, &functionname,
+					     &linenumber, &discriminator))
+    return;
+
+  show_line_info (abfd, filename, functionname, linenumber, discriminator);
+}
+
+/* Make the line table row containing ADDR_OFFSET the current one.
+   Return true if it was not already, and so has yet to be shown.  */
+
+static bool
+line_row_changed (struct objdump_disasm_info *aux, bfd_vma addr_offset)
+{
+  size_t row = aux->line_row;
+
+  if (row == aux->line_rows_count
+      || addr_offset < aux->line_rows[row].address)
+    row = 0;
+  while (row + 1 < aux->line_rows_count
+	 && aux->line_rows[row + 1].address <= addr_offset)
+    row++;
+
+  if (row == aux->line_row)
+    return false;
+  aux->line_row = row;
+  return true;
+}
+
 /* Pseudo FILE object for strings.  */
 typedef struct
 {
@@ -3081,7 +3119,20 @@ disassemble_bytes (struct disassemble_info *inf,
 	  unsigned int bpc = 0;
 	  unsigned int pb = 0;
 
-	  if (with_line_numbers || with_source_code)
+	  if (aux->line_rows != NULL)
+	    {
+	      if (line_row_changed (aux, addr_offset))
+		{
+		  struct bfd_line_row *row = &aux->line_rows[aux->line_row];
+
+		  if (row->filename != NULL || row->functionname != NULL
+		      || row->line != 0)
+		    show_line_info (aux->abfd, row->filename,
+				    row->functionname, row->line,
+				    row->discriminator);
+		}
+	    }
+	  else if (with_line_numbers || with_source_code)
 	    show_line (aux->abfd, section, addr_offset);
 
 	  if (no_addresses)
@@ -3555,6 +3606,14 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
 	 && (*rel_pp)->address < rel_offset + addr_offset)
     ++rel_pp;
 
+  /* Rather than look up the line for every instruction, walk the line
+     number table alongside the disassembly where possible.  Inlining
+     information has to be looked up for every instruction though.  */
+  if ((with_line_numbers || with_source_code) && !unwind_inlines)
+    bfd_find_line_rows (paux->abfd, syms, section,
+			&paux->line_rows, &paux->line_rows_count);
+  paux->line_row = paux->line_rows_count;
+
   printf (_("\nDisassembly of section %s:\n"), sanitize_string (section->name));
 
   /* Find the nearest symbol forwards from our current position.  */
@@ -3791,6 +3850,9 @@ disassemble_section (bfd *abfd, asection *section, void *inf)
     }
 
   free (data);
+  free (paux->line_rows);
+  paux->line_rows = NULL;
+  paux->line_rows_count = 0;
 
   if (rel_ppstart != NULL)
     free (rel_ppstart);
@@ -3838,6 +3900,8 @@ disassemble_data (bfd *abfd)
   disasm_info.dynrelcount = 0;
   aux.reloc = NULL;
   aux.symbol = disasm_sym;
+  aux.line_rows = NULL;
+  aux.line_rows_count = 0;
 
   disasm_info.print_address_func = objdump_print_address;
   disasm_info.symbol_at_address_func = objdump_symbol_at_address;
@@ -45,6 +45,9 @@
 #include <time.h>
 #include <zlib.h>
 #include <wchar.h>
+#ifdef HAVE_MMAP
+#include <sys/mman.h>
+#endif
 
 #if defined HAVE_MSGPACK
 #include <msgpack.h>
@@ -263,6 +266,55 @@ struct group
   unsigned int         group_index;
 };
 
+/* What is known about one version definition, indexed by vd_ndx.  */
+
+struct verdef_slot
+{
+  bool                 seen;
+  bool                 base;
+  /* 0 if the verdaux entry has not been read yet, 1 if it has been
+     read and NAME is valid, -1 if it could not be read.  */
+  signed char          aux_state;
+  unsigned long        aux_off;
+  unsigned long        name;
+};
+
+/* What is known about one version dependency, indexed by vna_other.  */
+
+struct vernaux_slot
+{
+  bool                 seen;
+  unsigned long        name;
+};
+
+/* Version information used by get_symbol_version_string.  The version
+   definition and dependency chains are only walked as far as needed
+   to resolve the versions asked for so far, so that the diagnostics
+   for a corrupt chain are the same as when it was walked per symbol.  */
+
+struct version_cache
+{
+  /* The .gnu.version entries that can be read in one go.  */
+  unsigned char *      versym;
+  unsigned long        num_versym;
+
+  struct verdef_slot * verdefs;
+  unsigned int         num_verdefs;
+  unsigned long        verdef_off;
+  unsigned short       max_vd_ndx;
+  bool                 verdef_started;
+  bool                 verdef_done;
+
+  struct vernaux_slot * vernauxs;
+  unsigned int         num_vernauxs;
+  unsigned long        verneed_off;
+  unsigned long        verneed_next;
+  unsigned long        vernaux_off;
+  bool                 verneed_started;
+  bool                 in_verneed;
+  bool                 verneed_done;
+};
+
 typedef struct filedata
 {
   const char *         file_name;
@@ -272,6 +324,11 @@ typedef struct filedata
   Elf_Internal_Ehdr    file_header;
   unsigned long        archive_file_offset;
   unsigned long        archive_file_size;
+  /* The whole file, if it could be mapped into memory.  Data in the
+     mapping is returned by get_data_view.  */
+  void *               map;
+  bfd_size_type        map_size;
+  struct filedata *    next_mapped;
   /* Everything below this point is cleared out by free_filedata.  */
   Elf_Internal_Shdr *  section_headers;
   Elf_Internal_Phdr *  program_headers;
@@ -288,6 +345,7 @@ typedef struct filedata
   unsigned long        num_dynamic_syms;
   Elf_Internal_Sym *   dynamic_symbols;
   bfd_vma              version_info[16];
+  struct version_cache * version_cache;
   unsigned int         dynamic_syminfo_nent;
   Elf_Internal_Syminfo * dynamic_syminfo;
   unsigned long        dynamic_syminfo_offset;
@@ -454,27 +512,92 @@ bfd_vmatoa (char *fmtch, bfd_vma value)
   return ret;
 }
 
-/* Retrieve NMEMB structures, each SIZE bytes long from FILEDATA starting at
-   OFFSET + the offset of the current archive member, if we are examining an
-   archive.  Put the retrieved data into VAR, if it is not NULL.  Otherwise
-   allocate a buffer using malloc and fill that.  In either case return the
-   pointer to the start of the retrieved data or NULL if something went wrong.
-   If something does go wrong and REASON is not NULL then emit an error
-   message using REASON as part of the context.  */
+/* Files currently mapped into memory.  */
+static Filedata * mapped_files;
 
-static void *
-get_data (void *         var,
-	  Filedata *     filedata,
-	  unsigned long  offset,
-	  bfd_size_type  size,
-	  bfd_size_type  nmemb,
-	  const char *   reason)
+/* Map FILEDATA into memory if possible.  Failing that, its data is
+   read by get_data_view as if by get_data.  */
+
+static void
+map_file (Filedata * filedata)
+{
+#ifdef HAVE_MMAP
+  void * map;
+
+  if (filedata->file_size == 0
+      || (size_t) filedata->file_size != filedata->file_size)
+    return;
+
+  /* Views of the mapping are never written; sections that have
+     relocations applied to them are read into a copy by get_data.
+     Mapping the file read-only makes a stray write fault.  */
+  map = mmap (NULL, filedata->file_size, PROT_READ,
+	      MAP_PRIVATE, fileno (filedata->handle), 0);
+  if (map == MAP_FAILED)
+    return;
+
+  filedata->map = map;
+  filedata->map_size = filedata->file_size;
+  filedata->next_mapped = mapped_files;
+  mapped_files = filedata;
+#endif
+}
+
+/* Undo map_file.  Any views of FILEDATA must have been released.  */
+
+static void
+unmap_file (Filedata * filedata)
+{
+#ifdef HAVE_MMAP
+  Filedata ** p;
+
+  if (filedata->map == NULL)
+    return;
+
+  for (p = &mapped_files; *p != NULL; p = &(*p)->next_mapped)
+    if (*p == filedata)
+      {
+	*p = filedata->next_mapped;
+	break;
+      }
+
+  munmap (filedata->map, filedata->map_size);
+  filedata->map = NULL;
+  filedata->map_size = 0;
+#endif
+}
+
+/* Release DATA, as returned by get_data or get_data_view.  */
+
+static void
+free_data (void * data)
+{
+  Filedata * filedata;
+
+  for (filedata = mapped_files; filedata != NULL;
+       filedata = filedata->next_mapped)
+    if ((char *) data >= (char *) filedata->map
+	&& (char *) data < (char *) filedata->map + filedata->map_size)
+      return;
+
+  free (data);
+}
+
+/* Check that NMEMB structures, each SIZE bytes long, at OFFSET in
+   FILEDATA are within the file.  If not, and REASON is not NULL, emit
+   an error message using REASON as part of the context.  */
+
+static bool
+check_data (Filedata *     filedata,
+	    unsigned long  offset,
+	    bfd_size_type  size,
+	    bfd_size_type  nmemb,
+	    const char *   reason)
 {
-  void * mvar;
   bfd_size_type amt = size * nmemb;
 
   if (size == 0 || nmemb == 0)
-    return NULL;
+    return false;
 
   /* If the size_t type is smaller than the bfd_size_type, eg because
      you are building a 32-bit tool on a 64-bit host, then make sure
@@ -487,7 +610,7 @@ get_data (void *         var,
 	error (_("Size truncation prevents reading %s"
 		 " elements of size %s for %s\n"),
 	       bfd_vmatoa ("u", nmemb), bfd_vmatoa ("u", size), reason);
-      return NULL;
+      return false;
     }
 
   /* Check for size overflow.  */
@@ -497,7 +620,7 @@ get_data (void *         var,
 	error (_("Size overflow prevents reading %s"
 		 " elements of size %s for %s\n"),
 	       bfd_vmatoa ("u", nmemb), bfd_vmatoa ("u", size), reason);
-      return NULL;
+      return false;
     }
 
   /* Be kind to memory checkers (eg valgrind, address sanitizer) by not
@@ -509,9 +632,34 @@ get_data (void *         var,
       if (reason)
 	error (_("Reading %s bytes extends past end of file for %s\n"),
 	       bfd_vmatoa ("u", amt), reason);
-      return NULL;
+      return false;
     }
 
+  return true;
+}
+
+/* Retrieve NMEMB structures, each SIZE bytes long from FILEDATA starting at
+   OFFSET + the offset of the current archive member, if we are examining an
+   archive.  Put the retrieved data into VAR, if it is not NULL.  Otherwise
+   allocate a buffer using malloc and fill that.  In either case return the
+   pointer to the start of the retrieved data or NULL if something went wrong.
+   If something does go wrong and REASON is not NULL then emit an error
+   message using REASON as part of the context.  */
+
+static void *
+get_data (void *         var,
+	  Filedata *     filedata,
+	  unsigned long  offset,
+	  bfd_size_type  size,
+	  bfd_size_type  nmemb,
+	  const char *   reason)
+{
+  void * mvar;
+  bfd_size_type amt = size * nmemb;
+
+  if (!check_data (filedata, offset, size, nmemb, reason))
+    return NULL;
+
   if (fseek (filedata->handle, filedata->archive_file_offset + offset,
 	     SEEK_SET))
     {
@@ -551,6 +699,45 @@ get_data (void *         var,
   return mvar;
 }
 
+/* Like get_data with a NULL VAR, but if FILEDATA is mapped into memory
+   return a pointer into the mapping instead of a copy.  Unlike a copy,
+   the data is not followed by a '\0'.  Either way the result must be
+   released with free_data, before FILEDATA is closed.  */
+
+static void *
+get_data_view (Filedata *     filedata,
+	       unsigned long  offset,
+	       bfd_size_type  size,
+	       bfd_size_type  nmemb,
+	       const char *   reason)
+{
+  if (filedata->map == NULL)
+    return get_data (NULL, filedata, offset, size, nmemb, reason);
+
+  if (!check_data (filedata, offset, size, nmemb, reason))
+    return NULL;
+
+  return (char *) filedata->map + filedata->archive_file_offset + offset;
+}
+
+/* Like get_data_view, for a string table of SIZE bytes.  A view is
+   only returned if the last string in the table is terminated, so that
+   any string within the table can be used as is.  */
+
+static char *
+get_string_table (Filedata *     filedata,
+		  unsigned long  offset,
+		  bfd_size_type  size,
+		  const char *   reason)
+{
+  char * strtab;
+
+  strtab = (char *) get_data_view (filedata, offset, 1, size, reason);
+  if (strtab != NULL && strtab[size - 1] != '\0' && filedata->map != NULL)
+    strtab = (char *) get_data (NULL, filedata, offset, 1, size, reason);
+  return strtab;
+}
+
 /* Print a VMA value in the MODE specified.
    Returns the number of characters displayed.  */
 
@@ -1179,8 +1366,8 @@ slurp_rela_relocs (Filedata *            filedata,
     {
       Elf32_External_Rela * erelas;
 
-      erelas = (Elf32_External_Rela *) get_data (NULL, filedata, rel_offset, 1,
-                                                 rel_size, _("32-bit relocation data"));
+      erelas = (Elf32_External_Rela *) get_data_view (filedata, rel_offset, 1,
+						      rel_size, _("32-bit relocation data"));
       if (!erelas)
 	return false;
 
@@ -1191,7 +1378,7 @@ slurp_rela_relocs (Filedata *            filedata,
 
       if (relas == NULL)
 	{
-	  free (erelas);
+	  free_data (erelas);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1203,14 +1390,14 @@ slurp_rela_relocs (Filedata *            filedata,
 	  relas[i].r_addend = BYTE_GET_SIGNED (erelas[i].r_addend);
 	}
 
-      free (erelas);
+      free_data (erelas);
     }
   else
     {
       Elf64_External_Rela * erelas;
 
-      erelas = (Elf64_External_Rela *) get_data (NULL, filedata, rel_offset, 1,
-                                                 rel_size, _("64-bit relocation data"));
+      erelas = (Elf64_External_Rela *) get_data_view (filedata, rel_offset, 1,
+						      rel_size, _("64-bit relocation data"));
       if (!erelas)
 	return false;
 
@@ -1221,7 +1408,7 @@ slurp_rela_relocs (Filedata *            filedata,
 
       if (relas == NULL)
 	{
-	  free (erelas);
+	  free_data (erelas);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1255,7 +1442,7 @@ slurp_rela_relocs (Filedata *            filedata,
 #endif /* BFD64 */
 	}
 
-      free (erelas);
+      free_data (erelas);
     }
 
   *relasp = relas;
@@ -1284,8 +1471,8 @@ slurp_rel_relocs (Filedata *            filedata,
     {
       Elf32_External_Rel * erels;
 
-      erels = (Elf32_External_Rel *) get_data (NULL, filedata, rel_offset, 1,
-                                               rel_size, _("32-bit relocation data"));
+      erels = (Elf32_External_Rel *) get_data_view (filedata, rel_offset, 1,
+						    rel_size, _("32-bit relocation data"));
       if (!erels)
 	return false;
 
@@ -1295,7 +1482,7 @@ slurp_rel_relocs (Filedata *            filedata,
 
       if (rels == NULL)
 	{
-	  free (erels);
+	  free_data (erels);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1307,14 +1494,14 @@ slurp_rel_relocs (Filedata *            filedata,
 	  rels[i].r_addend = 0;
 	}
 
-      free (erels);
+      free_data (erels);
     }
   else
     {
       Elf64_External_Rel * erels;
 
-      erels = (Elf64_External_Rel *) get_data (NULL, filedata, rel_offset, 1,
-                                               rel_size, _("64-bit relocation data"));
+      erels = (Elf64_External_Rel *) get_data_view (filedata, rel_offset, 1,
+						    rel_size, _("64-bit relocation data"));
       if (!erels)
 	return false;
 
@@ -1324,7 +1511,7 @@ slurp_rel_relocs (Filedata *            filedata,
 
       if (rels == NULL)
 	{
-	  free (erels);
+	  free_data (erels);
 	  error (_("out of memory parsing relocs\n"));
 	  return false;
 	}
@@ -1358,7 +1545,7 @@ slurp_rel_relocs (Filedata *            filedata,
 #endif /* BFD64 */
 	}
 
-      free (erels);
+      free_data (erels);
     }
 
   *relsp = rels;
@@ -1377,8 +1564,8 @@ slurp_relr_relocs (Filedata * filedata,
   size_t size = 0, nentries, i;
   bfd_vma base = 0, addr, entry;
 
-  relrs = get_data (NULL, filedata, relr_offset, 1, relr_size,
-		    _("RELR relocation data"));
+  relrs = get_data_view (filedata, relr_offset, 1, relr_size,
+			 _("RELR relocation data"));
   if (!relrs)
     return false;
 
@@ -1403,7 +1590,7 @@ slurp_relr_relocs (Filedata * filedata,
   *relrsp = (bfd_vma *) malloc (size * sizeof (bfd_vma));
   if (*relrsp == NULL)
     {
-      free (relrs);
+      free_data (relrs);
       error (_("out of memory parsing relocs\n"));
       return false;
     }
@@ -1432,7 +1619,7 @@ slurp_relr_relocs (Filedata * filedata,
     }
 
   *nrelrsp = size;
-  free (relrs);
+  free_data (relrs);
   return true;
 }
 
@@ -5885,8 +6072,9 @@ get_32bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
   if (size > sizeof * phdrs)
     warn (_("The e_phentsize field in the ELF header is larger than the size of an ELF program header\n"));
 
-  phdrs = (Elf32_External_Phdr *) get_data (NULL, filedata, filedata->file_header.e_phoff,
-                                            size, num, _("program headers"));
+  phdrs = (Elf32_External_Phdr *) get_data_view (filedata,
+						 filedata->file_header.e_phoff,
+						 size, num, _("program headers"));
   if (phdrs == NULL)
     return false;
 
@@ -5904,7 +6092,7 @@ get_32bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
       internal->p_align  = BYTE_GET (external->p_align);
     }
 
-  free (phdrs);
+  free_data (phdrs);
   return true;
 }
 
@@ -5932,8 +6120,9 @@ get_64bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
   if (size > sizeof * phdrs)
     warn (_("The e_phentsize field in the ELF header is larger than the size of an ELF program header\n"));
 
-  phdrs = (Elf64_External_Phdr *) get_data (NULL, filedata, filedata->file_header.e_phoff,
-                                            size, num, _("program headers"));
+  phdrs = (Elf64_External_Phdr *) get_data_view (filedata,
+						 filedata->file_header.e_phoff,
+						 size, num, _("program headers"));
   if (!phdrs)
     return false;
 
@@ -5951,7 +6140,7 @@ get_64bit_program_headers (Filedata * filedata, Elf_Internal_Phdr * pheaders)
       internal->p_align  = BYTE_GET (external->p_align);
     }
 
-  free (phdrs);
+  free_data (phdrs);
   return true;
 }
 
@@ -6366,9 +6555,10 @@ get_32bit_section_headers (Filedata * filedata, bool probe)
   if (!probe && size > sizeof * shdrs)
     warn (_("The e_shentsize field in the ELF header is larger than the size of an ELF section header\n"));
 
-  shdrs = (Elf32_External_Shdr *) get_data (NULL, filedata, filedata->file_header.e_shoff,
-                                            size, num,
-					    probe ? NULL : _("section headers"));
+  shdrs = (Elf32_External_Shdr *) get_data_view (filedata,
+						 filedata->file_header.e_shoff,
+						 size, num,
+						 probe ? NULL : _("section headers"));
   if (shdrs == NULL)
     return false;
 
@@ -6378,7 +6568,7 @@ get_32bit_section_headers (Filedata * filedata, bool probe)
     {
       if (!probe)
 	error (_("Out of memory reading %u section headers\n"), num);
-      free (shdrs);
+      free_data (shdrs);
       return false;
     }
 
@@ -6402,7 +6592,7 @@ get_32bit_section_headers (Filedata * filedata, bool probe)
 	warn (_("Section %u has an out of range sh_info value of %u\n"), i, internal->sh_info);
     }
 
-  free (shdrs);
+  free_data (shdrs);
   return true;
 }
 
@@ -6431,10 +6621,10 @@ get_64bit_section_headers (Filedata * filedata, bool probe)
   if (! probe && size > sizeof * shdrs)
     warn (_("The e_shentsize field in the ELF header is larger than the size of an ELF section header\n"));
 
-  shdrs = (Elf64_External_Shdr *) get_data (NULL, filedata,
-					    filedata->file_header.e_shoff,
-                                            size, num,
-					    probe ? NULL : _("section headers"));
+  shdrs = (Elf64_External_Shdr *) get_data_view (filedata,
+						 filedata->file_header.e_shoff,
+						 size, num,
+						 probe ? NULL : _("section headers"));
   if (shdrs == NULL)
     return false;
 
@@ -6444,7 +6634,7 @@ get_64bit_section_headers (Filedata * filedata, bool probe)
     {
       if (! probe)
 	error (_("Out of memory reading %u section headers\n"), num);
-      free (shdrs);
+      free_data (shdrs);
       return false;
     }
 
@@ -6468,7 +6658,7 @@ get_64bit_section_headers (Filedata * filedata, bool probe)
 	warn (_("Section %u has an out of range sh_info value of %u\n"), i, internal->sh_info);
     }
 
-  free (shdrs);
+  free_data (shdrs);
   return true;
 }
 
@@ -6532,8 +6722,9 @@ get_32bit_elf_symbols (Filedata *           filedata,
       goto exit_point;
     }
 
-  esyms = (Elf32_External_Sym *) get_data (NULL, filedata, section->sh_offset, 1,
-                                           section->sh_size, _("symbols"));
+  esyms = (Elf32_External_Sym *) get_data_view (filedata,
+						section->sh_offset, 1,
+						section->sh_size, _("symbols"));
   if (esyms == NULL)
     goto exit_point;
 
@@ -6546,13 +6737,13 @@ get_32bit_elf_symbols (Filedata *           filedata,
       if (shndx != NULL)
 	{
 	  error (_("Multiple symbol table index sections associated with the same symbol section\n"));
-	  free (shndx);
+	  free_data (shndx);
 	}
 
-      shndx = (Elf_External_Sym_Shndx *) get_data (NULL, filedata,
-						   entry->hdr->sh_offset,
-						   1, entry->hdr->sh_size,
-						   _("symbol table section indices"));
+      shndx = (Elf_External_Sym_Shndx *) get_data_view (filedata,
+							entry->hdr->sh_offset,
+							1, entry->hdr->sh_size,
+							_("symbol table section indices"));
       if (shndx == NULL)
 	goto exit_point;
 
@@ -6592,8 +6783,8 @@ get_32bit_elf_symbols (Filedata *           filedata,
     }
 
  exit_point:
-  free (shndx);
-  free (esyms);
+  free_data (shndx);
+  free_data (esyms);
 
   if (num_syms_return != NULL)
     * num_syms_return = isyms == NULL ? 0 : number;
@@ -6649,8 +6840,9 @@ get_64bit_elf_symbols (Filedata *           filedata,
       goto exit_point;
     }
 
-  esyms = (Elf64_External_Sym *) get_data (NULL, filedata, section->sh_offset, 1,
-                                           section->sh_size, _("symbols"));
+  esyms = (Elf64_External_Sym *) get_data_view (filedata,
+						section->sh_offset, 1,
+						section->sh_size, _("symbols"));
   if (!esyms)
     goto exit_point;
 
@@ -6663,13 +6855,13 @@ get_64bit_elf_symbols (Filedata *           filedata,
       if (shndx != NULL)
 	{
 	  error (_("Multiple symbol table index sections associated with the same symbol section\n"));
-	  free (shndx);
+	  free_data (shndx);
 	}
 
-      shndx = (Elf_External_Sym_Shndx *) get_data (NULL, filedata,
-						   entry->hdr->sh_offset,
-						   1, entry->hdr->sh_size,
-						   _("symbol table section indices"));
+      shndx = (Elf_External_Sym_Shndx *) get_data_view (filedata,
+							entry->hdr->sh_offset,
+							1, entry->hdr->sh_size,
+							_("symbol table section indices"));
       if (shndx == NULL)
 	goto exit_point;
 
@@ -6711,8 +6903,8 @@ get_64bit_elf_symbols (Filedata *           filedata,
     }
 
  exit_point:
-  free (shndx);
-  free (esyms);
+  free_data (shndx);
+  free_data (esyms);
 
   if (num_syms_return != NULL)
     * num_syms_return = isyms == NULL ? 0 : number;
@@ -7128,9 +7320,10 @@ process_section_headers (Filedata * filedata)
 
       if (section->sh_size != 0)
 	{
-	  filedata->string_table = (char *) get_data (NULL, filedata, section->sh_offset,
-						      1, section->sh_size,
-						      _("string table"));
+	  filedata->string_table = get_string_table (filedata,
+						     section->sh_offset,
+						     section->sh_size,
+						     _("string table"));
 
 	  filedata->string_table_length = filedata->string_table != NULL ? section->sh_size : 0;
 	}
@@ -7241,8 +7434,8 @@ process_section_headers (Filedata * filedata)
 		}
 
 	      filedata->dynamic_strings
-		= (char *) get_data (NULL, filedata, section->sh_offset,
-				     1, section->sh_size, _("dynamic strings"));
+		= get_string_table (filedata, section->sh_offset,
+				    section->sh_size, _("dynamic strings"));
 	      filedata->dynamic_strings_length
 		= filedata->dynamic_strings == NULL ? 0 : section->sh_size;
 	      filedata->dynamic_strtab_section = section;
@@ -10808,10 +11001,10 @@ get_32bit_dynamic_section (Filedata * filedata)
   Elf32_External_Dyn * ext;
   Elf_Internal_Dyn * entry;
 
-  edyn = (Elf32_External_Dyn *) get_data (NULL, filedata,
-					  filedata->dynamic_addr, 1,
-					  filedata->dynamic_size,
-					  _("dynamic section"));
+  edyn = (Elf32_External_Dyn *) get_data_view (filedata,
+					       filedata->dynamic_addr, 1,
+					       filedata->dynamic_size,
+					       _("dynamic section"));
   if (!edyn)
     return false;
 
@@ -10833,7 +11026,7 @@ get_32bit_dynamic_section (Filedata * filedata)
     {
       error (_("Out of memory allocating space for %lu dynamic entries\n"),
 	     (unsigned long) filedata->dynamic_nent);
-      free (edyn);
+      free_data (edyn);
       return false;
     }
 
@@ -10845,7 +11038,7 @@ get_32bit_dynamic_section (Filedata * filedata)
       entry->d_un.d_val = BYTE_GET (ext->d_un.d_val);
     }
 
-  free (edyn);
+  free_data (edyn);
 
   return true;
 }
@@ -10858,10 +11051,10 @@ get_64bit_dynamic_section (Filedata * filedata)
   Elf_Internal_Dyn * entry;
 
   /* Read in the data.  */
-  edyn = (Elf64_External_Dyn *) get_data (NULL, filedata,
-					  filedata->dynamic_addr, 1,
-					  filedata->dynamic_size,
-					  _("dynamic section"));
+  edyn = (Elf64_External_Dyn *) get_data_view (filedata,
+					       filedata->dynamic_addr, 1,
+					       filedata->dynamic_size,
+					       _("dynamic section"));
   if (!edyn)
     return false;
 
@@ -10884,7 +11077,7 @@ get_64bit_dynamic_section (Filedata * filedata)
     {
       error (_("Out of memory allocating space for %lu dynamic entries\n"),
 	     (unsigned long) filedata->dynamic_nent);
-      free (edyn);
+      free_data (edyn);
       return false;
     }
 
@@ -10897,7 +11090,7 @@ get_64bit_dynamic_section (Filedata * filedata)
       entry->d_un.d_val = BYTE_GET (ext->d_un.d_val);
     }
 
-  free (edyn);
+  free_data (edyn);
 
   return true;
 }
@@ -11387,8 +11580,8 @@ the .dynsym section doesn't match the DT_SYMTAB and DT_SYMENT tags\n"));
 the .dynstr section doesn't match the DT_STRTAB and DT_STRSZ tags\n"));
 
 	    filedata->dynamic_strings
-	      = (char *) get_data (NULL, filedata, offset, 1, str_tab_len,
-				   _("dynamic string table"));
+	      = get_string_table (filedata, offset, str_tab_len,
+				  _("dynamic string table"));
 	    if (filedata->dynamic_strings == NULL)
 	      {
 		error (_("Corrupt DT_STRTAB dynamic entry\n"));
@@ -12955,6 +13148,260 @@ get_symbol_index_type (Filedata * filedata, unsigned int type)
   return buff;
 }
 
+/* Make sure that *SLOTS, an array of *NUM elements of SIZE bytes, has
+   an element NDX.  New elements are cleared.  */
+
+static void *
+grow_version_slots (void * slots, unsigned int * num, unsigned int ndx,
+		    size_t size)
+{
+  unsigned int n = *num;
+
+  if (ndx < n)
+    return slots;
+
+  if (n == 0)
+    n = 16;
+  while (n <= ndx)
+    n *= 2;
+  slots = xrealloc (slots, n * size);
+  memset ((char *) slots + *num * size, 0, (n - *num) * size);
+  *num = n;
+  return slots;
+}
+
+/* Return the version cache for FILEDATA, creating it if necessary.  */
+
+static struct version_cache *
+get_version_cache (Filedata * filedata)
+{
+  struct version_cache * cache = filedata->version_cache;
+  bfd_vma vma = filedata->version_info[DT_VERSIONTAGIDX (DT_VERSYM)];
+  Elf_Internal_Phdr * seg;
+  unsigned long offset;
+  bfd_size_type avail;
+  unsigned long count;
+
+  if (cache != NULL)
+    return cache;
+
+  cache = xcalloc (1, sizeof (*cache));
+  filedata->version_cache = cache;
+
+  /* Find the segment that offset_from_vma would use for the first
+     entry.  The same segment is used for every entry that it covers,
+     so those entries can be read together.  Anything else is left to
+     be read one at a time.  */
+  if (filedata->num_dynamic_syms == 0
+      || ! get_program_headers (filedata))
+    return cache;
+
+  for (seg = filedata->program_headers;
+       seg < filedata->program_headers + filedata->file_header.e_phnum;
+       ++seg)
+    if (seg->p_type == PT_LOAD
+	&& vma >= (seg->p_vaddr & -seg->p_align)
+	&& vma + 2 <= seg->p_vaddr + seg->p_filesz)
+      break;
+  if (seg == filedata->program_headers + filedata->file_header.e_phnum)
+    return cache;
+
+  offset = vma - seg->p_vaddr + seg->p_offset;
+  count = (seg->p_vaddr + seg->p_filesz - vma) / 2;
+  if (count > filedata->num_dynamic_syms)
+    count = filedata->num_dynamic_syms;
+  if (filedata->archive_file_offset > filedata->file_size
+      || offset > filedata->file_size - filedata->archive_file_offset)
+    return cache;
+  avail = filedata->file_size - filedata->archive_file_offset - offset;
+  if (count > avail / 2)
+    count = avail / 2;
+  if (count == 0)
+    return cache;
+
+  cache->versym = get_data_view (filedata, offset, 2, count, NULL);
+  if (cache->versym != NULL)
+    cache->num_versym = count;
+  return cache;
+}
+
+/* Release the version cache of FILEDATA.  */
+
+static void
+free_version_cache (Filedata * filedata)
+{
+  struct version_cache * cache = filedata->version_cache;
+
+  if (cache == NULL)
+    return;
+
+  free_data (cache->versym);
+  free (cache->verdefs);
+  free (cache->vernauxs);
+  free (cache);
+  filedata->version_cache = NULL;
+}
+
+/* Find the first version definition with index NDX, walking further
+   along the verdef chain if it has not been seen yet.  Returns NULL
+   if there is none, in which case the whole chain has been walked
+   and CACHE->max_vd_ndx is the largest index in it.  */
+
+static struct verdef_slot *
+find_verdef (Filedata * filedata, struct version_cache * cache,
+	     unsigned int ndx)
+{
+  if (ndx < cache->num_verdefs && cache->verdefs[ndx].seen)
+    return cache->verdefs + ndx;
+
+  if (!cache->verdef_started)
+    {
+      cache->verdef_off
+	= offset_from_vma (filedata,
+			   filedata->version_info[DT_VERSIONTAGIDX (DT_VERDEF)],
+			   sizeof (Elf_External_Verdef));
+      cache->verdef_started = true;
+    }
+
+  while (!cache->verdef_done)
+    {
+      Elf_External_Verdef evd;
+      Elf_Internal_Verdef ivd;
+
+      if (get_data (&evd, filedata, cache->verdef_off, sizeof (evd), 1,
+		    _("version def")) == NULL)
+	{
+	  ivd.vd_ndx = 0;
+	  ivd.vd_aux = 0;
+	  ivd.vd_next = 0;
+	  ivd.vd_flags = 0;
+	}
+      else
+	{
+	  ivd.vd_ndx = BYTE_GET (evd.vd_ndx);
+	  ivd.vd_aux = BYTE_GET (evd.vd_aux);
+	  ivd.vd_next = BYTE_GET (evd.vd_next);
+	  ivd.vd_flags = BYTE_GET (evd.vd_flags);
+	}
+
+      if ((ivd.vd_ndx & VERSYM_VERSION) > cache->max_vd_ndx)
+	cache->max_vd_ndx = ivd.vd_ndx & VERSYM_VERSION;
+
+      if (ivd.vd_ndx <= VERSYM_VERSION)
+	{
+	  struct verdef_slot * slot;
+
+	  cache->verdefs = grow_version_slots (cache->verdefs,
+					       &cache->num_verdefs,
+					       ivd.vd_ndx,
+					       sizeof (*cache->verdefs));
+	  slot = cache->verdefs + ivd.vd_ndx;
+	  if (!slot->seen)
+	    {
+	      slot->seen = true;
+	      slot->base = ivd.vd_ndx == 1 && ivd.vd_flags == VER_FLG_BASE;
+	      slot->aux_off = cache->verdef_off + ivd.vd_aux;
+	    }
+	}
+
+      cache->verdef_off += ivd.vd_next;
+      if (ivd.vd_next == 0)
+	cache->verdef_done = true;
+
+      if (ivd.vd_ndx == ndx)
+	return cache->verdefs + ndx;
+    }
+
+  return NULL;
+}
+
+/* Find the first version dependency whose vna_other is OTHER, walking
+   further along the verneed chain if it has not been seen yet.  */
+
+static struct vernaux_slot *
+find_vernaux (Filedata * filedata, struct version_cache * cache,
+	      unsigned int other)
+{
+  if (other < cache->num_vernauxs && cache->vernauxs[other].seen)
+    return cache->vernauxs + other;
+
+  if (!cache->verneed_started)
+    {
+      cache->verneed_off
+	= offset_from_vma (filedata,
+			   filedata->version_info[DT_VERSIONTAGIDX (DT_VERNEED)],
+			   sizeof (Elf_External_Verneed));
+      cache->verneed_started = true;
+    }
+
+  while (!cache->verneed_done)
+    {
+      Elf_External_Vernaux evna;
+      Elf_Internal_Vernaux ivna;
+
+      if (!cache->in_verneed)
+	{
+	  Elf_External_Verneed evn;
+
+	  if (get_data (&evn, filedata, cache->verneed_off, sizeof (evn), 1,
+			_("version need")) == NULL)
+	    {
+	      cache->verneed_done = true;
+	      break;
+	    }
+
+	  cache->verneed_next = BYTE_GET (evn.vn_next);
+	  cache->vernaux_off = cache->verneed_off + BYTE_GET (evn.vn_aux);
+	  cache->in_verneed = true;
+	}
+
+      if (get_data (&evna, filedata, cache->vernaux_off, sizeof (evna), 1,
+		    _("version need aux (3)")) == NULL)
+	{
+	  ivna.vna_next = 0;
+	  ivna.vna_other = 0;
+	  ivna.vna_name = 0;
+	}
+      else
+	{
+	  ivna.vna_other = BYTE_GET (evna.vna_other);
+	  ivna.vna_next  = BYTE_GET (evna.vna_next);
+	  ivna.vna_name  = BYTE_GET (evna.vna_name);
+	}
+
+      if (ivna.vna_other != 0)
+	{
+	  struct vernaux_slot * slot;
+
+	  cache->vernauxs = grow_version_slots (cache->vernauxs,
+						&cache->num_vernauxs,
+						ivna.vna_other,
+						sizeof (*cache->vernauxs));
+	  slot = cache->vernauxs + ivna.vna_other;
+	  if (!slot->seen)
+	    {
+	      slot->seen = true;
+	      slot->name = ivna.vna_name;
+	    }
+	}
+
+      cache->vernaux_off += ivna.vna_next;
+      if (ivna.vna_next == 0)
+	{
+	  cache->in_verneed = false;
+	  if (cache->verneed_next == 0)
+	    cache->verneed_done = true;
+	  else
+	    cache->verneed_off += cache->verneed_next;
+	}
+
+      if (ivna.vna_other == other)
+	return cache->vernauxs + other;
+    }
+
+  return NULL;
+}
+
 static const char *
 get_symbol_version_string (Filedata *                   filedata,
 			   bool                         is_dynsym,
@@ -12965,24 +13412,32 @@ get_symbol_version_string (Filedata *                   filedata,
 			   enum versioned_symbol_info * sym_info,
 			   unsigned short *             vna_other)
 {
-  unsigned char data[2];
+  struct version_cache * cache;
   unsigned short vers_data;
-  unsigned long offset;
   unsigned short max_vd_ndx;
 
   if (!is_dynsym
       || filedata->version_info[DT_VERSIONTAGIDX (DT_VERSYM)] == 0)
     return NULL;
 
-  offset = offset_from_vma (filedata,
-			    filedata->version_info[DT_VERSIONTAGIDX (DT_VERSYM)],
-			    sizeof data + si * sizeof (vers_data));
+  cache = get_version_cache (filedata);
+  if (si < cache->num_versym)
+    vers_data = byte_get (cache->versym + si * 2, 2);
+  else
+    {
+      unsigned char data[2];
+      unsigned long offset;
+
+      offset = offset_from_vma (filedata,
+				filedata->version_info[DT_VERSIONTAGIDX (DT_VERSYM)],
+				sizeof data + si * sizeof (vers_data));
 
-  if (get_data (&data, filedata, offset + si * sizeof (vers_data),
-		sizeof (data), 1, _("version data")) == NULL)
-    return NULL;
+      if (get_data (&data, filedata, offset + si * sizeof (vers_data),
+		    sizeof (data), 1, _("version data")) == NULL)
+	return NULL;
 
-  vers_data = byte_get (data, 2);
+      vers_data = byte_get (data, 2);
+    }
 
   if ((vers_data & VERSYM_HIDDEN) == 0 && vers_data == 0)
     return NULL;
@@ -13003,124 +13458,49 @@ get_symbol_version_string (Filedata *                   filedata,
       && vers_data != 0x8001
       && filedata->version_info[DT_VERSIONTAGIDX (DT_VERDEF)])
     {
-      Elf_Internal_Verdef ivd;
-      Elf_Internal_Verdaux ivda;
-      Elf_External_Verdaux evda;
-      unsigned long off;
-
-      off = offset_from_vma (filedata,
-			     filedata->version_info[DT_VERSIONTAGIDX (DT_VERDEF)],
-			     sizeof (Elf_External_Verdef));
-
-      do
-	{
-	  Elf_External_Verdef evd;
-
-	  if (get_data (&evd, filedata, off, sizeof (evd), 1,
-			_("version def")) == NULL)
-	    {
-	      ivd.vd_ndx = 0;
-	      ivd.vd_aux = 0;
-	      ivd.vd_next = 0;
-	      ivd.vd_flags = 0;
-	    }
-	  else
-	    {
-	      ivd.vd_ndx = BYTE_GET (evd.vd_ndx);
-	      ivd.vd_aux = BYTE_GET (evd.vd_aux);
-	      ivd.vd_next = BYTE_GET (evd.vd_next);
-	      ivd.vd_flags = BYTE_GET (evd.vd_flags);
-	    }
+      struct verdef_slot * vd;
 
-	  if ((ivd.vd_ndx & VERSYM_VERSION) > max_vd_ndx)
-	    max_vd_ndx = ivd.vd_ndx & VERSYM_VERSION;
-
-	  off += ivd.vd_next;
-	}
-      while (ivd.vd_ndx != (vers_data & VERSYM_VERSION) && ivd.vd_next != 0);
-
-      if (ivd.vd_ndx == (vers_data & VERSYM_VERSION))
+      vd = find_verdef (filedata, cache, vers_data & VERSYM_VERSION);
+      if (vd == NULL)
+	max_vd_ndx = cache->max_vd_ndx;
+      else
 	{
-	  if (ivd.vd_ndx == 1 && ivd.vd_flags == VER_FLG_BASE)
+	  if (vd->base)
 	    return NULL;
 
-	  off -= ivd.vd_next;
-	  off += ivd.vd_aux;
+	  max_vd_ndx = vers_data & VERSYM_VERSION;
 
-	  if (get_data (&evda, filedata, off, sizeof (evda), 1,
-			_("version def aux")) != NULL)
+	  if (vd->aux_state == 0)
 	    {
-	      ivda.vda_name = BYTE_GET (evda.vda_name);
+	      Elf_External_Verdaux evda;
 
-	      if (psym->st_name != ivda.vda_name)
-		return (ivda.vda_name < strtab_size
-			? strtab + ivda.vda_name : _("<corrupt>"));
-	    }
-	}
-    }
-
-  if (filedata->version_info[DT_VERSIONTAGIDX (DT_VERNEED)])
-    {
-      Elf_External_Verneed evn;
-      Elf_Internal_Verneed ivn;
-      Elf_Internal_Vernaux ivna;
-
-      offset = offset_from_vma (filedata,
-				filedata->version_info[DT_VERSIONTAGIDX (DT_VERNEED)],
-				sizeof evn);
-      do
-	{
-	  unsigned long vna_off;
-
-	  if (get_data (&evn, filedata, offset, sizeof (evn), 1,
-			_("version need")) == NULL)
-	    {
-	      ivna.vna_next = 0;
-	      ivna.vna_other = 0;
-	      ivna.vna_name = 0;
-	      break;
-	    }
-
-	  ivn.vn_aux  = BYTE_GET (evn.vn_aux);
-	  ivn.vn_next = BYTE_GET (evn.vn_next);
-
-	  vna_off = offset + ivn.vn_aux;
-
-	  do
-	    {
-	      Elf_External_Vernaux evna;
-
-	      if (get_data (&evna, filedata, vna_off, sizeof (evna), 1,
-			    _("version need aux (3)")) == NULL)
+	      if (get_data (&evda, filedata, vd->aux_off, sizeof (evda), 1,
+			    _("version def aux")) != NULL)
 		{
-		  ivna.vna_next = 0;
-		  ivna.vna_other = 0;
-		  ivna.vna_name = 0;
+		  vd->name = BYTE_GET (evda.vda_name);
+		  vd->aux_state = 1;
 		}
 	      else
-		{
-		  ivna.vna_other = BYTE_GET (evna.vna_other);
-		  ivna.vna_next  = BYTE_GET (evna.vna_next);
-		  ivna.vna_name  = BYTE_GET (evna.vna_name);
-		}
-
-	      vna_off += ivna.vna_next;
+		vd->aux_state = -1;
 	    }
-	  while (ivna.vna_other != vers_data && ivna.vna_next != 0);
-
-	  if (ivna.vna_other == vers_data)
-	    break;
 
-	  offset += ivn.vn_next;
+	  if (vd->aux_state > 0 && psym->st_name != vd->name)
+	    return (vd->name < strtab_size
+		    ? strtab + vd->name : _("<corrupt>"));
 	}
-      while (ivn.vn_next != 0);
+    }
+
+  if (filedata->version_info[DT_VERSIONTAGIDX (DT_VERNEED)])
+    {
+      struct vernaux_slot * vn;
 
-      if (ivna.vna_other == vers_data)
+      vn = find_vernaux (filedata, cache, vers_data);
+      if (vn != NULL)
 	{
 	  *sym_info = symbol_undefined;
-	  *vna_other = ivna.vna_other;
-	  return (ivna.vna_name < strtab_size
-		  ? strtab + ivna.vna_name : _("<corrupt>"));
+	  *vna_other = vers_data;
+	  return (vn->name < strtab_size
+		  ? strtab + vn->name : _("<corrupt>"));
 	}
       else if ((max_vd_ndx || (vers_data & VERSYM_VERSION) != 1)
 	       && (vers_data & VERSYM_VERSION) > max_vd_ndx)
@@ -15839,15 +16219,24 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
       /* If it is already loaded, do nothing.  */
       if (streq (section->filename, filedata->file_name))
 	return true;
-      free (section->start);
+      free_data (section->start);
     }
 
   snprintf (buf, sizeof (buf), _("%s section data"), section->name);
   section->address = sec->sh_addr;
   section->filename = filedata->file_name;
-  section->start = (unsigned char *) get_data (NULL, filedata,
-                                               sec->sh_offset, 1,
-                                               sec->sh_size, buf);
+  /* Relocations are applied in place, so a section that is going to
+     be relocated needs its own copy.  Anything else is read through
+     the file mapping.  */
+  if (debug_displays [debug].relocate
+      && filedata->file_header.e_type == ET_REL)
+    section->start = (unsigned char *) get_data (NULL, filedata,
+						 sec->sh_offset, 1,
+						 sec->sh_size, buf);
+  else
+    section->start = (unsigned char *) get_data_view (filedata,
+						      sec->sh_offset, 1,
+						      sec->sh_size, buf);
   if (section->start == NULL)
     section->size = 0;
   else
@@ -15910,7 +16299,7 @@ load_specific_debug_section (enum dwarf_section_display_enum  debug,
 	    {
 	      /* Free the compressed buffer, update the section buffer
 		 and the section size if uncompress is successful.  */
-	      free (section->start);
+	      free_data (section->start);
 	      section->start = start;
 	    }
 	  else
@@ -16148,7 +16537,7 @@ free_debug_section (enum dwarf_section_display_enum debug)
   if (section->start == NULL)
     return;
 
-  free ((char *) section->start);
+  free_data (section->start);
   section->start = NULL;
   section->address = 0;
   section->size = 0;
@@ -22119,12 +22508,13 @@ free_filedata (Filedata *filedata)
   free (filedata->program_interpreter);
   free (filedata->program_headers);
   free (filedata->section_headers);
-  free (filedata->string_table);
+  free_data (filedata->string_table);
   free (filedata->dump.dump_sects);
-  free (filedata->dynamic_strings);
+  free_data (filedata->dynamic_strings);
   free (filedata->dynamic_symbols);
   free (filedata->dynamic_syminfo);
   free (filedata->dynamic_section);
+  free_version_cache (filedata);
 
   while (filedata->symtab_shndx_list != NULL)
     {
@@ -22161,6 +22551,7 @@ close_file (Filedata * filedata)
 {
   if (filedata)
     {
+      unmap_file (filedata);
       if (filedata->handle)
 	fclose (filedata->handle);
       free (filedata);
@@ -22195,6 +22586,7 @@ open_file (const char * pathname, bool is_separate)
   filedata->file_size = (bfd_size_type) statbuf.st_size;
   filedata->file_name = pathname;
   filedata->is_separate = is_separate;
+  map_file (filedata);
 
   if (! get_file_header (filedata))
     goto fail;
@@ -22207,6 +22599,7 @@ open_file (const char * pathname, bool is_separate)
  fail:
   if (filedata)
     {
+      unmap_file (filedata);
       if (filedata->handle)
         fclose (filedata->handle);
       free (filedata);
@@ -22754,6 +23147,7 @@ process_file (char * file_name)
 
   filedata->file_size = (bfd_size_type) statbuf.st_size;
   filedata->is_separate = false;
+  map_file (filedata);
 
   if (memcmp (armag, ARMAG, SARMAG) == 0)
     {
@@ -22778,11 +23172,12 @@ process_file (char * file_name)
 	ret = false;
     }
 
-  fclose (filedata->handle);
   free (filedata->section_headers);
   free (filedata->program_headers);
-  free (filedata->string_table);
+  free_data (filedata->string_table);
   free (filedata->dump.dump_sects);
+  unmap_file (filedata);
+  fclose (filedata->handle);
   free (filedata);
 
   free (ba_cache.strtab);
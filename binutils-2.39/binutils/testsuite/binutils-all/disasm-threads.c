@@ -0,0 +1,223 @@
+/* This program is used to check that libopcodes disassemblers may be
+   used from several threads at once.  The same bytes are disassembled
+   for each configured architecture by a single thread, then by several
+   threads together; every thread must see what the single one did.  */
+
+#include "config.h"
+#include "bfd.h"
+#include "dis-asm.h"
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NTHREADS 8
+#define NROUNDS 20
+#define NBYTES 2048
+
+struct target
+{
+  const char *arch;
+  const char *options;
+  bool big;
+  const bfd_arch_info_type *info;
+  char *expected;
+};
+
+static struct target targets[] =
+{
+  { "i386:x86-64", NULL, false, NULL, NULL },
+  { "i386", "intel", false, NULL, NULL },
+  { "aarch64", NULL, false, NULL, NULL },
+  { "arm", NULL, false, NULL, NULL },
+  { "arm", "force-thumb", false, NULL, NULL },
+  { "riscv:rv64", NULL, false, NULL, NULL },
+  { "riscv:rv32", "no-aliases", false, NULL, NULL },
+  { "powerpc:common64", NULL, true, NULL, NULL },
+  { "powerpc:common64", "power10", false, NULL, NULL },
+};
+
+#define NTARGETS (sizeof (targets) / sizeof (targets[0]))
+
+static bfd_byte bytes[NBYTES];
+
+struct text
+{
+  char *s;
+  size_t len;
+  size_t size;
+};
+
+static int
+text_vprintf (struct text *t, const char *fmt, va_list ap)
+{
+  va_list ap2;
+  int n;
+
+  va_copy (ap2, ap);
+  n = vsnprintf (NULL, 0, fmt, ap2);
+  va_end (ap2);
+  if (n < 0)
+    abort ();
+  if (t->len + n + 1 > t->size)
+    {
+      t->size = (t->len + n + 1) * 2;
+      t->s = realloc (t->s, t->size);
+      if (t->s == NULL)
+	abort ();
+    }
+  vsnprintf (t->s + t->len, t->size - t->len, fmt, ap);
+  t->len += n;
+  return n;
+}
+
+static int
+text_printf (void *stream, const char *fmt, ...)
+{
+  va_list ap;
+  int n;
+
+  va_start (ap, fmt);
+  n = text_vprintf (stream, fmt, ap);
+  va_end (ap);
+  return n;
+}
+
+static int
+text_styled_printf (void *stream,
+		    enum disassembler_style style ATTRIBUTE_UNUSED,
+		    const char *fmt, ...)
+{
+  va_list ap;
+  int n;
+
+  va_start (ap, fmt);
+  n = text_vprintf (stream, fmt, ap);
+  va_end (ap);
+  return n;
+}
+
+/* Disassemble BYTES for T, returning the text in a malloc'd string.  */
+
+static char *
+disassemble (const struct target *t)
+{
+  struct disassemble_info info;
+  disassembler_ftype print_insn;
+  struct text text = { NULL, 0, 0 };
+  bfd_vma pc;
+
+  init_disassemble_info (&info, &text, text_printf, text_styled_printf);
+  info.arch = t->info->arch;
+  info.mach = t->info->mach;
+  info.endian = t->big ? BFD_ENDIAN_BIG : BFD_ENDIAN_LITTLE;
+  info.endian_code = info.endian;
+  info.buffer = bytes;
+  info.buffer_length = NBYTES;
+  info.buffer_vma = 0;
+  info.disassembler_options = t->options;
+  disassemble_init_for_target (&info);
+
+  print_insn = disassembler (info.arch, t->big, info.mach, NULL);
+  for (pc = 0; pc < NBYTES; )
+    {
+      int size;
+
+      text_printf (&text, "%lx:\t", (unsigned long) pc);
+      size = print_insn (pc, &info);
+      text_printf (&text, "\n");
+      if (size <= 0)
+	break;
+      pc += size;
+    }
+
+  disassemble_free_target (&info);
+  return text.s;
+}
+
+static void *
+worker (void *arg)
+{
+  size_t first = (size_t) arg;
+  size_t mismatches = 0;
+  int round;
+  size_t i;
+
+  for (round = 0; round < NROUNDS; round++)
+    for (i = 0; i < NTARGETS; i++)
+      {
+	struct target *t = &targets[(first + i) % NTARGETS];
+	char *text;
+
+	if (t->expected == NULL)
+	  continue;
+	text = disassemble (t);
+	if (strcmp (text, t->expected) != 0)
+	  mismatches++;
+	free (text);
+      }
+  return (void *) mismatches;
+}
+
+int
+main (void)
+{
+  pthread_t threads[NTHREADS];
+  unsigned int seed = 12345;
+  size_t mismatches = 0;
+  size_t tested = 0;
+  size_t i;
+
+  if (bfd_init () != BFD_INIT_MAGIC)
+    abort ();
+
+  /* Any fixed bytes will do, as long as they decode to a mix of
+     instructions.  */
+  for (i = 0; i < NBYTES; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      bytes[i] = seed >> 16;
+    }
+
+  for (i = 0; i < NTARGETS; i++)
+    {
+      struct target *t = &targets[i];
+
+      t->info = bfd_scan_arch (t->arch);
+      if (t->info == NULL
+	  || disassembler (t->info->arch, t->big, t->info->mach, NULL) == NULL)
+	continue;
+      t->expected = disassemble (t);
+      tested++;
+    }
+
+  if (tested == 0)
+    {
+      printf ("no architectures to test\n");
+      return 77;
+    }
+
+  for (i = 0; i < NTHREADS; i++)
+    if (pthread_create (&threads[i], NULL, worker, (void *) i) != 0)
+      abort ();
+  for (i = 0; i < NTHREADS; i++)
+    {
+      void *ret;
+
+      if (pthread_join (threads[i], &ret) != 0)
+	abort ();
+      mismatches += (size_t) ret;
+    }
+
+  for (i = 0; i < NTARGETS; i++)
+    free (targets[i].expected);
+
+  if (mismatches != 0)
+    {
+      printf ("%lu mismatches\n", (unsigned long) mismatches);
+      return 1;
+    }
+  printf ("%lu architectures ok\n", (unsigned long) tested);
+  return 0;
+}
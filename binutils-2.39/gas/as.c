@@ -529,6 +529,7 @@ parse_args (int * pargc, char *** pargv)
       OPTION_DEPFILE,
       OPTION_OMNIBOR,
       OPTION_OMNIBOR_TEMPFILE,
+      OPTION_OMNIBOR_PACK,
       OPTION_GSTABS,
       OPTION_GSTABS_PLUS,
       OPTION_GDWARF_2,
@@ -627,6 +628,7 @@ parse_args (int * pargc, char *** pargv)
     ,{"no-warn", no_argument, NULL, 'W'}
     ,{"omnibor", required_argument, NULL, OPTION_OMNIBOR}
     ,{"omnibor-tempfile", no_argument, NULL, OPTION_OMNIBOR_TEMPFILE}
+    ,{"omnibor-pack", required_argument, NULL, OPTION_OMNIBOR_PACK}
     ,{"reduce-memory-overheads", no_argument, NULL, OPTION_REDUCE_MEMORY_OVERHEADS}
     ,{"statistics", no_argument, NULL, OPTION_STATISTICS}
     ,{"strip-local-absolute", no_argument, NULL, OPTION_STRIP_LOCAL_ABSOLUTE}
@@ -1011,6 +1013,12 @@ This program has absolutely no warranty.\n"));
 	  omnibor_input_file_is_temporary = true;
 	  break;
 
+	case OPTION_OMNIBOR_PACK:
+	  if (!omnibor_pack_objects (optarg))
+	    as_fatal (_("could not pack the OmniBOR Document files in %s"),
+		      optarg);
+	  exit (EXIT_SUCCESS);
+
 	case 'R':
 	  flag_readonly_data_in_text = 1;
 	  break;
@@ -1314,10 +1322,9 @@ close_output_file (void)
       {
         if (omnibor_dir_final == NULL)
 	  set_omnibor_dir ();
-	omnibor_create_file_no_embed_sha1 (omnibor_no_embed_gitoid_sha1,
-					   omnibor_dir_final);
-	omnibor_create_file_no_embed_sha256 (omnibor_no_embed_gitoid_sha256,
-					     omnibor_dir_final);
+	omnibor_create_mapping_no_embed (omnibor_no_embed_gitoid_sha1,
+					 omnibor_no_embed_gitoid_sha256,
+					 omnibor_dir_final);
 	if (!((omnibor_dir != NULL ||
 	      (getenv ("OMNIBOR_DIR") != NULL && strlen (getenv ("OMNIBOR_DIR")) > 0)) &&
 	     !(omnibor_input_file_is_temporary && input_omnibor_section != NULL)))
@@ -503,8 +503,8 @@ void omnibor_clear_deps (void);
 void omnibor_clear_note_sections (void);
 void write_sha1_omnibor (char **, const char *);
 void write_sha256_omnibor (char **, const char *);
-void omnibor_create_file_no_embed_sha1 (const char *, char *);
-void omnibor_create_file_no_embed_sha256 (const char *, char *);
+void omnibor_create_mapping_no_embed (const char *, const char *, char *);
+bool omnibor_pack_objects (const char *);
 bool create_omnibor_metadata_file (unsigned, const char *);
 
 /* More OmniBOR-related function declarations.  Defined in write.c.  */
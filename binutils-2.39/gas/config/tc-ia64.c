@@ -675,9 +675,12 @@ static struct rsrc {
   struct mem_offset mem_offset;     /* optional memory offset hint */
   enum { CMP_NONE, CMP_OR, CMP_AND } cmp_type; /* OR or AND compare? */
   int path;                         /* corresponding code entry index */
+  int dep_next, dep_prev;           /* other entries with the same depind */
 } *regdeps = NULL;
 static int regdepslen = 0;
 static int regdepstotlen = 0;
+/* The first entry in regdeps for each dependency index, or -1.  */
+static int regdeps_by_dep[DEP (~0) + 1];
 static const char *dv_mode[] = { "RAW", "WAW", "WAR" };
 static const char *dv_sem[] = { "none", "implied", "impliedf",
 				"data", "instr", "specific", "stop", "other" };
@@ -811,6 +814,9 @@ static void add_qp_imply (int, int);
 static void clear_qp_mutex (valueT);
 static void clear_qp_implies (valueT, valueT);
 static void print_dependency (const char *, int);
+static void link_regdep (int);
+static void remove_regdep (int);
+static void clear_regdeps (void);
 static void instruction_serialization (void);
 static void data_serialization (void);
 static void output_R3_format (vbyte_func, unw_record_type, unsigned long);
@@ -7244,6 +7250,8 @@ md_begin (void)
   md.auto_align = 1;
   md.explicit_mode = md.default_explicit_mode;
 
+  memset (regdeps_by_dep, -1, sizeof (regdeps_by_dep));
+
   bfd_set_section_alignment (text_section, 4);
 
   /* Make sure function pointers get initialized.  */
@@ -10147,7 +10155,7 @@ insn_group_break (int insert_stop, int qp_regno, int save_current)
 	  || regdeps[i].insn_srlz == STATE_SRLZ)
 	{
 	  print_dependency ("Removing", i);
-	  regdeps[i] = regdeps[--regdepslen];
+	  remove_regdep (i);
 	}
       else
 	{
@@ -10185,12 +10193,66 @@ mark_resource (struct ia64_opcode *idesc ATTRIBUTE_UNUSED,
   regdeps[regdepslen].path = path;
   regdeps[regdepslen].file = CURR_SLOT.src_file;
   regdeps[regdepslen].line = CURR_SLOT.src_line;
+  link_regdep (regdepslen);
 
   print_dependency ("Adding", regdepslen);
 
   ++regdepslen;
 }
 
+/* Add regdeps[I] to the list for its dependency index.  */
+
+static void
+link_regdep (int i)
+{
+  int *head = &regdeps_by_dep[regdeps[i].depind];
+
+  regdeps[i].dep_prev = -1;
+  regdeps[i].dep_next = *head;
+  if (*head >= 0)
+    regdeps[*head].dep_prev = i;
+  *head = i;
+}
+
+/* Remove regdeps[I] from the list for its dependency index.  */
+
+static void
+unlink_regdep (int i)
+{
+  if (regdeps[i].dep_prev >= 0)
+    regdeps[regdeps[i].dep_prev].dep_next = regdeps[i].dep_next;
+  else
+    regdeps_by_dep[regdeps[i].depind] = regdeps[i].dep_next;
+  if (regdeps[i].dep_next >= 0)
+    regdeps[regdeps[i].dep_next].dep_prev = regdeps[i].dep_prev;
+}
+
+/* Remove regdeps[I], moving the last entry into its place.  */
+
+static void
+remove_regdep (int i)
+{
+  unlink_regdep (i);
+  if (i != --regdepslen)
+    {
+      unlink_regdep (regdepslen);
+      regdeps[i] = regdeps[regdepslen];
+      link_regdep (i);
+    }
+}
+
+/* Remove all the entries in regdeps.  */
+
+static void
+clear_regdeps (void)
+{
+  int i;
+
+  for (i = 0; i < regdepslen; i++)
+    regdeps_by_dep[regdeps[i].depind] = -1;
+  regdepslen = 0;
+}
+
 static void
 print_dependency (const char *action, int depind)
 {
@@ -10237,7 +10299,7 @@ data_serialization (void)
 	  || (regdeps[i].dependency)->semantics == IA64_DVS_OTHER)
 	{
 	  print_dependency ("Removing", i);
-	  regdeps[i] = regdeps[--regdepslen];
+	  remove_regdep (i);
 	}
       else
 	++i;
@@ -10307,6 +10369,17 @@ remove_marked_resource (struct rsrc *rs)
     }
 }
 
+/* qsort comparison function for indexes into regdeps.  */
+
+static int
+compare_regdep_index (const void *a, const void *b)
+{
+  int ia = *(const int *) a;
+  int ib = *(const int *) b;
+
+  return ia < ib ? -1 : ia > ib;
+}
+
 /* Check the resources used by the given opcode against the current dependency
    list.
 
@@ -10325,15 +10398,40 @@ static void
 check_dependencies (struct ia64_opcode *idesc)
 {
   const struct ia64_opcode_dependency *opdeps = idesc->dependencies;
+  static int *cands;
+  static int candstotlen;
+  int ncands;
   int path;
-  int i;
+  int i, j;
 
   /* Note that the number of marked resources may change within the
-     loop if in auto mode.  */
-  i = 0;
-  while (i < regdepslen)
+     loop if in auto mode, in which case we start over.  Only the
+     resources of the classes IDESC checks can conflict with it; visit
+     those in the order they appear in regdeps.  */
+ restart:
+  ncands = 0;
+  for (j = 0; j < opdeps->nchks; j++)
+    {
+      int depind = DEP (opdeps->chks[j]);
+
+      /* Skip classes listed more than once.  */
+      if (depends_on (depind, idesc) != j)
+	continue;
+      for (i = regdeps_by_dep[depind]; i >= 0; i = regdeps[i].dep_next)
+	{
+	  if (ncands == candstotlen)
+	    {
+	      candstotlen += 20;
+	      cands = XRESIZEVEC (int, cands, candstotlen);
+	    }
+	  cands[ncands++] = i;
+	}
+    }
+  qsort (cands, ncands, sizeof (cands[0]), compare_regdep_index);
+
+  for (j = 0; j < ncands; j++)
     {
-      struct rsrc *rs = &regdeps[i];
+      struct rsrc *rs = &regdeps[cands[j]];
       const struct ia64_dependency *dep = rs->dependency;
       int chkind;
       int note;
@@ -10341,10 +10439,7 @@ check_dependencies (struct ia64_opcode *idesc)
 
       if (dep->semantics == IA64_DVS_NONE
 	  || (chkind = depends_on (rs->depind, idesc)) == -1)
-	{
-	  ++i;
-	  continue;
-	}
+	continue;
 
       note = NOTE (opdeps->chks[chkind]);
 
@@ -10437,9 +10532,7 @@ check_dependencies (struct ia64_opcode *idesc)
 	    }
 	}
       if (start_over)
-	i = 0;
-      else
-	++i;
+	goto restart;
     }
 }
 
@@ -10537,7 +10630,7 @@ update_dependencies (struct ia64_opcode *idesc)
       /* Although technically the taken branch doesn't clear dependencies
 	 which require a srlz.[id], we don't follow the branch; the next
 	 instruction is assumed to start with a clean slate.  */
-      regdepslen = 0;
+      clear_regdeps ();
       md.path = 0;
     }
   else if (is_conditional_branch (idesc)
@@ -10561,7 +10654,7 @@ update_dependencies (struct ia64_opcode *idesc)
 		  if (regdeps[depind].qp_regno == qp_implies[i].p1)
 		    {
 		      print_dependency ("Removing", depind);
-		      regdeps[depind] = regdeps[--regdepslen];
+		      remove_regdep (depind);
 		    }
 		  else
 		    ++depind;
@@ -10587,7 +10680,7 @@ update_dependencies (struct ia64_opcode *idesc)
 		{
 		  /* Treat like a taken branch */
 		  print_dependency ("Removing", i);
-		  regdeps[i] = regdeps[--regdepslen];
+		  remove_regdep (i);
 		}
 	      else
 		++i;
@@ -15392,6 +15392,178 @@ mips_frob_file_before_adjust (void)
 #endif
 }
 
+/* Information about a fixup that mips_frob_file might need to move
+   or pair up.  */
+
+struct mips_frob_fixup
+{
+  /* The fixup itself.  */
+  fixS *fixp;
+
+  /* The fixup that comes before FIXP in its section's chain, or null
+     if FIXP is at the head of the chain.  */
+  fixS *prev;
+
+  /* The position of FIXP in its section's chain when the chain was
+     first indexed.  Low-part relocations never move, so this gives
+     their relative order.  */
+  unsigned int index;
+};
+
+/* A group of low-part relocations that have the same section, symbol
+   and relocation type.  */
+
+struct mips_lo_fixup_group
+{
+  segT seg;
+  symbolS *sym;
+  bfd_reloc_code_real_type rtype;
+
+  /* The relocations in the group.  Once SORTED is true, these are
+     sorted by increasing offset and then by position in the chain.  */
+  struct mips_frob_fixup **fixups;
+  unsigned int count;
+  unsigned int alloc;
+  bool sorted;
+};
+
+static hashval_t
+hash_frob_fixup (const void *p)
+{
+  const struct mips_frob_fixup *f = (const struct mips_frob_fixup *) p;
+  return htab_hash_pointer (f->fixp);
+}
+
+static int
+eq_frob_fixup (const void *a, const void *b)
+{
+  const struct mips_frob_fixup *fa = (const struct mips_frob_fixup *) a;
+  const struct mips_frob_fixup *fb = (const struct mips_frob_fixup *) b;
+  return fa->fixp == fb->fixp;
+}
+
+static hashval_t
+hash_lo_fixup_group (const void *p)
+{
+  const struct mips_lo_fixup_group *g
+    = (const struct mips_lo_fixup_group *) p;
+  hashval_t h = iterative_hash_object (g->seg, 0);
+  h = iterative_hash_object (g->sym, h);
+  return iterative_hash_object (g->rtype, h);
+}
+
+static int
+eq_lo_fixup_group (const void *a, const void *b)
+{
+  const struct mips_lo_fixup_group *ga
+    = (const struct mips_lo_fixup_group *) a;
+  const struct mips_lo_fixup_group *gb
+    = (const struct mips_lo_fixup_group *) b;
+  return (ga->seg == gb->seg
+	  && ga->sym == gb->sym
+	  && ga->rtype == gb->rtype);
+}
+
+static void
+free_lo_fixup_group (void *p)
+{
+  struct mips_lo_fixup_group *g = (struct mips_lo_fixup_group *) p;
+  free (g->fixups);
+  free (g);
+}
+
+static int
+compare_lo_fixups (const void *a, const void *b)
+{
+  const struct mips_frob_fixup *fa = *(const struct mips_frob_fixup **) a;
+  const struct mips_frob_fixup *fb = *(const struct mips_frob_fixup **) b;
+
+  if (fa->fixp->fx_offset != fb->fixp->fx_offset)
+    return fa->fixp->fx_offset < fb->fixp->fx_offset ? -1 : 1;
+  return fa->index < fb->index ? -1 : fa->index > fb->index;
+}
+
+/* Walk the fixup chain for SEG once, recording the predecessor of
+   every high-part and low-part relocation in FIXUPS and adding each
+   low-part relocation to its group in LO_GROUPS.  */
+
+static void
+mips_index_fixups (segT seg, htab_t fixups, htab_t lo_groups)
+{
+  fixS *prev, *fixp;
+  unsigned int index;
+
+  prev = NULL;
+  index = 0;
+  for (fixp = seg_info (seg)->fix_root; fixp != NULL;
+       prev = fixp, fixp = fixp->fx_next)
+    {
+      struct mips_frob_fixup *f;
+      struct mips_lo_fixup_group key, *g;
+      void **slot;
+
+      index++;
+      if (!lo16_reloc_p (fixp->fx_r_type)
+	  && !reloc_needs_lo_p (fixp->fx_r_type))
+	continue;
+
+      f = XNEW (struct mips_frob_fixup);
+      f->fixp = fixp;
+      f->prev = prev;
+      f->index = index;
+      slot = htab_find_slot (fixups, f, INSERT);
+      gas_assert (*slot == NULL);
+      *slot = f;
+
+      if (!lo16_reloc_p (fixp->fx_r_type))
+	continue;
+
+      key.seg = seg;
+      key.sym = fixp->fx_addsy;
+      key.rtype = fixp->fx_r_type;
+      slot = htab_find_slot (lo_groups, &key, INSERT);
+      g = (struct mips_lo_fixup_group *) *slot;
+      if (g == NULL)
+	{
+	  g = XCNEW (struct mips_lo_fixup_group);
+	  g->seg = key.seg;
+	  g->sym = key.sym;
+	  g->rtype = key.rtype;
+	  *slot = g;
+	}
+      if (g->count == g->alloc)
+	{
+	  g->alloc = g->alloc ? g->alloc * 2 : 4;
+	  g->fixups = XRESIZEVEC (struct mips_frob_fixup *, g->fixups,
+				  g->alloc);
+	}
+      g->fixups[g->count++] = f;
+    }
+}
+
+/* Return the mips_frob_fixup for FIXP, or null if FIXP isn't one of
+   the relocations that mips_index_fixups records.  */
+
+static struct mips_frob_fixup *
+mips_lookup_frob_fixup (htab_t fixups, fixS *fixp)
+{
+  struct mips_frob_fixup key;
+
+  key.fixp = fixp;
+  return (struct mips_frob_fixup *) htab_find (fixups, &key);
+}
+
+/* Return true if low-part relocation F is immediately preceded by
+   a high-part relocation that it matches.  */
+
+static bool
+mips_lo_fixup_matched_p (const struct mips_frob_fixup *f)
+{
+  return (f->prev != NULL
+	  && reloc_needs_lo_p (f->prev->fx_r_type)
+	  && fixup_has_matching_lo_p (f->prev));
+}
+
 /* Sort any unmatched HI16 and GOT16 relocs so that they immediately precede
    the corresponding LO16 reloc.  This is called before md_apply_fix and
    tc_gen_reloc.  Unmatched relocs can only be generated by use of explicit
@@ -15437,20 +15609,34 @@ mips_frob_file_before_adjust (void)
    (3) is purely cosmetic.  mips_hi_fixup_list is is in reverse order,
    with the last high-part relocation being at the front of the list.
    It therefore makes sense to choose the last matching low-part
-   relocation, all other things being equal.  It's also easier
-   to code that way.  */
+   relocation, all other things being equal.
+
+   Rather than scanning the whole fixup chain for each high-part
+   relocation, we walk each section's chain once, grouping the low-part
+   relocations by symbol and relocation type and remembering the
+   predecessor of each high-part and low-part relocation.  Sorting each
+   group by offset then lets us apply the rules above without another
+   walk, and the predecessors let us move a high-part relocation in
+   constant time.  */
 
 void
 mips_frob_file (void)
 {
   struct mips_hi_fixup *l;
-  bfd_reloc_code_real_type looking_for_rtype = BFD_RELOC_UNUSED;
+  htab_t fixups, lo_groups;
+
+  fixups = htab_create_alloc (16, hash_frob_fixup, eq_frob_fixup,
+			      free, xcalloc, free);
+  lo_groups = htab_create_alloc (16, hash_lo_fixup_group, eq_lo_fixup_group,
+				 free_lo_fixup_group, xcalloc, free);
 
   for (l = mips_hi_fixup_list; l != NULL; l = l->next)
     {
       segment_info_type *seginfo;
-      bool matched_lo_p;
-      fixS **hi_pos, **lo_pos, **pos;
+      struct mips_lo_fixup_group key, *g;
+      struct mips_frob_fixup *hi, *lo, *next;
+      unsigned int first, last, mid;
+      fixS *fixp;
 
       gas_assert (reloc_needs_lo_p (l->fixp->fx_r_type));
 
@@ -15466,55 +15652,91 @@ mips_frob_file (void)
       if (fixup_has_matching_lo_p (l->fixp))
 	continue;
 
-      seginfo = seg_info (l->seg);
-
-      /* Set HI_POS to the position of this relocation in the chain.
-	 Set LO_POS to the position of the chosen low-part relocation.
-	 MATCHED_LO_P is true on entry to the loop if *POS is a low-part
-	 relocation that matches an immediately-preceding high-part
-	 relocation.  */
-      hi_pos = NULL;
-      lo_pos = NULL;
-      matched_lo_p = false;
-      looking_for_rtype = matching_lo_reloc (l->fixp->fx_r_type);
-
-      for (pos = &seginfo->fix_root; *pos != NULL; pos = &(*pos)->fx_next)
+      /* Index the section's fixups the first time that we need them.  */
+      hi = mips_lookup_frob_fixup (fixups, l->fixp);
+      if (hi == NULL)
 	{
-	  if (*pos == l->fixp)
-	    hi_pos = pos;
+	  mips_index_fixups (l->seg, fixups, lo_groups);
+	  hi = mips_lookup_frob_fixup (fixups, l->fixp);
+	  gas_assert (hi != NULL);
+	}
 
-	  if ((*pos)->fx_r_type == looking_for_rtype
-	      && symbol_same_p ((*pos)->fx_addsy, l->fixp->fx_addsy)
-	      && (*pos)->fx_offset >= l->fixp->fx_offset
-	      && (lo_pos == NULL
-		  || (*pos)->fx_offset < (*lo_pos)->fx_offset
-		  || (!matched_lo_p
-		      && (*pos)->fx_offset == (*lo_pos)->fx_offset)))
-	    lo_pos = pos;
+      key.seg = l->seg;
+      key.sym = l->fixp->fx_addsy;
+      key.rtype = matching_lo_reloc (l->fixp->fx_r_type);
+      g = (struct mips_lo_fixup_group *) htab_find (lo_groups, &key);
+      if (g == NULL)
+	continue;
+      if (!g->sorted)
+	{
+	  qsort (g->fixups, g->count, sizeof (g->fixups[0]),
+		 compare_lo_fixups);
+	  g->sorted = true;
+	}
 
-	  matched_lo_p = (reloc_needs_lo_p ((*pos)->fx_r_type)
-			  && fixup_has_matching_lo_p (*pos));
+      /* Find the first low-part relocation with the lowest offset that
+	 is no lower than the high part's, as per rule (1).  */
+      first = 0;
+      last = g->count;
+      while (first < last)
+	{
+	  mid = first + (last - first) / 2;
+	  if (g->fixups[mid]->fixp->fx_offset < l->fixp->fx_offset)
+	    first = mid + 1;
+	  else
+	    last = mid;
 	}
+      if (first == g->count)
+	continue;
 
-      /* If we found a match, remove the high-part relocation from its
-	 current position and insert it before the low-part relocation.
-	 Make the offsets match so that fixup_has_matching_lo_p()
-	 will return true.
+      /* Apply rules (2) and (3) to the relocations with that offset:
+	 pick the last one that has no matching high part, or failing
+	 that, the first one.  */
+      last = first;
+      while (last + 1 < g->count
+	     && (g->fixups[last + 1]->fixp->fx_offset
+		 == g->fixups[first]->fixp->fx_offset))
+	last++;
+      lo = g->fixups[first];
+      for (mid = last + 1; mid-- > first; )
+	if (!mips_lo_fixup_matched_p (g->fixups[mid]))
+	  {
+	    lo = g->fixups[mid];
+	    break;
+	  }
+
+      /* Remove the high-part relocation from its current position and
+	 insert it before the low-part relocation.  Make the offsets match
+	 so that fixup_has_matching_lo_p() will return true.
 
 	 We don't warn about unmatched high-part relocations since some
 	 versions of gcc have been known to emit dead "lui ...%hi(...)"
 	 instructions.  */
-      if (lo_pos != NULL)
+      l->fixp->fx_offset = lo->fixp->fx_offset;
+      if (l->fixp->fx_next != lo->fixp)
 	{
-	  l->fixp->fx_offset = (*lo_pos)->fx_offset;
-	  if (l->fixp->fx_next != *lo_pos)
-	    {
-	      *hi_pos = l->fixp->fx_next;
-	      l->fixp->fx_next = *lo_pos;
-	      *lo_pos = l->fixp;
-	    }
+	  seginfo = seg_info (l->seg);
+
+	  fixp = l->fixp->fx_next;
+	  if (hi->prev)
+	    hi->prev->fx_next = fixp;
+	  else
+	    seginfo->fix_root = fixp;
+	  if (fixp && (next = mips_lookup_frob_fixup (fixups, fixp)) != NULL)
+	    next->prev = hi->prev;
+
+	  if (lo->prev)
+	    lo->prev->fx_next = l->fixp;
+	  else
+	    seginfo->fix_root = l->fixp;
+	  l->fixp->fx_next = lo->fixp;
+	  hi->prev = lo->prev;
+	  lo->prev = l->fixp;
 	}
     }
+
+  htab_delete (lo_groups);
+  htab_delete (fixups);
 }
 
 int
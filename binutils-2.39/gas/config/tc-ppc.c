@@ -976,13 +976,25 @@ ppc_optimize_expr (expressionS *left, operatorT op, expressionS *right)
 /* Whether to target xcoff64/elf64.  */
 static unsigned int ppc_obj64 = BFD_DEFAULT_TARGET_SIZE == 64;
 
-/* A separate obstack for use by ppc_hash, so that we can quickly
-   throw away hash table memory .  */
+/* A separate obstack for use by the opcode hash tables and their
+   entries.  */
 struct obstack insn_obstack;
 
 /* Opcode hash table.  */
 static htab_t ppc_hash;
 
+/* The opcode hash tables built so far, one for each value of ppc_cpu.
+   Code that uses .machine often switches back and forth between a few
+   cpus, so we keep the tables rather than rebuilding them each time.  */
+struct ppc_hash_cache
+{
+  struct ppc_hash_cache *next;
+  ppc_cpu_t cpu;
+  htab_t hash;
+};
+
+static struct ppc_hash_cache *ppc_hash_cache;
+
 #ifdef OBJ_ELF
 /* What type of shared library support to use.  */
 static enum { SHLIB_NONE, SHLIB_PIC, SHLIB_MRELOCATABLE } shlib = SHLIB_NONE;
@@ -1626,6 +1638,28 @@ insn_calloc (size_t n, size_t size)
   return ret;
 }
 
+/* Insert OP into ppc_hash, allocating the entry on insn_obstack.
+   Return true if an opcode with the same name is already present,
+   in which case the table is left unchanged.  */
+
+static bool
+insn_hash_insert (const struct powerpc_opcode *op)
+{
+  string_tuple_t needle = { op->name, NULL };
+  string_tuple_t *elt;
+  void **slot;
+
+  slot = htab_find_slot (ppc_hash, &needle, INSERT);
+  if (*slot != NULL)
+    return true;
+
+  elt = XOBNEW (&insn_obstack, string_tuple_t);
+  elt->key = op->name;
+  elt->value = op;
+  *slot = elt;
+  return false;
+}
+
 /* Insert opcodes into hash tables.  Called at startup and for
    .machine pseudo.  */
 
@@ -1634,19 +1668,26 @@ ppc_setup_opcodes (void)
 {
   const struct powerpc_opcode *op;
   const struct powerpc_opcode *op_end;
+  struct ppc_hash_cache *cache;
+  size_t size;
   bool bad_insn = false;
 
-  if (ppc_hash != NULL)
-    {
-      htab_delete (ppc_hash);
-      _obstack_free (&insn_obstack, NULL);
-    }
+  for (cache = ppc_hash_cache; cache != NULL; cache = cache->next)
+    if (cache->cpu == ppc_cpu)
+      {
+	ppc_hash = cache->hash;
+	return;
+      }
 
-  obstack_begin (&insn_obstack, chunksize);
+  if (ppc_hash_cache == NULL)
+    obstack_begin (&insn_obstack, chunksize);
 
-  /* Insert the opcodes into a hash table.  */
-  ppc_hash = htab_create_alloc (5000, hash_string_tuple, eq_string_tuple,
-				NULL, insn_calloc, NULL);
+  /* Insert the opcodes into a hash table.  Make it big enough to hold
+     every opcode without expanding.  */
+  size = (powerpc_num_opcodes + prefix_num_opcodes
+	  + vle_num_opcodes + spe2_num_opcodes);
+  ppc_hash = htab_create_alloc (size * 4 / 3 + 1, hash_string_tuple,
+				eq_string_tuple, NULL, insn_calloc, NULL);
 
   if (ENABLE_CHECKING)
     {
@@ -1723,7 +1764,7 @@ ppc_setup_opcodes (void)
 
       if ((ppc_cpu & op->flags) != 0
 	  && !(ppc_cpu & op->deprecated)
-	  && str_hash_insert (ppc_hash, op->name, op, 0) != NULL)
+	  && insn_hash_insert (op))
 	{
 	  as_bad (_("duplicate %s"), op->name);
 	  bad_insn = true;
@@ -1732,7 +1773,7 @@ ppc_setup_opcodes (void)
 
   if ((ppc_cpu & PPC_OPCODE_ANY) != 0)
     for (op = powerpc_opcodes; op < op_end; op++)
-      str_hash_insert (ppc_hash, op->name, op, 0);
+      insn_hash_insert (op);
 
   op_end = prefix_opcodes + prefix_num_opcodes;
   for (op = prefix_opcodes; op < op_end; op++)
@@ -1761,7 +1802,7 @@ ppc_setup_opcodes (void)
 
       if ((ppc_cpu & op->flags) != 0
 	  && !(ppc_cpu & op->deprecated)
-	  && str_hash_insert (ppc_hash, op->name, op, 0) != NULL)
+	  && insn_hash_insert (op))
 	{
 	  as_bad (_("duplicate %s"), op->name);
 	  bad_insn = true;
@@ -1770,7 +1811,7 @@ ppc_setup_opcodes (void)
 
   if ((ppc_cpu & PPC_OPCODE_ANY) != 0)
     for (op = prefix_opcodes; op < op_end; op++)
-      str_hash_insert (ppc_hash, op->name, op, 0);
+      insn_hash_insert (op);
 
   op_end = vle_opcodes + vle_num_opcodes;
   for (op = vle_opcodes; op < op_end; op++)
@@ -1800,7 +1841,7 @@ ppc_setup_opcodes (void)
 
       if ((ppc_cpu & op->flags) != 0
 	  && !(ppc_cpu & op->deprecated)
-	  && str_hash_insert (ppc_hash, op->name, op, 0) != NULL)
+	  && insn_hash_insert (op))
 	{
 	  as_bad (_("duplicate %s"), op->name);
 	  bad_insn = true;
@@ -1839,7 +1880,7 @@ ppc_setup_opcodes (void)
 
 	  if ((ppc_cpu & op->flags) != 0
 	      && !(ppc_cpu & op->deprecated)
-	      && str_hash_insert (ppc_hash, op->name, op, 0) != NULL)
+	      && insn_hash_insert (op))
 	    {
 	      as_bad (_("duplicate %s"), op->name);
 	      bad_insn = true;
@@ -1847,11 +1888,17 @@ ppc_setup_opcodes (void)
 	}
 
       for (op = spe2_opcodes; op < op_end; op++)
-	str_hash_insert (ppc_hash, op->name, op, 0);
+	insn_hash_insert (op);
     }
 
   if (bad_insn)
     abort ();
+
+  cache = XOBNEW (&insn_obstack, struct ppc_hash_cache);
+  cache->next = ppc_hash_cache;
+  cache->cpu = ppc_cpu;
+  cache->hash = ppc_hash;
+  ppc_hash_cache = cache;
 }
 
 /* This function is called when the assembler starts up.  It is called
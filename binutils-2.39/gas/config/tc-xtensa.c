@@ -9540,6 +9540,12 @@ static void xg_relax_fixups (struct trampoline_seg *ts)
     }
 }
 
+/* The generation of the walks cached in tc_frag_data.next_align.  It
+   is bumped whenever frags are changed other than by relaxing them in
+   order, which makes all the cached walks stale.  */
+
+static unsigned int next_align_gen = 1;
+
 /* Given a trampoline frag relax all jumps that might want to use this
    trampoline.  Only do real work once per relaxation cycle, when
    xg_relax_trampoline is called for the first trampoline in the now_seg.
@@ -9552,7 +9558,11 @@ static void xg_relax_trampoline (fragS *fragP, long stretch ATTRIBUTE_UNUSED,
   struct trampoline_seg *ts = find_trampoline_seg (now_seg);
 
   if (ts->index.n_entries && ts->index.entry[0] == fragP)
-    xg_relax_fixups (ts);
+    {
+      /* This adds jumps to trampoline frags anywhere in the section.  */
+      next_align_gen++;
+      xg_relax_fixups (ts);
+    }
 }
 
 /* Return the number of bytes added to this fragment, given that the
@@ -9574,6 +9584,7 @@ xtensa_relax_frag (fragS *fragP, long stretch, int *stretched_p)
   file_name = as_where (&line);
   new_logical_line (fragP->fr_file, fragP->fr_line);
 
+  fragP->tc_frag_data.relax_count++;
   fragP->tc_frag_data.unreported_expansion = 0;
 
   switch (fragP->fr_subtype)
@@ -9812,6 +9823,159 @@ relax_frag_for_align (fragS *fragP, long stretch)
 }
 
 
+/* Describe in SUM the walk through FRAGP alone.  Return true if the
+   walk stops at FRAGP.  */
+
+static bool
+next_align_frag_summary (fragS *fragP, struct xtensa_next_align *sum)
+{
+  memset (sum, 0, sizeof (*sum));
+  sum->size = fragP->fr_fix;
+
+  if (fragP->fr_type == rs_fill)
+    {
+      sum->size += fragP->fr_offset * fragP->fr_var;
+      return false;
+    }
+  if (fragP->fr_type != rs_machine_dependent)
+    {
+      /* Just punt if we don't know the type.  */
+      sum->stop_frag = fragP;
+      return true;
+    }
+
+  sum->md_frag = fragP;
+  switch (fragP->fr_subtype)
+    {
+    case RELAX_UNREACHABLE:
+      sum->paddable = true;
+      break;
+
+    case RELAX_FILL_NOP:
+      sum->wide_nops = 1;
+      if (!fragP->tc_frag_data.is_no_density)
+	sum->narrow_nops = 1;
+      break;
+
+    case RELAX_SLOTS:
+      if (fragP->tc_frag_data.slot_subtypes[0] == RELAX_NARROW)
+	{
+	  sum->widens = 1;
+	  break;
+	}
+      sum->size += total_frag_text_expansion (fragP);
+      break;
+
+    case RELAX_IMMED:
+      sum->size += fragP->tc_frag_data.text_expansion[0];
+      break;
+
+    case RELAX_ALIGN_NEXT_OPCODE:
+    case RELAX_DESIRE_ALIGN:
+      sum->stop_frag = fragP;
+      sum->is_align = true;
+      return true;
+
+    case RELAX_MAYBE_UNREACHABLE:
+    case RELAX_MAYBE_DESIRE_ALIGN:
+      /* Do nothing.  */
+      break;
+
+    default:
+      /* Just punt if we don't know the type.  */
+      sum->stop_frag = fragP;
+      return true;
+    }
+
+  return false;
+}
+
+/* Append the walk REST to the walk SUM.  */
+
+static void
+next_align_add (struct xtensa_next_align *sum,
+		const struct xtensa_next_align *rest)
+{
+  if (sum->md_frag == NULL)
+    sum->md_frag = rest->md_frag;
+  sum->stop_frag = rest->stop_frag;
+  sum->is_align = rest->is_align;
+  sum->size += rest->size;
+  sum->wide_nops += rest->wide_nops;
+  sum->narrow_nops += rest->narrow_nops;
+  sum->widens += rest->widens;
+  sum->paddable |= rest->paddable;
+}
+
+/* Cache SUM as the walk starting at FRAGP.  */
+
+static void
+next_align_store (fragS *fragP, struct xtensa_next_align *sum)
+{
+  sum->gen = next_align_gen;
+  sum->md_count = (sum->md_frag != NULL
+		   ? sum->md_frag->tc_frag_data.relax_count : 0);
+  fragP->tc_frag_data.next_align = *sum;
+}
+
+/* Describe in SUM the walk from FRAGP to the next frag to align, using
+   the walks cached in the frags on the way where they are still valid
+   and caching the rest.  */
+
+static void
+next_align_summary (fragS *fragP, struct xtensa_next_align *sum)
+{
+  static fragS **stack;
+  static size_t stack_size;
+  size_t n = 0;
+
+  for (;; fragP = fragP->fr_next)
+    {
+      const struct xtensa_next_align *cached;
+
+      if (fragP == NULL)
+	{
+	  memset (sum, 0, sizeof (*sum));
+	  break;
+	}
+
+      cached = &fragP->tc_frag_data.next_align;
+      if (cached->gen == next_align_gen
+	  && (cached->md_frag == NULL
+	      || (cached->md_frag->tc_frag_data.relax_count
+		  == cached->md_count)))
+	{
+	  *sum = *cached;
+	  break;
+	}
+
+      if (next_align_frag_summary (fragP, sum))
+	{
+	  next_align_store (fragP, sum);
+	  break;
+	}
+
+      if (n == stack_size)
+	{
+	  stack_size = stack_size ? stack_size * 2 : 64;
+	  stack = XRESIZEVEC (fragS *, stack, stack_size);
+	}
+      stack[n++] = fragP;
+    }
+
+  while (n > 0)
+    {
+      struct xtensa_next_align own;
+
+      fragP = stack[--n];
+      next_align_frag_summary (fragP, &own);
+      next_align_add (&own, sum);
+      *sum = own;
+      next_align_store (fragP, sum);
+    }
+}
+
+
 /* Return the address of the next frag that should be aligned.
 
    By "address" we mean the address it _would_ be at if there
@@ -9824,7 +9988,10 @@ relax_frag_for_align (fragS *fragP, long stretch)
    Also, count each frag that may be used to help align the target.
 
    Return 0 if there are no frags left in the chain that need to be
-   aligned.  */
+   aligned.
+
+   *FRAGPP itself may be the frag being relaxed, so it is looked at
+   directly; the rest of the walk comes from next_align_summary.  */
 
 static addressT
 find_address_of_next_align_frag (fragS **fragPP,
@@ -9834,76 +10001,28 @@ find_address_of_next_align_frag (fragS **fragPP,
 				 bool *paddable)
 {
   fragS *fragP = *fragPP;
-  addressT address = fragP->fr_address;
+  struct xtensa_next_align sum, rest;
 
-  /* Do not reset the counts to 0.  */
+  if (fragP == NULL)
+    return 0;
 
-  while (fragP)
+  if (!next_align_frag_summary (fragP, &sum))
     {
-      /* Limit this to a small search.  */
-      if (*widens >= (int) xtensa_fetch_width)
-	{
-	  *fragPP = fragP;
-	  return 0;
-	}
-      address += fragP->fr_fix;
-
-      if (fragP->fr_type == rs_fill)
-	address += fragP->fr_offset * fragP->fr_var;
-      else if (fragP->fr_type == rs_machine_dependent)
-	{
-	  switch (fragP->fr_subtype)
-	    {
-	    case RELAX_UNREACHABLE:
-	      *paddable = true;
-	      break;
-
-	    case RELAX_FILL_NOP:
-	      (*wide_nops)++;
-	      if (!fragP->tc_frag_data.is_no_density)
-		(*narrow_nops)++;
-	      break;
-
-	    case RELAX_SLOTS:
-	      if (fragP->tc_frag_data.slot_subtypes[0] == RELAX_NARROW)
-		{
-		  (*widens)++;
-		  break;
-		}
-	      address += total_frag_text_expansion (fragP);
-	      break;
-
-	    case RELAX_IMMED:
-	      address += fragP->tc_frag_data.text_expansion[0];
-	      break;
-
-	    case RELAX_ALIGN_NEXT_OPCODE:
-	    case RELAX_DESIRE_ALIGN:
-	      *fragPP = fragP;
-	      return address;
-
-	    case RELAX_MAYBE_UNREACHABLE:
-	    case RELAX_MAYBE_DESIRE_ALIGN:
-	      /* Do nothing.  */
-	      break;
-
-	    default:
-	      /* Just punt if we don't know the type.  */
-	      *fragPP = fragP;
-	      return 0;
-	    }
-	}
-      else
-	{
-	  /* Just punt if we don't know the type.  */
-	  *fragPP = fragP;
-	  return 0;
-	}
-      fragP = fragP->fr_next;
+      next_align_summary (fragP->fr_next, &rest);
+      next_align_add (&sum, &rest);
     }
+  *fragPP = sum.stop_frag;
 
-  *fragPP = fragP;
-  return 0;
+  /* Limit this to a small search.  Do not reset the counts to 0.  */
+  if (!sum.is_align || *widens + sum.widens >= (int) xtensa_fetch_width)
+    return 0;
+
+  *wide_nops += sum.wide_nops;
+  *narrow_nops += sum.narrow_nops;
+  *widens += sum.widens;
+  if (sum.paddable)
+    *paddable = true;
+  return fragP->fr_address + sum.size;
 }
 
 
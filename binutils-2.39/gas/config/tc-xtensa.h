@@ -193,6 +193,35 @@ enum xtensa_relax_statesE
    can be taken.  */
 #define RELAX_IMMED_MAXSTEPS (RELAX_IMMED_STEP3 - RELAX_IMMED)
 
+/* What find_address_of_next_align_frag learns by walking forward from
+   a frag to the next frag that should be aligned.  Relaxation visits
+   the frags of a section in order, so the walk from a frag can only
+   change once MD_FRAG, the first machine-dependent frag it covers, has
+   been relaxed again.  */
+
+struct xtensa_next_align
+{
+  /* The summary is valid while GEN matches the current generation and
+     MD_FRAG's relax_count is still MD_COUNT.  */
+  unsigned int gen;
+  unsigned int md_count;
+  fragS *md_frag;
+
+  /* The frag where the walk stops, and whether it is one to align.  */
+  fragS *stop_frag;
+  bool is_align;
+
+  /* The bytes from here up to and including the fixed part of
+     STOP_FRAG, if no frag on the way is widened or padded.  */
+  addressT size;
+
+  /* The frags on the way that can help to align STOP_FRAG.  */
+  int wide_nops;
+  int narrow_nops;
+  int widens;
+  bool paddable;
+};
+
 struct xtensa_frag_type
 {
   /* Info about the current state of assembly, e.g., transform,
@@ -280,6 +309,12 @@ struct xtensa_frag_type
      cache the last one in the chain, so that we can skip to the
      end of the chain.  */
   fragS *no_transform_end;
+
+  /* The number of times xtensa_relax_frag has looked at this frag.  */
+  unsigned int relax_count;
+
+  /* The cached walk to the next frag to align, starting here.  */
+  struct xtensa_next_align next_align;
 };
 
 
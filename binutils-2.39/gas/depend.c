@@ -20,9 +20,12 @@
 
 #include "as.h"
 #include "filenames.h"
+#include "safe-ctype.h"
 #include "sha1.h"
 #include "sha256.h"
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 
 #define GITOID_LENGTH_SHA1 20
 #define GITOID_LENGTH_SHA256 32
@@ -52,6 +55,8 @@ static int column = 0;
 
 static int quote_string_for_make (FILE *, const char *);
 static void wrap_output (FILE *, const char *, int);
+static bool omnibor_gitoid_from_hex (const char *, unsigned, unsigned char *);
+static bool omnibor_pack_contains (const char *, const char *, unsigned);
 
 /* Number of columns allowable.  */
 #define MAX_COLUMNS 72
@@ -1326,6 +1331,19 @@ create_omnibor_document_file (char **name, const char *result_dir,
         }
     }
 
+  /* A Document which has already been packed is not written again.  */
+  if (omnibor_pack_contains (path_sha, *name, hash_size))
+    {
+      closedir (dir_three);
+      closedir (dir_two);
+      close_all_directories_in_path ();
+      if (result_dir && dir_one)
+        closedir (dir_one);
+      free (path_sha);
+      free (path_objects);
+      return;
+    }
+
   int dfd3 = dirfd (dir_three);
   char *name_substr = (char *) xcalloc (1, sizeof (char));
   omnibor_substr (&name_substr, 0, 2, *name);
@@ -1632,7 +1650,7 @@ write_sha256_omnibor (char **name, const char *result_dir)
 /* Create the file which connects the SHA1 OmniBOR Document file for the
    output file and the SHA1 id of that output file.  */
 
-void
+static void
 omnibor_create_file_no_embed_sha1 (const char *gitoid_sha1, char *res_dir)
 {
   static const char *const lut = "0123456789abcdef";
@@ -1762,7 +1780,7 @@ omnibor_create_file_no_embed_sha1 (const char *gitoid_sha1, char *res_dir)
 /* Create the file which connects the SHA256 OmniBOR Document file for the
    output file and the SHA256 id of that output file.  */
 
-void
+static void
 omnibor_create_file_no_embed_sha256 (const char *gitoid_sha256, char *res_dir)
 {
   static const char *const lut = "0123456789abcdef";
@@ -1888,3 +1906,824 @@ omnibor_create_file_no_embed_sha256 (const char *gitoid_sha256, char *res_dir)
   free (high_ch);
   free (gitoid_obj_sha256);
 }
+
+/* In the no-embed mode the output files are by default connected to their
+   OmniBOR Document files through one packed index per hash function,
+   mapping/gitoid_blob_sha1.idx and mapping/gitoid_blob_sha256.idx, rather
+   than through one tiny file per object file.  An index consists of an
+   OMNIBOR_INDEX_HEADER_SIZE byte header followed by fixed size records:
+
+     bytes 0-7    magic, OMNIBOR_INDEX_MAGIC
+     bytes 8-11   version, OMNIBOR_INDEX_VERSION (big endian)
+     bytes 12-15  gitoid length in bytes (big endian)
+     bytes 16-19  number of leading records sorted by key (big endian)
+     bytes 20-23  reserved, zero
+
+   Each record is the raw gitoid of an object file (the key) followed by
+   the raw gitoid of its OmniBOR Document file.  The leading sorted records
+   have unique keys and can be binary searched; records after them were
+   appended in order and a later one overrides any earlier record with the
+   same key.  Writers hold a write lock on the whole file.  Once the
+   unsorted tail grows large enough a writer merges it back into the sorted
+   part in a new file, which it renames over the index, so readers, which
+   can simply mmap the file, always see a complete index and need no lock.
+   A writer must check after taking the lock that its file is still the
+   index.  Setting the OMNIBOR_MAPPING_FILES environment variable selects
+   the old layout of one file per object file instead.  */
+
+#define OMNIBOR_INDEX_MAGIC "OMNIBIDX"
+#define OMNIBOR_INDEX_VERSION 1
+#define OMNIBOR_INDEX_HEADER_SIZE 24
+#define OMNIBOR_INDEX_MIN_TAIL 256
+
+/* Calculate the gitoid of the SIZE bytes at CONTENTS, using SHA1 if
+   HASH_SIZE is GITOID_LENGTH_SHA1 and SHA256 otherwise.  Unlike
+   calculate_sha1_omnibor_with_contents, CONTENTS need not be a string.  */
+
+static void
+calculate_omnibor_gitoid_of_buffer (const char *contents, size_t size,
+				    unsigned hash_size, unsigned char resblock[])
+{
+  char init_data[MAX_FILE_SIZE_STRING_LENGTH + sizeof "blob "];
+  int init_len = sprintf (init_data, "blob %lu", (unsigned long) size) + 1;
+
+  if (hash_size == GITOID_LENGTH_SHA1)
+    {
+      struct sha1_ctx ctx;
+
+      sha1_init_ctx (&ctx);
+      sha1_process_bytes (init_data, init_len, &ctx);
+      sha1_process_bytes (contents, size, &ctx);
+      sha1_finish_ctx (&ctx, resblock);
+    }
+  else
+    {
+      struct sha256_ctx ctx;
+
+      sha256_init_ctx (&ctx);
+      sha256_process_bytes (init_data, init_len, &ctx);
+      sha256_process_bytes (contents, size, &ctx);
+      sha256_finish_ctx (&ctx, resblock);
+    }
+}
+
+/* Read the whole of the file FILENAME into a freshly allocated buffer,
+   storing its size in *SIZE.  Return NULL if the file cannot be read.  */
+
+static char *
+omnibor_read_file (const char *filename, size_t *size)
+{
+  FILE *file = fopen (filename, FOPEN_RB);
+  if (file == NULL)
+    return NULL;
+
+  fseek (file, 0L, SEEK_END);
+  long file_size = ftell (file);
+  fseek (file, 0L, SEEK_SET);
+  if (file_size < 0)
+    {
+      fclose (file);
+      return NULL;
+    }
+
+  char *file_contents = (char *) xmalloc (file_size + 1);
+  size_t got = fread (file_contents, 1, file_size, file);
+  fclose (file);
+  if (got != (size_t) file_size)
+    {
+      free (file_contents);
+      return NULL;
+    }
+
+  *size = file_size;
+  return file_contents;
+}
+
+/* Calculate both the SHA1 and the SHA256 gitoid of the given file, reading
+   it only once.  Return false if the file cannot be read.  */
+
+static bool
+calculate_omnibor_gitoids (const char *filename, unsigned char sha1[],
+			   unsigned char sha256[])
+{
+  size_t size;
+  char *contents = omnibor_read_file (filename, &size);
+  if (contents == NULL)
+    return false;
+
+  calculate_omnibor_gitoid_of_buffer (contents, size, GITOID_LENGTH_SHA1,
+				      sha1);
+  calculate_omnibor_gitoid_of_buffer (contents, size, GITOID_LENGTH_SHA256,
+				      sha256);
+  free (contents);
+  return true;
+}
+
+/* Convert the hexadecimal gitoid HEX into HASH_SIZE raw bytes in RAW.
+   Return false if HEX is not a valid gitoid.  */
+
+static bool
+omnibor_gitoid_from_hex (const char *hex, unsigned hash_size,
+			 unsigned char *raw)
+{
+  for (unsigned i = 0; i < hash_size; i++)
+    {
+      if (!ISXDIGIT (hex[2 * i]) || !ISXDIGIT (hex[2 * i + 1]))
+	return false;
+      raw[i] = (hex_value (hex[2 * i]) << 4) | hex_value (hex[2 * i + 1]);
+    }
+  return true;
+}
+
+static bool
+omnibor_index_read (int fd, off_t pos, void *buf, size_t len)
+{
+  return pread (fd, buf, len, pos) == (ssize_t) len;
+}
+
+static bool
+omnibor_index_write (int fd, off_t pos, const void *buf, size_t len)
+{
+  return pwrite (fd, buf, len, pos) == (ssize_t) len;
+}
+
+static bool
+omnibor_index_write_header (int fd, unsigned hash_size, unsigned long sorted)
+{
+  unsigned char header[OMNIBOR_INDEX_HEADER_SIZE];
+
+  memset (header, 0, sizeof header);
+  memcpy (header, OMNIBOR_INDEX_MAGIC, 8);
+  bfd_putb32 (OMNIBOR_INDEX_VERSION, header + 8);
+  bfd_putb32 (hash_size, header + 12);
+  bfd_putb32 (sorted, header + 16);
+  return omnibor_index_write (fd, 0, header, sizeof header);
+}
+
+/* Look KEY up in the index open on FD, which holds COUNT records of which
+   the first SORTED are sorted.  If it is found, store the associated
+   Document gitoid in DOC and return true.  */
+
+static bool
+omnibor_index_lookup (int fd, unsigned hash_size, unsigned long sorted,
+		      unsigned long count, const unsigned char *key,
+		      unsigned char *doc)
+{
+  size_t rec_size = 2 * hash_size;
+  unsigned char *rec;
+
+  /* The unsorted tail is short, and its last matching record wins.  */
+  if (count > sorted)
+    {
+      size_t tail_size = (count - sorted) * rec_size;
+      unsigned char *tail = (unsigned char *) xmalloc (tail_size);
+
+      if (omnibor_index_read (fd, OMNIBOR_INDEX_HEADER_SIZE
+			      + sorted * rec_size, tail, tail_size))
+	for (rec = tail + tail_size; rec != tail; )
+	  {
+	    rec -= rec_size;
+	    if (memcmp (rec, key, hash_size) == 0)
+	      {
+		memcpy (doc, rec + hash_size, hash_size);
+		free (tail);
+		return true;
+	      }
+	  }
+      free (tail);
+    }
+
+  rec = (unsigned char *) xmalloc (rec_size);
+  unsigned long lo = 0, hi = sorted;
+  while (lo < hi)
+    {
+      unsigned long mid = lo + (hi - lo) / 2;
+      int cmp;
+
+      if (!omnibor_index_read (fd, OMNIBOR_INDEX_HEADER_SIZE
+			       + mid * rec_size, rec, rec_size))
+	break;
+      cmp = memcmp (key, rec, hash_size);
+      if (cmp == 0)
+	{
+	  memcpy (doc, rec + hash_size, hash_size);
+	  free (rec);
+	  return true;
+	}
+      if (cmp < 0)
+	hi = mid;
+      else
+	lo = mid + 1;
+    }
+  free (rec);
+  return false;
+}
+
+/* Records being sorted by omnibor_index_compact, and the length of their
+   keys.  */
+static const unsigned char *omnibor_index_records;
+static unsigned omnibor_index_key_size;
+
+/* qsort comparison function for record numbers: order by key, and records
+   with equal keys by their position in the index.  */
+
+static int
+compare_omnibor_index_records (const void *a, const void *b)
+{
+  unsigned long ia = *(const unsigned long *) a;
+  unsigned long ib = *(const unsigned long *) b;
+  int cmp = memcmp (omnibor_index_records + ia * 2 * omnibor_index_key_size,
+		    omnibor_index_records + ib * 2 * omnibor_index_key_size,
+		    omnibor_index_key_size);
+
+  if (cmp != 0)
+    return cmp;
+  return ia < ib ? -1 : ia > ib;
+}
+
+/* Rewrite the COUNT records of the index PATH open on FD as one sorted
+   run, keeping only the last record appended for each key.  The new index
+   is written to a temporary file which then replaces PATH, so that a crash
+   cannot leave a partly rewritten index behind.  The caller holds the lock
+   on FD, which keeps other writers away from the temporary file too.  */
+
+static void
+omnibor_index_compact (int fd, const char *path, unsigned hash_size,
+		       unsigned long count)
+{
+  size_t rec_size = 2 * hash_size;
+  unsigned char *records = (unsigned char *) xmalloc (count * rec_size);
+
+  if (!omnibor_index_read (fd, OMNIBOR_INDEX_HEADER_SIZE, records,
+			   count * rec_size))
+    {
+      free (records);
+      return;
+    }
+
+  unsigned long *order = XNEWVEC (unsigned long, count);
+  for (unsigned long i = 0; i < count; i++)
+    order[i] = i;
+  omnibor_index_records = records;
+  omnibor_index_key_size = hash_size;
+  qsort (order, count, sizeof (*order), compare_omnibor_index_records);
+
+  unsigned char *merged = (unsigned char *) xmalloc (count * rec_size);
+  unsigned long n = 0;
+  for (unsigned long i = 0; i < count; i++)
+    {
+      const unsigned char *rec = records + order[i] * rec_size;
+
+      if (i + 1 < count
+	  && memcmp (rec, records + order[i + 1] * rec_size, hash_size) == 0)
+	continue;
+      memcpy (merged + n++ * rec_size, rec, rec_size);
+    }
+
+  char *path_tmp = concat (path, ".tmp", (const char *) NULL);
+  int tmp_fd = open (path_tmp, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (tmp_fd >= 0)
+    {
+      bool ok = (omnibor_index_write_header (tmp_fd, hash_size, n)
+		 && omnibor_index_write (tmp_fd, OMNIBOR_INDEX_HEADER_SIZE,
+					 merged, n * rec_size)
+		 && fsync (tmp_fd) == 0);
+
+      if (close (tmp_fd) != 0)
+	ok = false;
+      if (!ok || rename (path_tmp, path) != 0)
+	unlink (path_tmp);
+    }
+  free (path_tmp);
+
+  free (merged);
+  free (order);
+  free (records);
+}
+
+/* Record in the index file PATH that the object file whose gitoid is OBJ
+   is described by the OmniBOR Document file whose gitoid is DOC.  */
+
+static void
+omnibor_index_add (const char *path, unsigned hash_size,
+		   const unsigned char *obj, const unsigned char *doc)
+{
+  struct stat st;
+  int fd;
+
+  for (;;)
+    {
+      struct stat path_st;
+
+      fd = open (path, O_RDWR | O_CREAT, 0666);
+      if (fd < 0)
+	return;
+
+      struct flock lock;
+      memset (&lock, 0, sizeof lock);
+      lock.l_type = F_WRLCK;
+      lock.l_whence = SEEK_SET;
+      while (fcntl (fd, F_SETLKW, &lock) != 0)
+	if (errno != EINTR)
+	  {
+	    close (fd);
+	    return;
+	  }
+
+      if (fstat (fd, &st) != 0)
+	{
+	  close (fd);
+	  return;
+	}
+
+      /* While we waited for the lock, a compaction may have replaced the
+	 file we opened.  */
+      if (stat (path, &path_st) == 0
+	  && path_st.st_dev == st.st_dev
+	  && path_st.st_ino == st.st_ino)
+	break;
+      close (fd);
+    }
+
+  size_t rec_size = 2 * hash_size;
+  unsigned char header[OMNIBOR_INDEX_HEADER_SIZE];
+  unsigned long count = 0, sorted = 0;
+
+  if (st.st_size < OMNIBOR_INDEX_HEADER_SIZE)
+    {
+      /* A new index, or one whose creator died before writing the
+	 header.  */
+      if (ftruncate (fd, 0) != 0
+	  || !omnibor_index_write_header (fd, hash_size, 0))
+	goto out;
+    }
+  else
+    {
+      /* Leave alone anything that is not an index we understand.  */
+      if (!omnibor_index_read (fd, 0, header, sizeof header)
+	  || memcmp (header, OMNIBOR_INDEX_MAGIC, 8) != 0
+	  || bfd_getb32 (header + 8) != OMNIBOR_INDEX_VERSION
+	  || bfd_getb32 (header + 12) != hash_size)
+	goto out;
+      /* A partial record left by an interrupted writer is dropped.  */
+      count = (st.st_size - OMNIBOR_INDEX_HEADER_SIZE) / rec_size;
+      sorted = bfd_getb32 (header + 16);
+      if (sorted > count)
+	sorted = count;
+    }
+
+  unsigned char *old_doc = (unsigned char *) xmalloc (hash_size);
+  bool present = (omnibor_index_lookup (fd, hash_size, sorted, count, obj,
+					old_doc)
+		  && memcmp (old_doc, doc, hash_size) == 0);
+  free (old_doc);
+  if (present)
+    goto out;
+
+  unsigned char *rec = (unsigned char *) xmalloc (rec_size);
+  memcpy (rec, obj, hash_size);
+  memcpy (rec + hash_size, doc, hash_size);
+  if (omnibor_index_write (fd, OMNIBOR_INDEX_HEADER_SIZE + count * rec_size,
+			   rec, rec_size))
+    {
+      unsigned long max_tail = sorted / 16;
+
+      if (max_tail < OMNIBOR_INDEX_MIN_TAIL)
+	max_tail = OMNIBOR_INDEX_MIN_TAIL;
+      count++;
+      if (count - sorted > max_tail)
+	omnibor_index_compact (fd, path, hash_size, count);
+    }
+  free (rec);
+
+ out:
+  /* Closing the file releases the lock.  */
+  close (fd);
+}
+
+/* Connect the output file to its SHA1 and SHA256 OmniBOR Document files,
+   whose gitoids are GITOID_SHA1 and GITOID_SHA256, in the RES_DIR
+   directory.  */
+
+void
+omnibor_create_mapping_no_embed (const char *gitoid_sha1,
+				 const char *gitoid_sha256, char *res_dir)
+{
+  if (getenv ("OMNIBOR_MAPPING_FILES") != NULL)
+    {
+      omnibor_create_file_no_embed_sha1 (gitoid_sha1, res_dir);
+      omnibor_create_file_no_embed_sha256 (gitoid_sha256, res_dir);
+      return;
+    }
+
+  if (strcmp ("", res_dir) == 0)
+    return;
+
+  unsigned char obj_sha1[GITOID_LENGTH_SHA1];
+  unsigned char obj_sha256[GITOID_LENGTH_SHA256];
+  unsigned char doc_sha1[GITOID_LENGTH_SHA1];
+  unsigned char doc_sha256[GITOID_LENGTH_SHA256];
+
+  if (!omnibor_gitoid_from_hex (gitoid_sha1, GITOID_LENGTH_SHA1, doc_sha1)
+      || !omnibor_gitoid_from_hex (gitoid_sha256, GITOID_LENGTH_SHA256,
+				   doc_sha256)
+      || !calculate_omnibor_gitoids (out_file_name, obj_sha1, obj_sha256))
+    return;
+
+  char *path_mapping = concat (res_dir, "/mapping", (const char *) NULL);
+  mkdir (path_mapping, S_IRWXU);
+
+  char *path_index = concat (path_mapping, "/gitoid_blob_sha1.idx",
+			     (const char *) NULL);
+  omnibor_index_add (path_index, GITOID_LENGTH_SHA1, obj_sha1, doc_sha1);
+  free (path_index);
+
+  path_index = concat (path_mapping, "/gitoid_blob_sha256.idx",
+		       (const char *) NULL);
+  omnibor_index_add (path_index, GITOID_LENGTH_SHA256, obj_sha256,
+		     doc_sha256);
+  free (path_index);
+  free (path_mapping);
+}
+
+/* The loose OmniBOR Document files in objects/gitoid_blob_sha1 and
+   objects/gitoid_blob_sha256 can be compacted (see omnibor_pack_objects)
+   into a single pack file per hash function, OMNIBOR_PACK_NAME in the same
+   directory.  A pack consists of an OMNIBOR_PACK_HEADER_SIZE byte header,
+   an index sorted by gitoid and then the contents of the Documents:
+
+     bytes 0-7    magic, OMNIBOR_PACK_MAGIC
+     bytes 8-11   version, OMNIBOR_PACK_VERSION (big endian)
+     bytes 12-15  gitoid length in bytes (big endian)
+     bytes 16-19  number of Documents (big endian)
+     bytes 20-23  reserved, zero
+
+   Each index entry is the raw gitoid of a Document followed by the
+   offset of its contents from the start of the pack and their size, both
+   as 64-bit big endian numbers.  A pack is never modified once written;
+   a later compaction replaces it atomically, so readers need no lock.  */
+
+#define OMNIBOR_PACK_NAME "omnibor.pack"
+#define OMNIBOR_PACK_MAGIC "OMNIBPAK"
+#define OMNIBOR_PACK_VERSION 1
+#define OMNIBOR_PACK_HEADER_SIZE 24
+
+static void
+omnibor_put64 (uint64_t val, unsigned char *buf)
+{
+  bfd_putb32 (val >> 32, buf);
+  bfd_putb32 (val & 0xffffffff, buf + 4);
+}
+
+static uint64_t
+omnibor_get64 (const unsigned char *buf)
+{
+  return ((uint64_t) bfd_getb32 (buf) << 32) | bfd_getb32 (buf + 4);
+}
+
+/* Return true if the pack open on FD holds the Document whose raw gitoid
+   is KEY.  */
+
+static bool
+omnibor_pack_find (int fd, const unsigned char *key, unsigned hash_size)
+{
+  bool found = false;
+  unsigned char header[OMNIBOR_PACK_HEADER_SIZE];
+  if (omnibor_index_read (fd, 0, header, sizeof header)
+      && memcmp (header, OMNIBOR_PACK_MAGIC, 8) == 0
+      && bfd_getb32 (header + 8) == OMNIBOR_PACK_VERSION
+      && bfd_getb32 (header + 12) == hash_size)
+    {
+      size_t entry_size = hash_size + 16;
+      unsigned char entry[GITOID_LENGTH_SHA256 + 16];
+      unsigned long lo = 0, hi = bfd_getb32 (header + 16);
+
+      while (lo < hi)
+	{
+	  unsigned long mid = lo + (hi - lo) / 2;
+	  int cmp;
+
+	  if (!omnibor_index_read (fd, OMNIBOR_PACK_HEADER_SIZE
+				   + mid * entry_size, entry, entry_size))
+	    break;
+	  cmp = memcmp (key, entry, hash_size);
+	  if (cmp == 0)
+	    {
+	      found = true;
+	      break;
+	    }
+	  if (cmp < 0)
+	    hi = mid;
+	  else
+	    lo = mid + 1;
+	}
+    }
+
+  return found;
+}
+
+/* Return true if the pack in the directory PATH_SHA holds the Document
+   whose hexadecimal gitoid is NAME.  */
+
+static bool
+omnibor_pack_contains (const char *path_sha, const char *name,
+		       unsigned hash_size)
+{
+  unsigned char key[GITOID_LENGTH_SHA256];
+  if (!omnibor_gitoid_from_hex (name, hash_size, key))
+    return false;
+
+  char *path_pack = concat (path_sha, "/" OMNIBOR_PACK_NAME,
+			    (const char *) NULL);
+  int fd = open (path_pack, O_RDONLY);
+  free (path_pack);
+  if (fd < 0)
+    return false;
+
+  bool found = omnibor_pack_find (fd, key, hash_size);
+  close (fd);
+  return found;
+}
+
+/* A Document being packed by omnibor_pack_directory.  */
+
+struct omnibor_pack_entry
+{
+  unsigned char gitoid[GITOID_LENGTH_SHA256];
+  const char *contents;
+  uint64_t size;
+  /* The loose file holding the Document, or NULL if it came from the
+     previous pack.  CONTENTS is malloced in the former case.  */
+  char *loose_path;
+};
+
+static unsigned omnibor_pack_key_size;
+
+static int
+compare_omnibor_pack_entries (const void *a, const void *b)
+{
+  const struct omnibor_pack_entry *ea = (const struct omnibor_pack_entry *) a;
+  const struct omnibor_pack_entry *eb = (const struct omnibor_pack_entry *) b;
+  int cmp = memcmp (ea->gitoid, eb->gitoid, omnibor_pack_key_size);
+
+  if (cmp != 0)
+    return cmp;
+  /* Prefer the previous pack, so that the loose copy gets removed.  */
+  return (ea->loose_path != NULL) - (eb->loose_path != NULL);
+}
+
+/* Add the Document files from the previous pack in PACK, of PACK_SIZE
+   bytes, to ENTRIES.  */
+
+static void
+omnibor_pack_add_old (const char *pack, size_t pack_size, unsigned hash_size,
+		      struct omnibor_pack_entry **entries, size_t *count,
+		      size_t *alloc)
+{
+  if (pack_size < OMNIBOR_PACK_HEADER_SIZE
+      || memcmp (pack, OMNIBOR_PACK_MAGIC, 8) != 0
+      || bfd_getb32 ((const unsigned char *) pack + 8) != OMNIBOR_PACK_VERSION
+      || bfd_getb32 ((const unsigned char *) pack + 12) != hash_size)
+    return;
+
+  size_t entry_size = hash_size + 16;
+  unsigned long n = bfd_getb32 ((const unsigned char *) pack + 16);
+  if (n > (pack_size - OMNIBOR_PACK_HEADER_SIZE) / entry_size)
+    return;
+
+  for (unsigned long i = 0; i < n; i++)
+    {
+      const unsigned char *entry = ((const unsigned char *) pack
+				    + OMNIBOR_PACK_HEADER_SIZE
+				    + i * entry_size);
+      uint64_t offset = omnibor_get64 (entry + hash_size);
+      uint64_t size = omnibor_get64 (entry + hash_size + 8);
+
+      if (offset > pack_size || size > pack_size - offset)
+	continue;
+      if (*count == *alloc)
+	{
+	  *alloc = *alloc * 2 + 64;
+	  *entries = XRESIZEVEC (struct omnibor_pack_entry, *entries, *alloc);
+	}
+      struct omnibor_pack_entry *e = &(*entries)[(*count)++];
+      memcpy (e->gitoid, entry, hash_size);
+      e->contents = pack + offset;
+      e->size = size;
+      e->loose_path = NULL;
+    }
+}
+
+/* Pack the loose Document files in the directory PATH_SHA, together with
+   the contents of its existing pack, into a new pack.  Loose files whose
+   contents do not match their name, for instance because another
+   assembler is still writing them, are left alone.  Assemblers writing
+   Documents take no lock, so the directories holding the loose files are
+   never removed: one may be about to create a file in them.  Return false
+   on error.  */
+
+static bool
+omnibor_pack_directory (const char *path_sha, unsigned hash_size)
+{
+  DIR *dir_sha = opendir (path_sha);
+  if (dir_sha == NULL)
+    return errno == ENOENT;
+
+  /* Serialize compactions of the same directory.  */
+  char *path_lock = concat (path_sha, "/" OMNIBOR_PACK_NAME ".lock",
+			    (const char *) NULL);
+  int lock_fd = open (path_lock, O_RDWR | O_CREAT, 0666);
+  free (path_lock);
+  if (lock_fd < 0)
+    {
+      closedir (dir_sha);
+      return false;
+    }
+  struct flock lock;
+  memset (&lock, 0, sizeof lock);
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  while (fcntl (lock_fd, F_SETLKW, &lock) != 0)
+    if (errno != EINTR)
+      {
+	close (lock_fd);
+	closedir (dir_sha);
+	return false;
+      }
+
+  char *path_pack = concat (path_sha, "/" OMNIBOR_PACK_NAME,
+			    (const char *) NULL);
+  size_t old_size = 0;
+  char *old_pack = omnibor_read_file (path_pack, &old_size);
+
+  struct omnibor_pack_entry *entries = NULL;
+  size_t count = 0, alloc = 0;
+
+  if (old_pack != NULL)
+    omnibor_pack_add_old (old_pack, old_size, hash_size, &entries, &count,
+			  &alloc);
+
+  struct dirent *d_prefix;
+  while ((d_prefix = readdir (dir_sha)) != NULL)
+    {
+      if (strlen (d_prefix->d_name) != 2
+	  || !ISXDIGIT (d_prefix->d_name[0]) || !ISXDIGIT (d_prefix->d_name[1]))
+	continue;
+
+      char *path_prefix = concat (path_sha, "/", d_prefix->d_name,
+				  (const char *) NULL);
+      DIR *dir_prefix = opendir (path_prefix);
+      if (dir_prefix == NULL)
+	{
+	  free (path_prefix);
+	  continue;
+	}
+
+      struct dirent *d_doc;
+      while ((d_doc = readdir (dir_prefix)) != NULL)
+	{
+	  char name[2 * GITOID_LENGTH_SHA256 + 1];
+	  unsigned char gitoid[GITOID_LENGTH_SHA256];
+	  unsigned char resblock[GITOID_LENGTH_SHA256];
+
+	  if (strlen (d_doc->d_name) != 2 * hash_size - 2)
+	    continue;
+	  sprintf (name, "%s%s", d_prefix->d_name, d_doc->d_name);
+	  if (!omnibor_gitoid_from_hex (name, hash_size, gitoid))
+	    continue;
+
+	  char *loose_path = concat (path_prefix, "/", d_doc->d_name,
+				     (const char *) NULL);
+	  size_t size;
+	  char *contents = omnibor_read_file (loose_path, &size);
+	  if (contents == NULL)
+	    {
+	      free (loose_path);
+	      continue;
+	    }
+	  calculate_omnibor_gitoid_of_buffer (contents, size, hash_size,
+					      resblock);
+	  if (memcmp (resblock, gitoid, hash_size) != 0)
+	    {
+	      free (contents);
+	      free (loose_path);
+	      continue;
+	    }
+
+	  if (count == alloc)
+	    {
+	      alloc = alloc * 2 + 64;
+	      entries = XRESIZEVEC (struct omnibor_pack_entry, entries, alloc);
+	    }
+	  struct omnibor_pack_entry *e = &entries[count++];
+	  memcpy (e->gitoid, gitoid, hash_size);
+	  e->contents = contents;
+	  e->size = size;
+	  e->loose_path = loose_path;
+	}
+      closedir (dir_prefix);
+      free (path_prefix);
+    }
+  closedir (dir_sha);
+
+  omnibor_pack_key_size = hash_size;
+  qsort (entries, count, sizeof (*entries), compare_omnibor_pack_entries);
+
+  /* Write the new pack next to the old one and rename it into place.  */
+  size_t entry_size = hash_size + 16;
+  size_t num_unique = 0;
+  for (size_t i = 0; i < count; i++)
+    if (i == 0 || memcmp (entries[i].gitoid, entries[i - 1].gitoid,
+			  hash_size) != 0)
+      num_unique++;
+
+  bool ok = false;
+  char *path_tmp = concat (path_pack, ".tmp", (const char *) NULL);
+  FILE *pack = fopen (path_tmp, FOPEN_WB);
+  if (pack != NULL)
+    {
+      unsigned char header[OMNIBOR_PACK_HEADER_SIZE];
+      unsigned char entry[GITOID_LENGTH_SHA256 + 16];
+      uint64_t offset = (OMNIBOR_PACK_HEADER_SIZE
+			 + (uint64_t) num_unique * entry_size);
+
+      memset (header, 0, sizeof header);
+      memcpy (header, OMNIBOR_PACK_MAGIC, 8);
+      bfd_putb32 (OMNIBOR_PACK_VERSION, header + 8);
+      bfd_putb32 (hash_size, header + 12);
+      bfd_putb32 (num_unique, header + 16);
+      ok = fwrite (header, sizeof header, 1, pack) == 1;
+
+      for (size_t i = 0; ok && i < count; i++)
+	if (i == 0 || memcmp (entries[i].gitoid, entries[i - 1].gitoid,
+			      hash_size) != 0)
+	  {
+	    memcpy (entry, entries[i].gitoid, hash_size);
+	    omnibor_put64 (offset, entry + hash_size);
+	    omnibor_put64 (entries[i].size, entry + hash_size + 8);
+	    ok = fwrite (entry, entry_size, 1, pack) == 1;
+	    offset += entries[i].size;
+	  }
+
+      for (size_t i = 0; ok && i < count; i++)
+	if ((i == 0 || memcmp (entries[i].gitoid, entries[i - 1].gitoid,
+			       hash_size) != 0)
+	    && entries[i].size != 0)
+	  ok = fwrite (entries[i].contents, entries[i].size, 1, pack) == 1;
+
+      /* Make sure the contents are on disk before the pack replaces
+	 the loose files.  */
+      if (ok)
+	ok = fflush (pack) == 0 && fsync (fileno (pack)) == 0;
+      if (fclose (pack) != 0)
+	ok = false;
+      if (ok)
+	ok = rename (path_tmp, path_pack) == 0;
+      if (!ok)
+	unlink (path_tmp);
+    }
+
+  /* Only now that the pack is in place can the loose files go, and only
+     those which it holds.  */
+  int pack_fd = ok ? open (path_pack, O_RDONLY) : -1;
+  for (size_t i = 0; i < count; i++)
+    if (entries[i].loose_path != NULL)
+      {
+	if (pack_fd >= 0
+	    && omnibor_pack_find (pack_fd, entries[i].gitoid, hash_size))
+	  unlink (entries[i].loose_path);
+	free (entries[i].loose_path);
+	free ((char *) entries[i].contents);
+      }
+  if (pack_fd >= 0)
+    close (pack_fd);
+
+  free (entries);
+  free (path_tmp);
+  free (old_pack);
+  free (path_pack);
+  close (lock_fd);
+  return ok;
+}
+
+/* Pack the loose OmniBOR Document files stored in the directory RES_DIR,
+   both the SHA1 and the SHA256 ones.  Return false on error.  */
+
+bool
+omnibor_pack_objects (const char *res_dir)
+{
+  struct stat st;
+  if (stat (res_dir, &st) != 0 || !S_ISDIR (st.st_mode))
+    return false;
+
+  char *path_sha = concat (res_dir, "/objects/gitoid_blob_sha1",
+			   (const char *) NULL);
+  bool ok = omnibor_pack_directory (path_sha, GITOID_LENGTH_SHA1);
+  free (path_sha);
+
+  path_sha = concat (res_dir, "/objects/gitoid_blob_sha256",
+		     (const char *) NULL);
+  ok &= omnibor_pack_directory (path_sha, GITOID_LENGTH_SHA256);
+  free (path_sha);
+  return ok;
+}
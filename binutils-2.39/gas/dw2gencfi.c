@@ -768,19 +768,27 @@ static unsigned
 cfi_parse_reg (void)
 {
   int regno;
+  offsetT value;
   expressionS exp;
 
-  tc_parse_to_dw2regnum (&exp);
-  switch (exp.X_op)
+  /* A plain decimal register number is always a constant, whatever the
+     target's register parser would otherwise make of the operand.  */
+  if (get_simple_decimal_operand (&value, NULL))
+    regno = value;
+  else
     {
-    case O_register:
-    case O_constant:
-      regno = exp.X_add_number;
-      break;
+      tc_parse_to_dw2regnum (&exp);
+      switch (exp.X_op)
+	{
+	case O_register:
+	case O_constant:
+	  regno = exp.X_add_number;
+	  break;
 
-    default:
-      regno = -1;
-      break;
+	default:
+	  regno = -1;
+	  break;
+	}
     }
 
   if (regno < 0)
@@ -795,6 +803,10 @@ cfi_parse_reg (void)
 static offsetT
 cfi_parse_const (void)
 {
+  offsetT value;
+
+  if (get_simple_decimal_operand (&value, NULL))
+    return value;
   return get_absolute_expression ();
 }
 
@@ -1146,6 +1146,7 @@ char *
 dwarf2_directive_filename (void)
 {
   bool with_md5 = false;
+  offsetT value;
   valueT num;
   char *filename;
   const char * dirname = NULL;
@@ -1159,7 +1160,10 @@ dwarf2_directive_filename (void)
       return NULL;
     }
 
-  num = get_absolute_expression ();
+  if (get_simple_decimal_operand (&value, NULL))
+    num = value;
+  else
+    num = get_absolute_expression ();
 
   if ((offsetT) num < 1)
     {
@@ -1239,6 +1243,27 @@ dwarf2_directive_file (int dummy ATTRIBUTE_UNUSED)
   (void) dwarf2_directive_filename ();
 }
 
+/* The keywords which may follow a numeric .loc operand.  */
+
+static const char *const loc_keywords[] =
+{
+  "basic_block", "prologue_end", "epilogue_begin", "is_stmt", "isa",
+  "discriminator", "view", NULL
+};
+
+/* Parse a numeric .loc operand.  Compilers emit a .loc for almost every
+   line, so avoid the general expression parser where possible.  */
+
+static offsetT
+get_loc_operand (void)
+{
+  offsetT value;
+
+  if (get_simple_decimal_operand (&value, loc_keywords))
+    return value;
+  return get_absolute_expression ();
+}
+
 void
 dwarf2_directive_loc (int dummy ATTRIBUTE_UNUSED)
 {
@@ -1249,9 +1274,9 @@ dwarf2_directive_loc (int dummy ATTRIBUTE_UNUSED)
   if (dwarf2_loc_directive_seen)
     dwarf2_emit_insn (0);
 
-  filenum = get_absolute_expression ();
+  filenum = get_loc_operand ();
   SKIP_WHITESPACE ();
-  line = get_absolute_expression ();
+  line = get_loc_operand ();
 
   if (filenum < 1)
     {
@@ -1304,7 +1329,7 @@ dwarf2_directive_loc (int dummy ATTRIBUTE_UNUSED)
   SKIP_WHITESPACE ();
   if (ISDIGIT (*input_line_pointer))
     {
-      current.column = get_absolute_expression ();
+      current.column = get_loc_operand ();
       SKIP_WHITESPACE ();
     }
 
@@ -1333,7 +1358,7 @@ dwarf2_directive_loc (int dummy ATTRIBUTE_UNUSED)
       else if (strcmp (p, "is_stmt") == 0)
 	{
 	  (void) restore_line_pointer (c);
-	  value = get_absolute_expression ();
+	  value = get_loc_operand ();
 	  if (value == 0)
 	    current.flags &= ~DWARF2_FLAG_IS_STMT;
 	  else if (value == 1)
@@ -1347,7 +1372,7 @@ dwarf2_directive_loc (int dummy ATTRIBUTE_UNUSED)
       else if (strcmp (p, "isa") == 0)
 	{
 	  (void) restore_line_pointer (c);
-	  value = get_absolute_expression ();
+	  value = get_loc_operand ();
 	  if (value >= 0)
 	    current.isa = value;
 	  else
@@ -1359,7 +1384,7 @@ dwarf2_directive_loc (int dummy ATTRIBUTE_UNUSED)
       else if (strcmp (p, "discriminator") == 0)
 	{
 	  (void) restore_line_pointer (c);
-	  value = get_absolute_expression ();
+	  value = get_loc_operand ();
 	  if (value >= 0)
 	    current.discriminator = value;
 	  else
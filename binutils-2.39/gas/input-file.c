@@ -26,6 +26,8 @@
 #include "as.h"
 #include "input-file.h"
 #include "safe-ctype.h"
+#include <fcntl.h>
+#include <sys/stat.h>
 
 /* This variable is non-zero if the file currently being read should be
    preprocessed by app.  It is zero if the file can be read straight in.  */
@@ -39,16 +41,26 @@ int preprocess = 0;
 
 #define BUFFER_SIZE (32 * 1024)
 
+/* When the input is a pipe, as with "gcc -pipe", read it through a
+   stdio buffer this large and ask for a pipe of the same capacity.  The
+   compiler can then keep writing into the pipe while we scrub what we
+   already have, and each read takes whatever has accumulated rather
+   than a few kilobytes at a time.  */
+
+#define PIPE_BUFFER_SIZE (1024 * 1024)
+
 /* We use static data: the data area is not sharable.  */
 
 static FILE *f_in;
 static const char *file_name;
+static char *pipe_buffer;
 
 /* Struct for saving the state of this module for file includes.  */
 struct saved_file
   {
     FILE * f_in;
     const char * file_name;
+    char * pipe_buffer;
     int    preprocess;
     char * app_save;
   };
@@ -59,6 +71,7 @@ void
 input_file_begin (void)
 {
   f_in = (FILE *) 0;
+  pipe_buffer = NULL;
 }
 
 void
@@ -85,6 +98,7 @@ input_file_push (void)
 
   saved->f_in = f_in;
   saved->file_name = file_name;
+  saved->pipe_buffer = pipe_buffer;
   saved->preprocess = preprocess;
   if (preprocess)
     saved->app_save = app_push ();
@@ -104,6 +118,7 @@ input_file_pop (char *arg)
 
   f_in = saved->f_in;
   file_name = saved->file_name;
+  pipe_buffer = saved->pipe_buffer;
   preprocess = saved->preprocess;
   if (preprocess)
     app_pop (saved->app_save);
@@ -111,6 +126,54 @@ input_file_pop (char *arg)
   free (arg);
 }
 
+/* If the input file is a pipe, enlarge the pipe and give F_IN a buffer
+   of PIPE_BUFFER_SIZE.  This must be done before anything is read.  */
+
+static void
+input_file_setup_pipe (void)
+{
+#ifdef S_ISFIFO
+  struct stat st;
+  int fd = fileno (f_in);
+
+  if (fstat (fd, &st) != 0 || !S_ISFIFO (st.st_mode))
+    return;
+
+#ifdef F_SETPIPE_SZ
+  {
+    int size = PIPE_BUFFER_SIZE;
+
+    /* Unprivileged processes may not go beyond the system's maximum
+       pipe size, so settle for the largest size we are allowed.  Never
+       shrink a pipe that is already large enough.  */
+    if (fcntl (fd, F_GETPIPE_SZ) < size)
+      while (size > BUFFER_SIZE && fcntl (fd, F_SETPIPE_SZ, size) < 0)
+	size /= 2;
+  }
+#endif
+
+  pipe_buffer = XNEWVEC (char, PIPE_BUFFER_SIZE);
+  if (setvbuf (f_in, pipe_buffer, _IOFBF, PIPE_BUFFER_SIZE) != 0)
+    {
+      free (pipe_buffer);
+      pipe_buffer = NULL;
+    }
+#endif
+}
+
+/* Close F_IN and release its buffer.  Return the result of fclose.  */
+
+static int
+input_file_fclose (void)
+{
+  int ret = fclose (f_in);
+
+  f_in = NULL;
+  free (pipe_buffer);
+  pipe_buffer = NULL;
+  return ret;
+}
+
 /* Open the specified file, "" means stdin.  Filename must not be null.  */
 
 void
@@ -143,6 +206,8 @@ input_file_open (const char *filename,
       return;
     }
 
+  input_file_setup_pipe ();
+
   c = getc (f_in);
 
   if (ferror (f_in))
@@ -150,16 +215,14 @@ input_file_open (const char *filename,
       as_bad (_("can't read from %s: %s"),
 	      file_name, xstrerror (errno));
 
-      fclose (f_in);
-      f_in = NULL;
+      input_file_fclose ();
       return;
     }
 
   /* Check for an empty input file.  */
   if (feof (f_in))
     {
-      fclose (f_in);
-      f_in = NULL;
+      input_file_fclose ();
       return;
     }
   gas_assert (c != EOF);
@@ -204,9 +267,7 @@ input_file_close (void)
 {
   /* Don't close a null file pointer.  */
   if (f_in != NULL)
-    fclose (f_in);
-
-  f_in = 0;
+    input_file_fclose ();
 }
 
 /* This function is passed to do_scrub_chars.  */
@@ -248,10 +309,9 @@ input_file_give_next_buffer (char *where /* Where to place 1st character of new
     return_value = where + size;
   else
     {
-      if (fclose (f_in))
+      if (input_file_fclose ())
 	as_warn (_("can't close %s: %s"), file_name, xstrerror (errno));
 
-      f_in = (FILE *) 0;
       return_value = 0;
     }
 
@@ -554,6 +554,82 @@ get_absolute_expression (void)
   return get_absolute_expr (&exp);
 }
 
+/* Compilers emit directives such as .loc and .cfi_offset for nearly every
+   instruction, and nearly all their operands are small decimal numbers.
+   If the operand at INPUT_LINE_POINTER is a decimal number of at most nine
+   digits, possibly negated, whose value get_absolute_expression would
+   return unchanged, store that value in *VAL, skip the operand just as
+   get_absolute_expression would and return true.  Otherwise return false
+   without moving INPUT_LINE_POINTER, leaving the operand to the expression
+   parser.
+
+   The number must be followed by the end of the statement, by a comma, or
+   by a space and then the end of the statement, a comma, a string, another
+   number or one of the names in the NULL terminated list NAMES (which may
+   be NULL).  None of those names may be an operator on any target.  */
+
+bool
+get_simple_decimal_operand (offsetT *val, const char *const *names)
+{
+  char *p = input_line_pointer;
+  bool negative = false;
+  offsetT num;
+  int digits;
+
+  if (*p == ' ')
+    p++;
+  if (*p == '-')
+    {
+      negative = true;
+      p++;
+    }
+
+  /* Anything starting with 0 other than 0 itself is not decimal.  */
+  if (*p == '0')
+    {
+      num = 0;
+      digits = 1;
+      p++;
+    }
+  else
+    for (num = 0, digits = 0; ISDIGIT (*p) && digits < 10; p++, digits++)
+      num = num * 10 + (*p - '0');
+  if (digits == 0 || digits > 9)
+    return false;
+
+  if (*p == ' ')
+    {
+      char *next = p;
+
+      while (*next == ' ')
+	next++;
+      if (!is_end_of_line[(unsigned char) *next]
+	  && *next != ','
+	  && *next != '"'
+	  && !ISDIGIT (*next))
+	{
+	  size_t len;
+
+	  if (names == NULL || !is_name_beginner (*next))
+	    return false;
+	  for (len = 1; is_part_of_name (next[len]); len++)
+	    ;
+	  for (; *names != NULL; names++)
+	    if (strncmp (*names, next, len) == 0 && (*names)[len] == '\0')
+	      break;
+	  if (*names == NULL)
+	    return false;
+	}
+      p = next;
+    }
+  else if (!is_end_of_line[(unsigned char) *p] && *p != ',')
+    return false;
+
+  *val = negative ? -num : num;
+  input_line_pointer = p;
+  return true;
+}
+
 static int pop_override_ok = 0;
 static const char *pop_table_name;
 
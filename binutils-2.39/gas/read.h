@@ -120,6 +120,7 @@ extern char *demand_copy_string (int *lenP);
 extern char *demand_copy_C_string (int *len_pointer);
 extern char get_absolute_expression_and_terminator (long *val_pointer);
 extern offsetT get_absolute_expression (void);
+extern bool get_simple_decimal_operand (offsetT *, const char *const *);
 extern unsigned int next_char_of_string (void);
 extern void s_mri_sect (char *);
 extern char *mri_comment_field (char *);
@@ -1357,10 +1357,17 @@ typedef struct cgen_cpu_desc
   CGEN_INSN_LIST **asm_hash_table;
   CGEN_INSN_LIST *asm_hash_table_entries;
 
+  /* Space for the list returned by cgen_asm_lookup_insn.  */
+  CGEN_INSN_LIST *asm_lookup_list;
+
   /* Disassembler instruction hash table.  */
   CGEN_INSN_LIST **dis_hash_table;
   CGEN_INSN_LIST *dis_hash_table_entries;
 
+  /* Decision trees that narrow down each disassembler hash chain,
+     indexed by hash value.  */
+  struct cgen_dis_decode_node **dis_decode_table;
+
   /* This field could be turned into a bitfield if room for other flags is needed.  */
   unsigned int signed_overflow_ok_p;
        
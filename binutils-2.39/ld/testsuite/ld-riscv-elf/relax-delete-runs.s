@@ -0,0 +1,20 @@
+	.macro	block
+block_\@:
+	call	f
+	.align	3
+	tail	f
+	.align	2
+	call	g
+	.endm
+
+	.text
+	.globl	_start
+_start:
+	.rept	16
+	block
+	.endr
+f:
+	ret
+g:
+	ret
+	.size	g, . - g
@@ -35,50 +35,57 @@ enum map_type
   MAP_DATA
 };
 
-static aarch64_feature_set arch_variant; /* See select_aarch64_variant.  */
-static enum map_type last_type;
-static int last_mapping_sym = -1;
-static bfd_vma last_stop_offset = 0;
-static bfd_vma last_mapping_addr = 0;
-
-/* Other options */
-static int no_aliases = 0;	/* If set disassemble as most general inst.  */
-static int no_notes = 1;	/* If set do not print disassemble notes in the
-				  output as comments.  */
-
-/* Currently active instruction sequence.  */
-static aarch64_instr_sequence insn_sequence;
+/* State kept between calls to print_insn_aarch64, in INFO->private_data.  */
+struct aarch64_private_data
+{
+  aarch64_feature_set arch_variant; /* See select_aarch64_variant.  */
+  enum map_type last_type;
+  int last_mapping_sym;
+  bfd_vma last_stop_offset;
+  bfd_vma last_mapping_addr;
+
+  /* Other options */
+  int no_aliases;	/* If set disassemble as most general inst.  */
+  int no_notes;		/* If set do not print disassemble notes in the
+			   output as comments.  */
+
+  /* Currently active instruction sequence.  */
+  aarch64_instr_sequence insn_sequence;
+};
 
 static void
-set_default_aarch64_dis_options (struct disassemble_info *info ATTRIBUTE_UNUSED)
+set_default_aarch64_dis_options (struct aarch64_private_data *priv)
 {
+  priv->no_aliases = 0;
+  priv->no_notes = 1;
 }
 
 static void
-parse_aarch64_dis_option (const char *option, unsigned int len ATTRIBUTE_UNUSED)
+parse_aarch64_dis_option (struct aarch64_private_data *priv,
+			  const char *option, unsigned int len ATTRIBUTE_UNUSED)
 {
   /* Try to match options that are simple flags */
   if (startswith (option, "no-aliases"))
     {
-      no_aliases = 1;
+      priv->no_aliases = 1;
       return;
     }
 
   if (startswith (option, "aliases"))
     {
-      no_aliases = 0;
+      priv->no_aliases = 0;
       return;
     }
 
   if (startswith (option, "no-notes"))
     {
-      no_notes = 1;
+      priv->no_notes = 1;
       return;
     }
 
   if (startswith (option, "notes"))
     {
-      no_notes = 0;
+      priv->no_notes = 0;
       return;
     }
 
@@ -95,7 +102,8 @@ parse_aarch64_dis_option (const char *option, unsigned int len ATTRIBUTE_UNUSED)
 }
 
 static void
-parse_aarch64_dis_options (const char *options)
+parse_aarch64_dis_options (struct aarch64_private_data *priv,
+			   const char *options)
 {
   const char *option_end;
 
@@ -116,7 +124,7 @@ parse_aarch64_dis_options (const char *options)
       while (*option_end != ',' && *option_end != '\0')
 	option_end++;
 
-      parse_aarch64_dis_option (options, option_end - options);
+      parse_aarch64_dis_option (priv, options, option_end - options);
 
       /* Go on to the next one.  If option_end points to a comma, it
 	 will be skipped above.  */
@@ -2797,7 +2805,8 @@ convert_to_alias (aarch64_inst *inst, const aarch64_opcode *alias)
 
 static bool
 aarch64_opcode_decode (const aarch64_opcode *, const aarch64_insn,
-		       aarch64_inst *, int, aarch64_operand_error *errors);
+		       aarch64_inst *, int, aarch64_feature_set,
+		       aarch64_operand_error *errors);
 
 /* Given the instruction information in *INST, check if the instruction has
    any alias form that can be used to represent *INST.  If the answer is yes,
@@ -2854,6 +2863,7 @@ aarch64_opcode_decode (const aarch64_opcode *, const aarch64_insn,
 
 static void
 determine_disassembling_preference (struct aarch64_inst *inst,
+				    aarch64_feature_set arch_variant,
 				    aarch64_operand_error *errors)
 {
   const aarch64_opcode *opcode;
@@ -2942,7 +2952,8 @@ determine_disassembling_preference (struct aarch64_inst *inst,
 	  /* Directly decode the alias opcode.  */
 	  aarch64_inst temp;
 	  memset (&temp, '\0', sizeof (aarch64_inst));
-	  if (aarch64_opcode_decode (alias, inst->value, &temp, 1, errors) == 1)
+	  if (aarch64_opcode_decode (alias, inst->value, &temp, 1, arch_variant,
+				     errors) == 1)
 	    {
 	      DEBUG_TRACE ("succeed with %s via direct decoding", alias->name);
 	      memcpy (inst, &temp, sizeof (aarch64_inst));
@@ -3116,6 +3127,7 @@ aarch64_decode_variant_using_iclass (aarch64_inst *inst)
 static bool
 aarch64_opcode_decode (const aarch64_opcode *opcode, const aarch64_insn code,
 		       aarch64_inst *inst, int noaliases_p,
+		       aarch64_feature_set arch_variant,
 		       aarch64_operand_error *errors)
 {
   int i;
@@ -3197,7 +3209,7 @@ aarch64_opcode_decode (const aarch64_opcode *opcode, const aarch64_insn code,
 	 alias and should be disassembled in the form of its alias instead.
 	 If the answer is yes, *INST will be updated.  */
       if (!noaliases_p)
-	determine_disassembling_preference (inst, errors);
+	determine_disassembling_preference (inst, arch_variant, errors);
       DEBUG_TRACE ("SUCCESS");
       return true;
     }
@@ -3234,13 +3246,13 @@ user_friendly_fixup (aarch64_inst *inst)
 }
 
 /* Decode INSN and fill in *INST the instruction information.  An alias
-   opcode may be filled in *INSN if NOALIASES_P is FALSE.  Return zero on
-   success.  */
+   opcode available in ARCH_VARIANT may be filled in *INSN if NOALIASES_P
+   is FALSE.  Return zero on success.  */
 
-enum err_type
-aarch64_decode_insn (aarch64_insn insn, aarch64_inst *inst,
-		     bool noaliases_p,
-		     aarch64_operand_error *errors)
+static enum err_type
+aarch64_decode_insn_1 (aarch64_insn insn, aarch64_inst *inst,
+		       bool noaliases_p, aarch64_feature_set arch_variant,
+		       aarch64_operand_error *errors)
 {
   const aarch64_opcode *opcode = aarch64_opcode_lookup (insn);
 
@@ -3267,7 +3279,8 @@ aarch64_decode_insn (aarch64_insn insn, aarch64_inst *inst,
     {
       /* But only one opcode can be decoded successfully for, as the
 	 decoding routine will check the constraint carefully.  */
-      if (aarch64_opcode_decode (opcode, insn, inst, noaliases_p, errors) == 1)
+      if (aarch64_opcode_decode (opcode, insn, inst, noaliases_p,
+				 arch_variant, errors) == 1)
 	return ERR_OK;
       opcode = aarch64_find_next_opcode (opcode);
     }
@@ -3275,6 +3288,17 @@ aarch64_decode_insn (aarch64_insn insn, aarch64_inst *inst,
   return ERR_UND;
 }
 
+/* As above, but choosing aliases from all non-R-profile features.  */
+
+enum err_type
+aarch64_decode_insn (aarch64_insn insn, aarch64_inst *inst,
+		     bool noaliases_p,
+		     aarch64_operand_error *errors)
+{
+  return aarch64_decode_insn_1 (insn, inst, noaliases_p,
+				AARCH64_ANY & ~(AARCH64_FEATURE_V8_R), errors);
+}
+
 /* Print operands.  */
 
 static void
@@ -3282,6 +3306,7 @@ print_operands (bfd_vma pc, const aarch64_opcode *opcode,
 		const aarch64_opnd_info *opnds, struct disassemble_info *info,
 		bool *has_notes)
 {
+  struct aarch64_private_data *priv = info->private_data;
   char *notes = NULL;
   int i, pcrel_p, num_printed;
   for (i = 0, num_printed = 0; i < AARCH64_MAX_OPND_NUM; ++i)
@@ -3301,7 +3326,7 @@ print_operands (bfd_vma pc, const aarch64_opcode *opcode,
       /* Generate the operand string in STR.  */
       aarch64_print_operand (str, sizeof (str), pc, opcode, opnds, i, &pcrel_p,
 			     &info->target, &notes, cmt, sizeof (cmt),
-			     arch_variant);
+			     priv->arch_variant);
 
       /* Print the delimiter (taking account of omitted operand(s)).  */
       if (str[0] != '\0')
@@ -3323,7 +3348,7 @@ print_operands (bfd_vma pc, const aarch64_opcode *opcode,
 	}
     }
 
-    if (notes && !no_notes)
+    if (notes && !priv->no_notes)
       {
 	*has_notes = true;
 	(*info->fprintf_func) (info->stream, "  // note: %s", notes);
@@ -3391,7 +3416,9 @@ static void
 print_verifier_notes (aarch64_operand_error *detail,
 		      struct disassemble_info *info)
 {
-  if (no_notes)
+  struct aarch64_private_data *priv = info->private_data;
+
+  if (priv->no_notes)
     return;
 
   /* The output of the verifier cannot be a fatal error, otherwise the assembly
@@ -3432,6 +3459,7 @@ print_aarch64_insn (bfd_vma pc, const aarch64_inst *inst,
 		    struct disassemble_info *info,
 		    aarch64_operand_error *mismatch_details)
 {
+  struct aarch64_private_data *priv = info->private_data;
   bool has_notes = false;
 
   print_mnemonic_name (inst, info);
@@ -3448,7 +3476,8 @@ print_aarch64_insn (bfd_vma pc, const aarch64_inst *inst,
      maintain a global state regardless of whether the instruction has the flag
      set or not.  */
   enum err_type result = verify_constraints (inst, code, pc, false,
-					     mismatch_details, &insn_sequence);
+					     mismatch_details,
+					     &priv->insn_sequence);
   switch (result)
     {
     case ERR_VFI:
@@ -3478,6 +3507,7 @@ print_insn_aarch64_word (bfd_vma pc,
       [ERR_NYI] = "NYI"
     };
 
+  struct aarch64_private_data *priv = info->private_data;
   enum err_type ret;
   aarch64_inst inst;
 
@@ -3495,7 +3525,8 @@ print_insn_aarch64_word (bfd_vma pc,
        addresses, since the addend is not currently pc-relative.  */
     pc = 0;
 
-  ret = aarch64_decode_insn (word, &inst, no_aliases, errors);
+  ret = aarch64_decode_insn_1 (word, &inst, priv->no_aliases,
+			       priv->arch_variant, errors);
 
   if (((word >> 21) & 0x3ff) == 1)
     {
@@ -3619,15 +3650,15 @@ get_sym_code_type (struct disassemble_info *info, int n,
    Currently we only restrict disassembly for Armv8-R and otherwise enable all
    non-R-profile features.  */
 static void
-select_aarch64_variant (unsigned mach)
+select_aarch64_variant (struct aarch64_private_data *priv, unsigned mach)
 {
   switch (mach)
     {
     case bfd_mach_aarch64_8R:
-      arch_variant = AARCH64_ARCH_V8_R;
+      priv->arch_variant = AARCH64_ARCH_V8_R;
       break;
     default:
-      arch_variant = AARCH64_ANY & ~(AARCH64_FEATURE_V8_R);
+      priv->arch_variant = AARCH64_ANY & ~(AARCH64_FEATURE_V8_R);
     }
 }
 
@@ -3645,24 +3676,27 @@ print_insn_aarch64 (bfd_vma pc,
   unsigned int	size = 4;
   unsigned long	data;
   aarch64_operand_error errors;
-  static bool set_features;
+  struct aarch64_private_data *priv = info->private_data;
+
+  if (priv == NULL)
+    {
+      priv = XCNEW (struct aarch64_private_data);
+      priv->last_mapping_sym = -1;
+      set_default_aarch64_dis_options (priv);
+      select_aarch64_variant (priv, info->mach);
+      info->private_data = priv;
+    }
 
   if (info->disassembler_options)
     {
-      set_default_aarch64_dis_options (info);
+      set_default_aarch64_dis_options (priv);
 
-      parse_aarch64_dis_options (info->disassembler_options);
+      parse_aarch64_dis_options (priv, info->disassembler_options);
 
       /* To avoid repeated parsing of these options, we remove them here.  */
       info->disassembler_options = NULL;
     }
 
-  if (!set_features)
-    {
-      select_aarch64_variant (info->mach);
-      set_features = true;
-    }
-
   /* Aarch64 instructions are always little-endian */
   info->endian_code = BFD_ENDIAN_LITTLE;
 
@@ -3688,8 +3722,8 @@ print_insn_aarch64 (bfd_vma pc,
       bool can_use_search_opt_p;
       int n;
 
-      if (pc <= last_mapping_addr)
-	last_mapping_sym = -1;
+      if (pc <= priv->last_mapping_addr)
+	priv->last_mapping_sym = -1;
 
       /* Start scanning at the start of the function, or wherever
 	 we finished last time.  */
@@ -3698,11 +3732,11 @@ print_insn_aarch64 (bfd_vma pc,
       /* If the last stop offset is different from the current one it means we
 	 are disassembling a different glob of bytes.  As such the optimization
 	 would not be safe and we should start over.  */
-      can_use_search_opt_p = last_mapping_sym >= 0
-			     && info->stop_offset == last_stop_offset;
+      can_use_search_opt_p = priv->last_mapping_sym >= 0
+			     && info->stop_offset == priv->last_stop_offset;
 
-      if (n >= last_mapping_sym && can_use_search_opt_p)
-	n = last_mapping_sym;
+      if (n >= priv->last_mapping_sym && can_use_search_opt_p)
+	n = priv->last_mapping_sym;
 
       /* Look down while we haven't passed the location being disassembled.
 	 The reason for this is that there's no defined order between a symbol
@@ -3723,8 +3757,8 @@ print_insn_aarch64 (bfd_vma pc,
       if (!found)
 	{
 	  n = info->symtab_pos;
-	  if (n >= last_mapping_sym && can_use_search_opt_p)
-	    n = last_mapping_sym;
+	  if (n >= priv->last_mapping_sym && can_use_search_opt_p)
+	    n = priv->last_mapping_sym;
 
 	  /* No mapping symbol found at this address.  Look backwards
 	     for a preceeding one, but don't go pass the section start
@@ -3750,15 +3784,15 @@ print_insn_aarch64 (bfd_vma pc,
 	    }
 	}
 
-      last_mapping_sym = last_sym;
-      last_type = type;
-      last_stop_offset = info->stop_offset;
+      priv->last_mapping_sym = last_sym;
+      priv->last_type = type;
+      priv->last_stop_offset = info->stop_offset;
 
       /* Look a little bit ahead to see if we should print out
 	 less than four bytes of data.  If there's a symbol,
 	 mapping or otherwise, after two bytes then don't
 	 print more.  */
-      if (last_type == MAP_DATA)
+      if (priv->last_type == MAP_DATA)
 	{
 	  size = 4 - (pc & 3);
 	  for (n = last_sym + 1; n < info->symtab_size; n++)
@@ -3779,10 +3813,10 @@ print_insn_aarch64 (bfd_vma pc,
 	}
     }
   else
-    last_type = type;
+    priv->last_type = type;
 
   /* PR 10263: Disassemble data if requested to do so by the user.  */
-  if (last_type == MAP_DATA && ((info->flags & DISASSEMBLE_DATA) == 0))
+  if (priv->last_type == MAP_DATA && ((info->flags & DISASSEMBLE_DATA) == 0))
     {
       /* size was set above.  */
       info->bytes_per_chunk = size;
@@ -3811,6 +3845,17 @@ print_insn_aarch64 (bfd_vma pc,
   return size;
 }
 
+/* Free the instruction sequence held in INFO->private_data.  */
+
+void
+disassemble_free_aarch64 (struct disassemble_info *info)
+{
+  struct aarch64_private_data *priv = info->private_data;
+
+  if (priv != NULL)
+    init_insn_sequence (NULL, &priv->insn_sequence);
+}
+
 void
 print_aarch64_disassembler_options (FILE *stream)
 {
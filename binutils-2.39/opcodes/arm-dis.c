@@ -61,6 +61,21 @@ struct arm_private_data
   /* The end range of the current range being disassembled.  */
   bfd_vma last_stop_offset;
   bfd_vma last_mapping_addr;
+
+  /* Index into regnames of the register name set to use.  */
+  unsigned int regname_selected;
+
+  /* Disassemble everything as Thumb, and which coprocessors are CDE.  */
+  bool force_thumb;
+  uint16_t cde_coprocs;
+
+  /* Current IT instruction state.  This contains the same state as the IT
+     bits in the CPSR.  */
+  unsigned int ifthen_state;
+  /* IT state for the next instruction.  */
+  unsigned int ifthen_next_state;
+  /* The address of the insn for which the IT state is valid.  */
+  bfd_vma ifthen_address;
 };
 
 enum mve_instructions
@@ -5289,22 +5304,14 @@ static struct vpt_block vpt_block_state =
 };
 
 /* Default to GCC register name set.  */
-static unsigned int regname_selected = 1;
+#define DEFAULT_REGNAME_SELECTED 1
 
 #define NUM_ARM_OPTIONS   ARRAY_SIZE (regnames)
-#define arm_regnames      regnames[regname_selected].reg_names
-
-static bool force_thumb = false;
-static uint16_t cde_coprocs = 0;
-
-/* Current IT instruction state.  This contains the same state as the IT
-   bits in the CPSR.  */
-static unsigned int ifthen_state;
-/* IT state for the next instruction.  */
-static unsigned int ifthen_next_state;
-/* The address of the insn for which the IT state is valid.  */
-static bfd_vma ifthen_address;
-#define IFTHEN_COND ((ifthen_state >> 4) & 0xf)
+#define arm_regnames(info) \
+  (regnames[((struct arm_private_data *) (info)->private_data)		\
+	    ->regname_selected].reg_names)
+
+#define IFTHEN_COND(private_data) (((private_data)->ifthen_state >> 4) & 0xf)
 /* Indicates that the current Conditional state is unconditional or outside
    an IT block.  */
 #define COND_UNCOND 16
@@ -5459,10 +5466,12 @@ arm_decode_bitfield (const char *ptr,
 }
 
 static void
-arm_decode_shift (long given, fprintf_ftype func, void *stream,
-		  bool print_shift)
+arm_decode_shift (struct disassemble_info *info, long given, bool print_shift)
 {
-  func (stream, "%s", arm_regnames[given & 0xf]);
+  void *stream = info->stream;
+  fprintf_ftype func = info->fprintf_func;
+
+  func (stream, "%s", arm_regnames (info)[given & 0xf]);
 
   if ((given & 0xff0) != 0)
     {
@@ -5491,9 +5500,9 @@ arm_decode_shift (long given, fprintf_ftype func, void *stream,
 	func (stream, "\t; <illegal shifter operand>");
       else if (print_shift)
 	func (stream, ", %s %s", arm_shift[(given & 0x60) >> 5],
-	      arm_regnames[(given & 0xf00) >> 8]);
+	      arm_regnames (info)[(given & 0xf00) >> 8]);
       else
-	func (stream, ", %s", arm_regnames[(given & 0xf00) >> 8]);
+	func (stream, ", %s", arm_regnames (info)[(given & 0xf00) >> 8]);
     }
 }
 
@@ -5987,14 +5996,14 @@ print_mve_vld_str_addr (struct disassemble_info *info,
     {
       /* Offset mode.  */
       if (w == 0)
-	func (stream, "[%s, #%s%lu]", arm_regnames[gpr], add_sub, mod_imm);
+	func (stream, "[%s, #%s%lu]", arm_regnames (info)[gpr], add_sub, mod_imm);
       /* Pre-indexed mode.  */
       else
-	func (stream, "[%s, #%s%lu]!", arm_regnames[gpr], add_sub, mod_imm);
+	func (stream, "[%s, #%s%lu]!", arm_regnames (info)[gpr], add_sub, mod_imm);
     }
   else if ((p == 0) && (w == 1))
     /* Post-index mode.  */
-    func (stream, "[%s], #%s%lu", arm_regnames[gpr], add_sub, mod_imm);
+    func (stream, "[%s], #%s%lu", arm_regnames (info)[gpr], add_sub, mod_imm);
 }
 
 /* Return FALSE if GIVEN is not an undefined encoding for MATCHED_INSN.
@@ -8099,8 +8108,8 @@ print_insn_coprocessor_1 (const struct sopcode32 *opcodes,
 	     encoding is the same.  */
 	  mask |= 0xf0000000;
 	  value |= 0xe0000000;
-	  if (ifthen_state)
-	    cond = IFTHEN_COND;
+	  if (private_data->ifthen_state)
+	    cond = IFTHEN_COND (private_data);
 	  else
 	    cond = COND_UNCOND;
 	}
@@ -8192,7 +8201,7 @@ print_insn_coprocessor_1 (const struct sopcode32 *opcodes,
 		    if (mod == 'K')
 		      offset = given & 0x7f;
 
-		    func (stream, "[%s", arm_regnames [(given >> 16) & 0xf]);
+		    func (stream, "[%s", arm_regnames (info)[(given >> 16) & 0xf]);
 
 		    if (PRE_BIT_SET || WRITEBACK_BIT_SET)
 		      {
@@ -8450,7 +8459,7 @@ print_insn_coprocessor_1 (const struct sopcode32 *opcodes,
 			      is_unpredictable = true;
 			    u_reg = value;
 			  }
-			func (stream, "%s", arm_regnames[value]);
+			func (stream, "%s", arm_regnames (info)[value]);
 			break;
 		      case 'V':
 			if (given & (1 << 6))
@@ -8687,7 +8696,7 @@ print_insn_coprocessor_1 (const struct sopcode32 *opcodes,
 		    int offset = given & 0xff;
 		    int multiplier = (given & 0x00000100) ? 4 : 1;
 
-		    func (stream, "[%s", arm_regnames [(given >> 16) & 0xf]);
+		    func (stream, "[%s", arm_regnames (info)[(given >> 16) & 0xf]);
 
 		    if (multiplier > 1)
 		      {
@@ -8718,8 +8727,8 @@ print_insn_coprocessor_1 (const struct sopcode32 *opcodes,
 		    int imm4 = (given >> 4) & 0xf;
 		    int puw_bits = ((given >> 22) & 6) | ((given >> W_BIT) & 1);
 		    int ubit = ! NEGATIVE_BIT_SET;
-		    const char *rm = arm_regnames [given & 0xf];
-		    const char *rn = arm_regnames [(given >> 16) & 0xf];
+		    const char *rm = arm_regnames (info)[given & 0xf];
+		    const char *rn = arm_regnames (info)[(given >> 16) & 0xf];
 
 		    switch (puw_bits)
 		      {
@@ -8847,7 +8856,7 @@ print_arm_address (bfd_vma pc, struct disassemble_info *info, long given)
   else
     {
       func (stream, "[%s",
-	    arm_regnames[(given >> 16) & 0xf]);
+	    arm_regnames (info)[(given >> 16) & 0xf]);
 
       if (PRE_BIT_SET)
 	{
@@ -8861,7 +8870,7 @@ print_arm_address (bfd_vma pc, struct disassemble_info *info, long given)
 	  else
 	    {
 	      func (stream, ", %s", NEGATIVE_BIT_SET ? "-" : "");
-	      arm_decode_shift (given, func, stream, true);
+	      arm_decode_shift (info, given, true);
 	    }
 
 	  func (stream, "]%s",
@@ -8880,7 +8889,7 @@ print_arm_address (bfd_vma pc, struct disassemble_info *info, long given)
 	    {
 	      func (stream, "], %s",
 		    NEGATIVE_BIT_SET ? "-" : "");
-	      arm_decode_shift (given, func, stream, true);
+	      arm_decode_shift (info, given, true);
 	    }
 	}
       if (NEGATIVE_BIT_SET)
@@ -8898,6 +8907,7 @@ static bool
 print_insn_cde (struct disassemble_info *info, long given, bool thumb)
 {
   const struct cdeopcode32 *insn;
+  struct arm_private_data *private_data = info->private_data;
   void *stream = info->stream;
   fprintf_ftype func = info->fprintf_func;
 
@@ -8909,7 +8919,7 @@ print_insn_cde (struct disassemble_info *info, long given, bool thumb)
     {
       uint16_t coproc = (given >> insn->coproc_shift) & insn->coproc_mask;
       uint16_t coproc_mask = 1 << coproc;
-      if (! (coproc_mask & cde_coprocs))
+      if (! (coproc_mask & private_data->cde_coprocs))
 	continue;
 
       if ((given & insn->mask) == insn->value)
@@ -8946,18 +8956,18 @@ print_insn_cde (struct disassemble_info *info, long given, bool thumb)
 		      is_unpredictable = true;
 		    /* Fall through.  */
 		  case 'r':
-		    func (stream, "%s", arm_regnames[value]);
+		    func (stream, "%s", arm_regnames (info)[value]);
 		    break;
 
 		  case 'n':
 		    if (value == 15)
 		      func (stream, "%s", "APSR_nzcv");
 		    else
-		      func (stream, "%s", arm_regnames[value]);
+		      func (stream, "%s", arm_regnames (info)[value]);
 		    break;
 
 		  case 'T':
-		    func (stream, "%s", arm_regnames[value + 1]);
+		    func (stream, "%s", arm_regnames (info)[value + 1]);
 		    break;
 
 		  case 'd':
@@ -9032,6 +9042,7 @@ static bool
 print_insn_neon (struct disassemble_info *info, long given, bool thumb)
 {
   const struct opcode32 *insn;
+  struct arm_private_data *private_data = info->private_data;
   void *stream = info->stream;
   fprintf_ftype func = info->fprintf_func;
 
@@ -9077,8 +9088,8 @@ print_insn_neon (struct disassemble_info *info, long given, bool thumb)
                  will have the high 4 bits equal to 0xe.  */
               cond_value |= 0xe0000000;
           }
-          if (ifthen_state)
-            cond = IFTHEN_COND;
+          if (private_data->ifthen_state)
+            cond = IFTHEN_COND (private_data);
           else
             cond = COND_UNCOND;
         }
@@ -9116,7 +9127,7 @@ print_insn_neon (struct disassemble_info *info, long given, bool thumb)
 		      break;
 
 		    case 'u':
-		      if (thumb && ifthen_state)
+		      if (thumb && private_data->ifthen_state)
 			is_unpredictable = true;
 
 		      /* Fall through.  */
@@ -9157,14 +9168,14 @@ print_insn_neon (struct disassemble_info *info, long given, bool thumb)
 			  func (stream, "d%d", rd);
 			else
 			  func (stream, "d%d-d%d", rd, rd + n - 1);
-			func (stream, "}, [%s", arm_regnames[rn]);
+			func (stream, "}, [%s", arm_regnames (info)[rn]);
 			if (align)
 			  func (stream, " :%d", 32 << align);
 			func (stream, "]");
 			if (rm == 0xd)
 			  func (stream, "!");
 			else if (rm != 0xf)
-			  func (stream, ", %s", arm_regnames[rm]);
+			  func (stream, ", %s", arm_regnames (info)[rm]);
 		      }
 		      break;
 
@@ -9232,14 +9243,14 @@ print_insn_neon (struct disassemble_info *info, long given, bool thumb)
                         for (i = 0; i < length; i++)
                           func (stream, "%sd%d[%d]", (i == 0) ? "" : ",",
                             rd + i * stride, idx);
-                        func (stream, "}, [%s", arm_regnames[rn]);
+                        func (stream, "}, [%s", arm_regnames (info)[rn]);
 			if (align)
 			  func (stream, " :%d", align);
 			func (stream, "]");
 			if (rm == 0xd)
 			  func (stream, "!");
 			else if (rm != 0xf)
-			  func (stream, ", %s", arm_regnames[rm]);
+			  func (stream, ", %s", arm_regnames (info)[rm]);
 		      }
 		      break;
 
@@ -9268,7 +9279,7 @@ print_insn_neon (struct disassemble_info *info, long given, bool thumb)
 			  func (stream, "d%d[]", rd);
 			else
 			  func (stream, "d%d[]-d%d[]", rd, rd + n - 1);
-			func (stream, "}, [%s", arm_regnames[rn]);
+			func (stream, "}, [%s", arm_regnames (info)[rn]);
 			if (align)
 			  {
                             align = (8 * (type + 1)) << size;
@@ -9283,7 +9294,7 @@ print_insn_neon (struct disassemble_info *info, long given, bool thumb)
 			if (rm == 0xd)
 			  func (stream, "!");
 			else if (rm != 0xf)
-			  func (stream, ", %s", arm_regnames[rm]);
+			  func (stream, ", %s", arm_regnames (info)[rm]);
 		      }
 		      break;
 
@@ -9451,7 +9462,7 @@ print_insn_neon (struct disassemble_info *info, long given, bool thumb)
 			switch (*c)
 			  {
 			  case 'r':
-			    func (stream, "%s", arm_regnames[value]);
+			    func (stream, "%s", arm_regnames (info)[value]);
 			    break;
 			  case 'd':
 			    func (stream, "%ld", value);
@@ -9549,6 +9560,7 @@ static bool
 print_insn_mve (struct disassemble_info *info, long given)
 {
   const struct mopcode32 *insn;
+  struct arm_private_data *private_data = info->private_data;
   void *stream = info->stream;
   fprintf_ftype func = info->fprintf_func;
 
@@ -9566,7 +9578,7 @@ print_insn_mve (struct disassemble_info *info, long given)
 
 	  /* Most vector mve instruction are illegal in a it block.
 	     There are a few exceptions; check for them.  */
-	  if (ifthen_state && !is_mve_okay_in_it (insn->mve_op))
+	  if (private_data->ifthen_state && !is_mve_okay_in_it (insn->mve_op))
 	    {
 	      is_unpredictable = true;
 	      unpredictable_cond = UNPRED_IT_BLOCK;
@@ -9602,8 +9614,8 @@ print_insn_mve (struct disassemble_info *info, long given)
 		      break;
 
 		    case 'c':
-		      if (ifthen_state)
-			func (stream, "%s", arm_conditional[IFTHEN_COND]);
+		      if (private_data->ifthen_state)
+			func (stream, "%s", arm_conditional[IFTHEN_COND (private_data)]);
 		      break;
 
 		    case 'd':
@@ -9734,7 +9746,7 @@ print_insn_mve (struct disassemble_info *info, long given)
 			    else if (value == 15)
 			      func (stream, "zr");
 			    else
-			      func (stream, "%s", arm_regnames[value]);
+			      func (stream, "%s", arm_regnames (info)[value]);
 			    break;
 
 			  case 'c':
@@ -9750,7 +9762,7 @@ print_insn_mve (struct disassemble_info *info, long given)
 			    if (value == 13 || value == 15)
 			      is_unpredictable = true;
 			    else
-			      func (stream, "%s", arm_regnames[value]);
+			      func (stream, "%s", arm_regnames (info)[value]);
 			    break;
 
 			  case 's':
@@ -9769,7 +9781,7 @@ print_insn_mve (struct disassemble_info *info, long given)
 			  case 'h':
 			    {
 			      unsigned int odd_reg = (value << 1) | 1;
-			      func (stream, "%s", arm_regnames[odd_reg]);
+			      func (stream, "%s", arm_regnames (info)[odd_reg]);
 			    }
 			    break;
 			  case 'i':
@@ -9802,7 +9814,7 @@ print_insn_mve (struct disassemble_info *info, long given)
 			  case 'l':
 			    {
 			      unsigned int even_reg = value << 1;
-			      func (stream, "%s", arm_regnames[even_reg]);
+			      func (stream, "%s", arm_regnames (info)[even_reg]);
 			    }
 			    break;
 			  case 'u':
@@ -9828,7 +9840,7 @@ print_insn_mve (struct disassemble_info *info, long given)
 			    print_mve_rotate (info, value, width);
 			    break;
 			  case 'r':
-			    func (stream, "%s", arm_regnames[value]);
+			    func (stream, "%s", arm_regnames (info)[value]);
 			    break;
 			  case 'd':
 			    if (insn->mve_op == MVE_VQSHL_T2
@@ -9903,7 +9915,7 @@ print_insn_mve (struct disassemble_info *info, long given)
 	    print_mve_undefined (info, undefined_cond);
 
 	  if (!vpt_block_state.in_vpt_block
-	      && !ifthen_state
+	      && !private_data->ifthen_state
 	      && is_vpt_instruction (given))
 	    mark_inside_vpt_block (given);
 	  else if (vpt_block_state.in_vpt_block)
@@ -10081,7 +10093,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 			  int offset = ((given & 0xf00) >> 4) | (given & 0xf);
 
 			  func (stream, "[%s",
-				arm_regnames[(given >> 16) & 0xf]);
+				arm_regnames (info)[(given >> 16) & 0xf]);
 
 			  if (PRE_BIT_SET)
 			    {
@@ -10104,7 +10116,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 				  /* Register Offset or Register Pre-Indexed.  */
 				  func (stream, ", %s%s",
 					NEGATIVE_BIT_SET ? "-" : "",
-					arm_regnames[given & 0xf]);
+					arm_regnames (info)[given & 0xf]);
 
 				  /* Writing back to the register that is the source/
 				     destination of the load/store is unpredictable.  */
@@ -10134,7 +10146,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 				  /* Register Post-indexed.  */
 				  func (stream, "], %s%s",
 					NEGATIVE_BIT_SET ? "-" : "",
-					arm_regnames[given & 0xf]);
+					arm_regnames (info)[given & 0xf]);
 
 				  /* Writing back to the register that is the source/
 				     destination of the load/store is unpredictable.  */
@@ -10189,7 +10201,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 			      if (started)
 				func (stream, ", ");
 			      started = 1;
-			      func (stream, "%s", arm_regnames[reg]);
+			      func (stream, "%s", arm_regnames (info)[reg]);
 			    }
 			func (stream, "}");
 			if (! started)
@@ -10198,7 +10210,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 		      break;
 
 		    case 'q':
-		      arm_decode_shift (given, func, stream, false);
+		      arm_decode_shift (info, given, false);
 		      break;
 
 		    case 'o':
@@ -10223,7 +10235,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 			  value_in_comment = a;
 			}
 		      else
-			arm_decode_shift (given, func, stream, true);
+			arm_decode_shift (info, given, true);
 		      break;
 
 		    case 'p':
@@ -10256,7 +10268,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 			if (NEGATIVE_BIT_SET)
 			  value_in_comment = - value_in_comment;
 
-			func (stream, "[%s", arm_regnames [(given >> 16) & 0xf]);
+			func (stream, "[%s", arm_regnames (info)[(given >> 16) & 0xf]);
 
 			if (PRE_BIT_SET)
 			  {
@@ -10401,7 +10413,7 @@ print_insn_arm (bfd_vma pc, struct disassemble_info *info, long given)
 				  is_unpredictable = true;
 				U_reg = value;
 			      }
-			    func (stream, "%s", arm_regnames[value]);
+			    func (stream, "%s", arm_regnames (info)[value]);
 			    break;
 			  case 'd':
 			    func (stream, "%ld", value);
@@ -10530,6 +10542,7 @@ static void
 print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 {
   const struct opcode16 *insn;
+  struct arm_private_data *private_data = info->private_data;
   void *stream = info->stream;
   fprintf_ftype func = info->fprintf_func;
 
@@ -10557,13 +10570,13 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 		break;
 
 	      case 'c':
-		if (ifthen_state)
-		  func (stream, "%s", arm_conditional[IFTHEN_COND]);
+		if (private_data->ifthen_state)
+		  func (stream, "%s", arm_conditional[IFTHEN_COND (private_data)]);
 		break;
 
 	      case 'C':
-		if (ifthen_state)
-		  func (stream, "%s", arm_conditional[IFTHEN_COND]);
+		if (private_data->ifthen_state)
+		  func (stream, "%s", arm_conditional[IFTHEN_COND (private_data)]);
 		else
 		  func (stream, "s");
 		break;
@@ -10572,7 +10585,7 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 		{
 		  unsigned int tmp;
 
-		  ifthen_next_state = given & 0xff;
+		  private_data->ifthen_next_state = given & 0xff;
 		  for (tmp = given << 1; tmp & 0xf; tmp <<= 1)
 		    func (stream, ((given ^ tmp) & 0x10) ? "e" : "t");
 		  func (stream, "\t%s", arm_conditional[(given >> 4) & 0xf]);
@@ -10580,14 +10593,14 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 		break;
 
 	      case 'x':
-		if (ifthen_next_state)
+		if (private_data->ifthen_next_state)
 		  func (stream, "\t; unpredictable branch in IT block\n");
 		break;
 
 	      case 'X':
-		if (ifthen_state)
+		if (private_data->ifthen_state)
 		  func (stream, "\t; unpredictable <IT:%s>",
-			arm_conditional[IFTHEN_COND]);
+			arm_conditional[IFTHEN_COND (private_data)]);
 		break;
 
 	      case 'S':
@@ -10598,7 +10611,7 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 		  if (given & (1 << 6))
 		    reg += 8;
 
-		  func (stream, "%s", arm_regnames[reg]);
+		  func (stream, "%s", arm_regnames (info)[reg]);
 		}
 		break;
 
@@ -10610,7 +10623,7 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 		  if (given & (1 << 7))
 		    reg += 8;
 
-		  func (stream, "%s", arm_regnames[reg]);
+		  func (stream, "%s", arm_regnames (info)[reg]);
 		}
 		break;
 
@@ -10637,7 +10650,7 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 			if (started)
 			  func (stream, ", ");
 			started = 1;
-			func (stream, "%s", arm_regnames[reg]);
+			func (stream, "%s", arm_regnames (info)[reg]);
 		      }
 
 		  if (domasklr)
@@ -10645,14 +10658,14 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 		      if (started)
 			func (stream, ", ");
 		      started = 1;
-		      func (stream, "%s", arm_regnames[14] /* "lr" */);
+		      func (stream, "%s", arm_regnames (info)[14] /* "lr" */);
 		    }
 
 		  if (domaskpc)
 		    {
 		      if (started)
 			func (stream, ", ");
-		      func (stream, "%s", arm_regnames[15] /* "pc" */);
+		      func (stream, "%s", arm_regnames (info)[15] /* "pc" */);
 		    }
 
 		  func (stream, "}");
@@ -10719,7 +10732,7 @@ print_insn_thumb16 (bfd_vma pc, struct disassemble_info *info, long given)
 			switch (*c)
 			  {
 			  case 'r':
-			    func (stream, "%s", arm_regnames[reg]);
+			    func (stream, "%s", arm_regnames (info)[reg]);
 			    break;
 
 			  case 'd':
@@ -10849,6 +10862,7 @@ static void
 print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 {
   const struct opcode32 *insn;
+  struct arm_private_data *private_data = info->private_data;
   void *stream = info->stream;
   fprintf_ftype func = info->fprintf_func;
   bool is_mve = is_mve_architecture (info);
@@ -10891,19 +10905,19 @@ print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 		break;
 
 	      case 'c':
-		if (ifthen_state)
-		  func (stream, "%s", arm_conditional[IFTHEN_COND]);
+		if (private_data->ifthen_state)
+		  func (stream, "%s", arm_conditional[IFTHEN_COND (private_data)]);
 		break;
 
 	      case 'x':
-		if (ifthen_next_state)
+		if (private_data->ifthen_next_state)
 		  func (stream, "\t; unpredictable branch in IT block\n");
 		break;
 
 	      case 'X':
-		if (ifthen_state)
+		if (private_data->ifthen_state)
 		  func (stream, "\t; unpredictable <IT:%s>",
-			arm_conditional[IFTHEN_COND]);
+			arm_conditional[IFTHEN_COND (private_data)]);
 		break;
 
 	      case 'I':
@@ -10998,7 +11012,7 @@ print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 		  imm |= (given & 0x000000c0u) >> 6;
 		  imm |= (given & 0x00007000u) >> 10;
 
-		  func (stream, "%s", arm_regnames[reg]);
+		  func (stream, "%s", arm_regnames (info)[reg]);
 		  switch (stp)
 		    {
 		    case 0:
@@ -11037,7 +11051,7 @@ print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 		  bool writeback = false, postind = false;
 		  bfd_vma offset = 0;
 
-		  func (stream, "[%s", arm_regnames[Rn]);
+		  func (stream, "[%s", arm_regnames (info)[Rn]);
 		  if (U) /* 12-bit positive immediate offset.  */
 		    {
 		      offset = i12;
@@ -11051,7 +11065,7 @@ print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 		      unsigned int Rm = (i8 & 0x0f);
 		      unsigned int sh = (i8 & 0x30) >> 4;
 
-		      func (stream, ", %s", arm_regnames[Rm]);
+		      func (stream, ", %s", arm_regnames (info)[Rm]);
 		      if (sh)
 			func (stream, ", lsl #%u", sh);
 		      func (stream, "]");
@@ -11117,7 +11131,7 @@ print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 		  unsigned int Rn  = (given & 0x000f0000) >> 16;
 		  unsigned int off = (given & 0x000000ff);
 
-		  func (stream, "[%s", arm_regnames[Rn]);
+		  func (stream, "[%s", arm_regnames (info)[Rn]);
 
 		  if (PRE_BIT_SET)
 		    {
@@ -11183,11 +11197,11 @@ print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 			  func (stream, ", ");
 			started = 1;
 			if (is_clrm && reg == 13)
-			  func (stream, "(invalid: %s)", arm_regnames[reg]);
+			  func (stream, "(invalid: %s)", arm_regnames (info)[reg]);
 			else if (is_clrm && reg == 15)
 			  func (stream, "%s", "APSR");
 			else
-			  func (stream, "%s", arm_regnames[reg]);
+			  func (stream, "%s", arm_regnames (info)[reg]);
 		      }
 		  func (stream, "}");
 		}
@@ -11495,7 +11509,7 @@ print_insn_thumb32 (bfd_vma pc, struct disassemble_info *info, long given)
 			is_unpredictable = true;
 		      /* Fall through.  */
 		    case 'r':
-		      func (stream, "%s", arm_regnames[val]);
+		      func (stream, "%s", arm_regnames (info)[val]);
 		      break;
 
 		    case 'c':
@@ -11609,11 +11623,13 @@ arm_symbol_is_valid (asymbol * sym,
 /* Parse the string of disassembler options.  */
 
 static void
-parse_arm_disassembler_options (const char *options)
+parse_arm_disassembler_options (struct disassemble_info *info,
+				const char *options)
 {
+  struct arm_private_data *private_data = info->private_data;
   const char *opt;
 
-  force_thumb = false;
+  private_data->force_thumb = false;
   FOR_EACH_DISASSEMBLER_OPTION (opt, options)
     {
       if (startswith (opt, "reg-names-"))
@@ -11622,7 +11638,7 @@ parse_arm_disassembler_options (const char *options)
 	  for (i = 0; i < NUM_ARM_OPTIONS; i++)
 	    if (disassembler_options_cmp (opt, regnames[i].name) == 0)
 	      {
-		regname_selected = i;
+		private_data->regname_selected = i;
 		break;
 	      }
 
@@ -11632,9 +11648,9 @@ parse_arm_disassembler_options (const char *options)
 				   opt);
 	}
       else if (startswith (opt, "force-thumb"))
-	force_thumb = 1;
+	private_data->force_thumb = 1;
       else if (startswith (opt, "no-force-thumb"))
-	force_thumb = 0;
+	private_data->force_thumb = 0;
       else if (startswith (opt, "coproc"))
 	{
 	  const char *procptr = opt + sizeof ("coproc") - 1;
@@ -11654,10 +11670,10 @@ parse_arm_disassembler_options (const char *options)
 	    }
 	  endptr += 1;
 	  if (startswith (endptr, "generic"))
-	    cde_coprocs &= ~(1 << coproc_number);
+	    private_data->cde_coprocs &= ~(1 << coproc_number);
 	  else if (startswith (endptr, "cde")
 		   || startswith (endptr, "CDE"))
-	    cde_coprocs |= (1 << coproc_number);
+	    private_data->cde_coprocs |= (1 << coproc_number);
 	  else
 	    {
 	      opcodes_error_handler (
@@ -11694,9 +11710,10 @@ find_ifthen_state (bfd_vma pc,
   int it_count;
   unsigned int seen_it;
   bfd_vma addr;
+  struct arm_private_data *private_data = info->private_data;
 
-  ifthen_address = pc;
-  ifthen_state = 0;
+  private_data->ifthen_address = pc;
+  private_data->ifthen_state = 0;
 
   addr = pc;
   count = 1;
@@ -11758,9 +11775,10 @@ find_ifthen_state (bfd_vma pc,
 	return;
     }
   /* We found an IT instruction.  */
-  ifthen_state = (seen_it & 0xe0) | ((seen_it << it_count) & 0x1f);
-  if ((ifthen_state & 0xf) == 0)
-    ifthen_state = 0;
+  private_data->ifthen_state = ((seen_it & 0xe0)
+				| ((seen_it << it_count) & 0x1f));
+  if ((private_data->ifthen_state & 0xf) == 0)
+    private_data->ifthen_state = 0;
 }
 
 /* Returns nonzero and sets *MAP_TYPE if the N'th symbol is a
@@ -11968,7 +11986,7 @@ mapping_symbol_for_insn (bfd_vma pc, struct disassemble_info *info,
 
 static void
 select_arm_features (unsigned long mach,
-		     arm_feature_set * features)
+		     struct arm_private_data *private_data)
 {
   arm_feature_set arch_fset;
   const arm_feature_set fpu_any = FPU_ANY;
@@ -12026,7 +12044,7 @@ select_arm_features (unsigned long mach,
       arm_feature_set mve_all
 	= ARM_FEATURE_CORE_HIGH (ARM_EXT2_MVE | ARM_EXT2_MVE_FP);
       ARM_MERGE_FEATURE_SETS (arch_fset, arch_fset, mve_all);
-      force_thumb = 1;
+      private_data->force_thumb = 1;
       break;
     case bfd_mach_arm_9:         ARM_SET_FEATURES (ARM_ARCH_V9A); break;
       /* If the machine type is unknown allow all architecture types and all
@@ -12042,7 +12060,7 @@ select_arm_features (unsigned long mach,
   /* None of the feature bits related to -mfpu have an impact on Tag_CPU_arch
      and thus on bfd_mach_arm_XXX value.  Therefore for a given
      bfd_mach_arm_XXX value all coprocessor feature bits should be allowed.  */
-  ARM_MERGE_FEATURE_SETS (*features, arch_fset, fpu_any);
+  ARM_MERGE_FEATURE_SETS (private_data->features, arch_fset, fpu_any);
 }
 
 
@@ -12071,18 +12089,23 @@ print_insn (bfd_vma pc, struct disassemble_info *info, bool little)
   info->target = 0;
   info->target2 = 0;
 
-  if (info->disassembler_options)
+  /* PR 10288: Control which instructions will be disassembled.  */
+  private_data = info->private_data;
+  if (private_data == NULL)
     {
-      parse_arm_disassembler_options (info->disassembler_options);
+      private_data = XCNEW (struct arm_private_data);
+      private_data->regname_selected = DEFAULT_REGNAME_SELECTED;
+      private_data->last_mapping_sym = -1;
+      info->private_data = private_data;
 
-      /* To avoid repeated parsing of these options, we remove them here.  */
-      info->disassembler_options = NULL;
-    }
+      if (info->disassembler_options)
+	{
+	  parse_arm_disassembler_options (info, info->disassembler_options);
 
-  /* PR 10288: Control which instructions will be disassembled.  */
-  if (info->private_data == NULL)
-    {
-      static struct arm_private_data private;
+	  /* To avoid repeated parsing of these options, we remove them
+	     here.  */
+	  info->disassembler_options = NULL;
+	}
 
       if ((info->flags & USER_SPECIFIED_MACHINE_TYPE) == 0)
 	/* If the user did not use the -m command line switch then default to
@@ -12108,16 +12131,13 @@ print_insn (bfd_vma pc, struct disassemble_info *info, bool little)
       /* Compute the architecture bitmask from the machine number.
 	 Note: This assumes that the machine number will not change
 	 during disassembly....  */
-      select_arm_features (info->mach, & private.features);
-
-      private.last_mapping_sym = -1;
-      private.last_mapping_addr = 0;
-      private.last_stop_offset = 0;
-
-      info->private_data = & private;
+      select_arm_features (info->mach, private_data);
+    }
+  else if (info->disassembler_options)
+    {
+      parse_arm_disassembler_options (info, info->disassembler_options);
+      info->disassembler_options = NULL;
     }
-
-  private_data = info->private_data;
 
   /* Decide if our code is going to be little-endian, despite what the
      function argument might say.  */
@@ -12203,7 +12223,7 @@ print_insn (bfd_vma pc, struct disassemble_info *info, bool little)
 	}
     }
 
-  if (force_thumb)
+  if (private_data->force_thumb)
     is_thumb = true;
 
   if (is_data)
@@ -12280,16 +12300,17 @@ print_insn (bfd_vma pc, struct disassemble_info *info, bool little)
 	    }
 	}
 
-      if (ifthen_address != pc)
+      if (private_data->ifthen_address != pc)
 	find_ifthen_state (pc, info, little_code);
 
-      if (ifthen_state)
+      if (private_data->ifthen_state)
 	{
-	  if ((ifthen_state & 0xf) == 0x8)
-	    ifthen_next_state = 0;
+	  if ((private_data->ifthen_state & 0xf) == 0x8)
+	    private_data->ifthen_next_state = 0;
 	  else
-	    ifthen_next_state = (ifthen_state & 0xe0)
-				| ((ifthen_state & 0xf) << 1);
+	    private_data->ifthen_next_state
+	      = ((private_data->ifthen_state & 0xe0)
+		 | ((private_data->ifthen_state & 0xf) << 1));
 	}
     }
 
@@ -12310,8 +12331,8 @@ print_insn (bfd_vma pc, struct disassemble_info *info, bool little)
 
   if (is_thumb)
     {
-      ifthen_state = ifthen_next_state;
-      ifthen_address += size;
+      private_data->ifthen_state = private_data->ifthen_next_state;
+      private_data->ifthen_address += size;
     }
   return size;
 }
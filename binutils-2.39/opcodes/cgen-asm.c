@@ -31,6 +31,7 @@
 static CGEN_INSN_LIST *  hash_insn_array      (CGEN_CPU_DESC, const CGEN_INSN *, int, int, CGEN_INSN_LIST **, CGEN_INSN_LIST *);
 static CGEN_INSN_LIST *  hash_insn_list       (CGEN_CPU_DESC, const CGEN_INSN_LIST *, CGEN_INSN_LIST **, CGEN_INSN_LIST *);
 static void              build_asm_hash_table (CGEN_CPU_DESC);
+static bool              asm_insn_may_match_p (const CGEN_INSN *, const char *, const unsigned char *);
 
 /* Set the cgen_parse_operand_fn callback.  */
 
@@ -168,20 +169,115 @@ build_asm_hash_table (CGEN_CPU_DESC cd)
 
   cd->asm_hash_table = asm_hash_table;
   cd->asm_hash_table_entries = asm_hash_table_entries;
+
+  /* cgen_asm_lookup_insn returns a list built in here, which can be
+     no longer than the hash chain it is drawn from.  */
+  cd->asm_lookup_list = (CGEN_INSN_LIST *)
+    xmalloc (count * sizeof (CGEN_INSN_LIST));
+}
+
+/* Return true if the regular expression that @arch@_cgen_build_insn_regex
+   built for INSN might match STR.  SEEN has a bit set for every character
+   in STR, after conversion to lower case.
+
+   The regular expression starts with the mnemonic, one bracket
+   expression per letter, and is not anchored at the start, so it can
+   only match if the mnemonic occurs somewhere in STR.  When we can't be
+   sure of that we return true and leave it to the regular expression.  */
+
+static bool
+asm_insn_may_match_p (const CGEN_INSN *insn, const char *str,
+		      const unsigned char *seen)
+{
+  const char *mnem = CGEN_INSN_MNEMONIC (insn);
+  const char *p, *q, *m;
+
+  if (CGEN_INSN_RX (insn) == NULL || *mnem == 0)
+    return true;
+
+  /* Check cheaply that each character of the mnemonic appears somewhere
+     in STR.  A '.' matches any character; anything else that is special
+     in a basic regular expression gives up.  */
+  for (m = mnem; *m != 0; m++)
+    {
+      unsigned char c = TOLOWER (*m);
+
+      if (c == '.')
+	continue;
+      if (c == '[' || c == '\\' || c == '*' || c == '^' || c == '$')
+	return true;
+      if ((seen[c / 8] & (1 << (c % 8))) == 0)
+	return false;
+    }
+
+  for (p = str; *p != 0; p++)
+    {
+      for (m = mnem, q = p; *m != 0 && *q != 0; m++, q++)
+	if (*m != '.' && TOLOWER (*m) != TOLOWER (*q))
+	  break;
+      if (*m == 0)
+	return true;
+    }
+  return false;
 }
 
-/* Return the first entry in the hash list for INSN.  */
+/* Return the first entry in a list of the insns that might match INSN.
+
+   The list is the hash chain for INSN, less any entries whose regular
+   expression can't match.  The assembler would skip those without
+   trying to parse them, so dropping them here doesn't change which insn
+   is chosen or what errors are reported.  One such entry is kept if all
+   of them would be dropped, since the assembler reports an empty chain
+   differently.  The list is only valid until the next call.  */
 
 CGEN_INSN_LIST *
 cgen_asm_lookup_insn (CGEN_CPU_DESC cd, const char *insn)
 {
   unsigned int hash;
+  unsigned char seen[256 / 8];
+  CGEN_INSN_LIST *ilist, *dropped, *entry;
+  const char *p;
 
   if (cd->asm_hash_table == NULL)
     build_asm_hash_table (cd);
 
   hash = (* cd->asm_hash) (insn);
-  return cd->asm_hash_table[hash];
+  ilist = cd->asm_hash_table[hash];
+  if (ilist == NULL)
+    return NULL;
+
+  /* A '.' in a mnemonic can match a multibyte character, so leave
+     anything that isn't plain ASCII to the regular expressions.  */
+  memset (seen, 0, sizeof (seen));
+  for (p = insn; *p != 0; p++)
+    {
+      unsigned char c = TOLOWER (*p);
+
+      if (c >= 0x80)
+	return ilist;
+      seen[c / 8] |= 1 << (c % 8);
+    }
+
+  dropped = NULL;
+  entry = cd->asm_lookup_list;
+  for (; ilist != NULL; ilist = ilist->next)
+    if (asm_insn_may_match_p (ilist->insn, insn, seen))
+      {
+	entry->insn = ilist->insn;
+	entry->next = entry + 1;
+	entry++;
+      }
+    else if (dropped == NULL)
+      dropped = ilist;
+
+  if (entry == cd->asm_lookup_list)
+    {
+      entry->insn = dropped->insn;
+      entry++;
+    }
+  entry[-1].next = NULL;
+
+  return cd->asm_lookup_list;
 }
 
 /* Keyword parser.
@@ -34,6 +34,39 @@ static void		 add_insn_to_hash_chain (CGEN_INSN_LIST *,
 						 const CGEN_INSN *,
 						 CGEN_INSN_LIST **,
 						 unsigned int);
+static bool		 dis_value_insn_p       (CGEN_CPU_DESC, const CGEN_INSN *);
+static CGEN_INSN_LIST *  make_insn_list         (const CGEN_INSN **, unsigned int);
+static struct cgen_dis_decode_node *
+			 build_dis_decode_node  (CGEN_CPU_DESC,
+						 const CGEN_INSN **,
+						 unsigned int,
+						 CGEN_INSN_INT);
+
+/* A node in the decision tree for one disassembler hash chain.
+
+   Callers match an insn that is at least base_insn_bitsize long by
+   checking VALUE & the insn's base mask against its base value, so it
+   can only match if VALUE & MASK is its base value & MASK.  Shorter
+   insns are checked against a prefix of the insn bytes instead, so they
+   are kept in every list.
+
+   If MASK is zero the node is a leaf and LIST holds the candidates.
+   Otherwise CHILDREN[I] is the subtree for VALUE & MASK == KEYS[I],
+   KEYS being sorted, and LIST holds the candidates when VALUE & MASK
+   is none of KEYS.  Every list is in hash chain order.  */
+
+struct cgen_dis_decode_node
+{
+  CGEN_INSN_INT mask;
+  unsigned int num_keys;
+  CGEN_INSN_INT *keys;
+  struct cgen_dis_decode_node **children;
+  CGEN_INSN_LIST *list;
+};
+
+/* Don't split nodes with this few insns that are checked against
+   VALUE.  */
+#define DIS_DECODE_LEAF_SIZE 4
 
 /* Return the number of decodable bits in this insn.  */
 static int
@@ -174,6 +207,113 @@ hash_insn_list (CGEN_CPU_DESC cd,
   return hentbuf;
 }
 
+/* Return true if callers check INSN against the base insn value
+   rather than a prefix of the insn bytes.  */
+
+static bool
+dis_value_insn_p (CGEN_CPU_DESC cd, const CGEN_INSN *insn)
+{
+  return (unsigned) CGEN_INSN_BITSIZE (insn) >= cd->base_insn_bitsize;
+}
+
+/* Return a list of the COUNT insns in INSNS, in order.  */
+
+static CGEN_INSN_LIST *
+make_insn_list (const CGEN_INSN **insns, unsigned int count)
+{
+  CGEN_INSN_LIST *list;
+  unsigned int i;
+
+  if (count == 0)
+    return NULL;
+
+  list = (CGEN_INSN_LIST *) xmalloc (count * sizeof (CGEN_INSN_LIST));
+  for (i = 0; i < count; i++)
+    {
+      list[i].insn = insns[i];
+      list[i].next = i + 1 < count ? &list[i + 1] : NULL;
+    }
+  return list;
+}
+
+static int
+compare_insn_ints (const void *a, const void *b)
+{
+  CGEN_INSN_INT ia = *(const CGEN_INSN_INT *) a;
+  CGEN_INSN_INT ib = *(const CGEN_INSN_INT *) b;
+
+  return ia < ib ? -1 : ia > ib;
+}
+
+/* Build a decision tree node for the COUNT insns in INSNS, which are in
+   hash chain order.  TESTED is the set of bits that enclosing nodes have
+   already decided on.  */
+
+static struct cgen_dis_decode_node *
+build_dis_decode_node (CGEN_CPU_DESC cd,
+		       const CGEN_INSN **insns,
+		       unsigned int count,
+		       CGEN_INSN_INT tested)
+{
+  struct cgen_dis_decode_node *node;
+  const CGEN_INSN **subset;
+  CGEN_INSN_INT mask = ~tested;
+  unsigned int i, j, k, num_value_insns = 0;
+
+  /* Split on the bits that every insn checked against VALUE has in its
+     mask.  There is little point if most of the insns would end up in
+     every child anyway.  */
+  for (i = 0; i < count; i++)
+    if (dis_value_insn_p (cd, insns[i]))
+      {
+	mask &= CGEN_INSN_BASE_MASK (insns[i]);
+	num_value_insns++;
+      }
+
+  node = (struct cgen_dis_decode_node *) xmalloc (sizeof (*node));
+  memset (node, 0, sizeof (*node));
+  if (num_value_insns <= DIS_DECODE_LEAF_SIZE
+      || count - num_value_insns >= num_value_insns
+      || mask == 0)
+    {
+      node->list = make_insn_list (insns, count);
+      return node;
+    }
+
+  node->mask = mask;
+  node->keys = (CGEN_INSN_INT *)
+    xmalloc (num_value_insns * sizeof (CGEN_INSN_INT));
+  for (i = 0, k = 0; i < count; i++)
+    if (dis_value_insn_p (cd, insns[i]))
+      node->keys[k++] = CGEN_INSN_BASE_VALUE (insns[i]) & mask;
+  qsort (node->keys, k, sizeof (node->keys[0]), compare_insn_ints);
+  for (i = 1, j = 1; i < k; i++)
+    if (node->keys[i] != node->keys[j - 1])
+      node->keys[j++] = node->keys[i];
+  node->num_keys = j;
+
+  node->children = (struct cgen_dis_decode_node **)
+    xmalloc (node->num_keys * sizeof (struct cgen_dis_decode_node *));
+  subset = (const CGEN_INSN **) xmalloc (count * sizeof (CGEN_INSN *));
+  for (i = 0; i < node->num_keys; i++)
+    {
+      for (j = 0, k = 0; j < count; j++)
+	if (!dis_value_insn_p (cd, insns[j])
+	    || (CGEN_INSN_BASE_VALUE (insns[j]) & mask) == node->keys[i])
+	  subset[k++] = insns[j];
+      node->children[i] = build_dis_decode_node (cd, subset, k,
+						 tested | mask);
+    }
+
+  for (j = 0, k = 0; j < count; j++)
+    if (!dis_value_insn_p (cd, insns[j]))
+      subset[k++] = insns[j];
+  node->list = make_insn_list (subset, k);
+
+  free (subset);
+  return node;
+}
+
 /* Build the disassembler instruction hash table.  */
 
 static void
@@ -186,6 +326,9 @@ build_dis_hash_table (CGEN_CPU_DESC cd)
   CGEN_INSN_LIST *hash_entry_buf;
   CGEN_INSN_LIST **dis_hash_table;
   CGEN_INSN_LIST *dis_hash_table_entries;
+  struct cgen_dis_decode_node **dis_decode_table;
+  const CGEN_INSN **insns;
+  unsigned int i;
 
   /* The space allocated for the hash table consists of two parts:
      the hash table and the hash lists.  */
@@ -227,19 +370,59 @@ build_dis_hash_table (CGEN_CPU_DESC cd)
 
   cd->dis_hash_table = dis_hash_table;
   cd->dis_hash_table_entries = dis_hash_table_entries;
+
+  /* Build a decision tree for each hash chain.  */
+  dis_decode_table = (struct cgen_dis_decode_node **)
+    xmalloc (hash_size * sizeof (struct cgen_dis_decode_node *));
+  insns = (const CGEN_INSN **) xmalloc (count * sizeof (CGEN_INSN *));
+  for (i = 0; i < hash_size; i++)
+    {
+      CGEN_INSN_LIST *ilist;
+      unsigned int n = 0;
+
+      for (ilist = dis_hash_table[i]; ilist != NULL; ilist = ilist->next)
+	insns[n++] = ilist->insn;
+      dis_decode_table[i] = build_dis_decode_node (cd, insns, n, 0);
+    }
+  free (insns);
+
+  cd->dis_decode_table = dis_decode_table;
 }
 
-/* Return the first entry in the hash list for INSN.  */
+/* Return the first entry in a list of the insns that might match INSN.
+   This is the hash chain for INSN, less any insns that callers would
+   reject because VALUE doesn't match their base mask and value.  */
 
 CGEN_INSN_LIST *
 cgen_dis_lookup_insn (CGEN_CPU_DESC cd, const char * buf, CGEN_INSN_INT value)
 {
   unsigned int hash;
+  const struct cgen_dis_decode_node *node;
 
   if (cd->dis_hash_table == NULL)
     build_dis_hash_table (cd);
 
   hash = (* cd->dis_hash) (buf, value);
 
-  return cd->dis_hash_table[hash];
+  node = cd->dis_decode_table[hash];
+  while (node->mask != 0)
+    {
+      CGEN_INSN_INT key = value & node->mask;
+      unsigned int lo = 0, hi = node->num_keys;
+
+      while (lo < hi)
+	{
+	  unsigned int mid = lo + (hi - lo) / 2;
+
+	  if (node->keys[mid] < key)
+	    lo = mid + 1;
+	  else
+	    hi = mid;
+	}
+      if (lo == node->num_keys || node->keys[lo] != key)
+	break;
+      node = node->children[lo];
+    }
+
+  return node->list;
 }
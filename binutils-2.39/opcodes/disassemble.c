@@ -745,6 +745,15 @@ disassemble_free_target (struct disassemble_info *info)
     default:
       return;
 
+#ifdef ARCH_aarch64
+    case bfd_arch_aarch64:
+      disassemble_free_aarch64 (info);
+      break;
+#endif
+#ifdef ARCH_arm
+    case bfd_arch_arm:
+      break;
+#endif
 #ifdef ARCH_bpf
     case bfd_arch_bpf:
 #endif
@@ -782,6 +791,7 @@ disassemble_free_target (struct disassemble_info *info)
 #endif
 #ifdef ARCH_riscv
     case bfd_arch_riscv:
+      disassemble_free_riscv (info);
       break;
 #endif
 #ifdef ARCH_rs6000
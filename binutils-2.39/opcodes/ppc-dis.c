@@ -36,11 +36,24 @@
 static int print_insn_powerpc (bfd_vma, struct disassemble_info *, int,
 			       ppc_cpu_t);
 
+#define PPC_OPCD_SEGS (1 + PPC_OP (-1))
+#define PREFIX_OPCD_SEGS (1 + PPC_PREFIX_SEG (-1))
+#define VLE_OPCD_SEGS (1 + VLE_OP_TO_SEG (VLE_OP (-1, 0xffff)))
+#define SPE2_OPCD_SEGS (1 + SPE2_XOP_TO_SEG (SPE2_XOP (-1)))
+
 struct dis_private
 {
   /* Stash the result of parsing disassembler_options here.  */
   ppc_cpu_t dialect;
 
+  /* Opcode table indices to speed up disassembly.  These are kept here
+     rather than in static tables so that no state is shared between
+     disassemble_info structures.  */
+  unsigned short powerpc_opcd_indices[PPC_OPCD_SEGS + 1];
+  unsigned short prefix_opcd_indices[PREFIX_OPCD_SEGS + 1];
+  unsigned short vle_opcd_indices[VLE_OPCD_SEGS + 1];
+  unsigned short spe2_opcd_indices[SPE2_OPCD_SEGS + 1];
+
   /* .got and .plt sections.  NAME is set to NULL if not present.  */
   struct sec_buf {
     asection *sec;
@@ -400,15 +413,6 @@ powerpc_init_dialect (struct disassemble_info *info)
   private_data (info)->dialect = dialect;
 }
 
-#define PPC_OPCD_SEGS (1 + PPC_OP (-1))
-static unsigned short powerpc_opcd_indices[PPC_OPCD_SEGS + 1];
-#define PREFIX_OPCD_SEGS (1 + PPC_PREFIX_SEG (-1))
-static unsigned short prefix_opcd_indices[PREFIX_OPCD_SEGS + 1];
-#define VLE_OPCD_SEGS (1 + VLE_OP_TO_SEG (VLE_OP (-1, 0xffff)))
-static unsigned short vle_opcd_indices[VLE_OPCD_SEGS + 1];
-#define SPE2_OPCD_SEGS (1 + SPE2_XOP_TO_SEG (SPE2_XOP (-1)))
-static unsigned short spe2_opcd_indices[SPE2_OPCD_SEGS + 1];
-
 static bool
 ppc_symbol_is_valid (asymbol *sym,
 		     struct disassemble_info *info ATTRIBUTE_UNUSED)
@@ -437,10 +441,18 @@ ppc_symbol_is_valid (asymbol *sym,
 void
 disassemble_init_powerpc (struct disassemble_info *info)
 {
+  struct dis_private *priv;
+
   info->symbol_is_valid = ppc_symbol_is_valid;
 
-  if (powerpc_opcd_indices[PPC_OPCD_SEGS] == 0)
+  powerpc_init_dialect (info);
+  priv = private_data (info);
+  if (priv != NULL)
     {
+      unsigned short *powerpc_opcd_indices = priv->powerpc_opcd_indices;
+      unsigned short *prefix_opcd_indices = priv->prefix_opcd_indices;
+      unsigned short *vle_opcd_indices = priv->vle_opcd_indices;
+      unsigned short *spe2_opcd_indices = priv->spe2_opcd_indices;
       unsigned seg, idx, op;
 
       /* PPC opcodes */
@@ -484,13 +496,9 @@ disassemble_init_powerpc (struct disassemble_info *info)
 		break;
 	    }
 	}
-    }
 
-  powerpc_init_dialect (info);
-  if (info->private_data != NULL)
-    {
-      private_data (info)->special[0].name = ".got";
-      private_data (info)->special[1].name = ".plt";
+      priv->special[0].name = ".got";
+      priv->special[1].name = ".plt";
     }
 }
 
@@ -578,7 +586,7 @@ skip_optional_operands (const ppc_opindex_t *opindex,
 /* Find a match for INSN in the opcode table, given machine DIALECT.  */
 
 static const struct powerpc_opcode *
-lookup_powerpc (uint64_t insn, ppc_cpu_t dialect)
+lookup_powerpc (uint64_t insn, ppc_cpu_t dialect, const struct dis_private *priv)
 {
   const struct powerpc_opcode *opcode, *opcode_end;
   unsigned long op;
@@ -587,8 +595,8 @@ lookup_powerpc (uint64_t insn, ppc_cpu_t dialect)
   op = PPC_OP (insn);
 
   /* Find the first match in the opcode table for this major opcode.  */
-  opcode_end = powerpc_opcodes + powerpc_opcd_indices[op + 1];
-  for (opcode = powerpc_opcodes + powerpc_opcd_indices[op];
+  opcode_end = powerpc_opcodes + priv->powerpc_opcd_indices[op + 1];
+  for (opcode = powerpc_opcodes + priv->powerpc_opcd_indices[op];
        opcode < opcode_end;
        ++opcode)
     {
@@ -623,7 +631,7 @@ lookup_powerpc (uint64_t insn, ppc_cpu_t dialect)
 /* Find a match for INSN in the PREFIX opcode table.  */
 
 static const struct powerpc_opcode *
-lookup_prefix (uint64_t insn, ppc_cpu_t dialect)
+lookup_prefix (uint64_t insn, ppc_cpu_t dialect, const struct dis_private *priv)
 {
   const struct powerpc_opcode *opcode, *opcode_end;
   unsigned long seg;
@@ -632,8 +640,8 @@ lookup_prefix (uint64_t insn, ppc_cpu_t dialect)
   seg = PPC_PREFIX_SEG (insn);
 
   /* Find the first match in the opcode table for this major opcode.  */
-  opcode_end = prefix_opcodes + prefix_opcd_indices[seg + 1];
-  for (opcode = prefix_opcodes + prefix_opcd_indices[seg];
+  opcode_end = prefix_opcodes + priv->prefix_opcd_indices[seg + 1];
+  for (opcode = prefix_opcodes + priv->prefix_opcd_indices[seg];
        opcode < opcode_end;
        ++opcode)
     {
@@ -667,7 +675,7 @@ lookup_prefix (uint64_t insn, ppc_cpu_t dialect)
 /* Find a match for INSN in the VLE opcode table.  */
 
 static const struct powerpc_opcode *
-lookup_vle (uint64_t insn, ppc_cpu_t dialect)
+lookup_vle (uint64_t insn, ppc_cpu_t dialect, const struct dis_private *priv)
 {
   const struct powerpc_opcode *opcode;
   const struct powerpc_opcode *opcode_end;
@@ -682,8 +690,8 @@ lookup_vle (uint64_t insn, ppc_cpu_t dialect)
   seg = VLE_OP_TO_SEG (op);
 
   /* Find the first match in the opcode table for this major opcode.  */
-  opcode_end = vle_opcodes + vle_opcd_indices[seg + 1];
-  for (opcode = vle_opcodes + vle_opcd_indices[seg];
+  opcode_end = vle_opcodes + priv->vle_opcd_indices[seg + 1];
+  for (opcode = vle_opcodes + priv->vle_opcd_indices[seg];
        opcode < opcode_end;
        ++opcode)
     {
@@ -722,7 +730,7 @@ lookup_vle (uint64_t insn, ppc_cpu_t dialect)
 /* Find a match for INSN in the SPE2 opcode table.  */
 
 static const struct powerpc_opcode *
-lookup_spe2 (uint64_t insn, ppc_cpu_t dialect)
+lookup_spe2 (uint64_t insn, ppc_cpu_t dialect, const struct dis_private *priv)
 {
   const struct powerpc_opcode *opcode, *opcode_end;
   unsigned op, xop, seg;
@@ -738,8 +746,8 @@ lookup_spe2 (uint64_t insn, ppc_cpu_t dialect)
   seg = SPE2_XOP_TO_SEG (xop);
 
   /* Find the first match in the opcode table for this major opcode.  */
-  opcode_end = spe2_opcodes + spe2_opcd_indices[seg + 1];
-  for (opcode = spe2_opcodes + spe2_opcd_indices[seg];
+  opcode_end = spe2_opcodes + priv->spe2_opcd_indices[seg + 1];
+  for (opcode = spe2_opcodes + priv->spe2_opcd_indices[seg];
        opcode < opcode_end;
        ++opcode)
     {
@@ -854,6 +862,7 @@ print_insn_powerpc (bfd_vma memaddr,
   uint64_t insn;
   const struct powerpc_opcode *opcode;
   int insn_length = 4;  /* Assume we have a normal 4-byte instruction.  */
+  struct dis_private *priv = private_data (info);
 
   status = (*info->read_memory_func) (memaddr, buffer, 4, info);
 
@@ -891,9 +900,9 @@ print_insn_powerpc (bfd_vma memaddr,
 	  else
 	    suffix = bfd_getl32 (buffer);
 	  temp_insn = (insn << 32) | suffix;
-	  opcode = lookup_prefix (temp_insn, dialect & ~PPC_OPCODE_ANY);
+	  opcode = lookup_prefix (temp_insn, dialect & ~PPC_OPCODE_ANY, priv);
 	  if (opcode == NULL && (dialect & PPC_OPCODE_ANY) != 0)
-	    opcode = lookup_prefix (temp_insn, dialect);
+	    opcode = lookup_prefix (temp_insn, dialect, priv);
 	  if (opcode != NULL)
 	    {
 	      insn = temp_insn;
@@ -905,7 +914,7 @@ print_insn_powerpc (bfd_vma memaddr,
     }
   if (opcode == NULL && (dialect & PPC_OPCODE_VLE) != 0)
     {
-      opcode = lookup_vle (insn, dialect);
+      opcode = lookup_vle (insn, dialect, priv);
       if (opcode != NULL && PPC_OP_SE_VLE (opcode->mask))
 	{
 	  /* The operands will be fetched out of the 16-bit instruction.  */
@@ -913,14 +922,16 @@ print_insn_powerpc (bfd_vma memaddr,
 	  insn_length = 2;
 	}
     }
-  if (opcode == NULL && insn_length == 4)
+  /* Without disassemble_init_powerpc there are no opcode indices, and
+     DIALECT is zero so nothing would match anyway.  */
+  if (opcode == NULL && insn_length == 4 && priv != NULL)
     {
       if ((dialect & PPC_OPCODE_SPE2) != 0)
-	opcode = lookup_spe2 (insn, dialect);
+	opcode = lookup_spe2 (insn, dialect, priv);
       if (opcode == NULL)
-	opcode = lookup_powerpc (insn, dialect & ~PPC_OPCODE_ANY);
+	opcode = lookup_powerpc (insn, dialect & ~PPC_OPCODE_ANY, priv);
       if (opcode == NULL && (dialect & PPC_OPCODE_ANY) != 0)
-	opcode = lookup_powerpc (insn, dialect);
+	opcode = lookup_powerpc (insn, dialect, priv);
     }
 
   if (opcode != NULL)
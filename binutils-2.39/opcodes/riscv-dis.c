@@ -32,56 +32,71 @@
 #include <stdint.h>
 #include <ctype.h>
 
-static enum riscv_spec_class default_isa_spec = ISA_SPEC_CLASS_DRAFT - 1;
-static enum riscv_spec_class default_priv_spec = PRIV_SPEC_CLASS_NONE;
+/* A node of the tree used to find the candidate opcodes for a word.
+   Inner nodes select a child by the value of one field of the word;
+   leaves hold the opcodes that might match, in riscv_opcodes order.  */
 
-unsigned xlen = 0;
-
-static riscv_subset_list_t riscv_subsets;
-static riscv_parse_subset_t riscv_rps_dis =
+struct riscv_decode_node
 {
-  &riscv_subsets,	/* subset_list.  */
-  opcodes_error_handler,/* error_handler.  */
-  &xlen,		/* xlen.  */
-  &default_isa_spec,	/* isa_spec.  */
-  false,		/* check_unknown_prefixed_ext.  */
+  /* The field of the word that selects a child.  WIDTH is zero for a
+     leaf.  */
+  unsigned int shift;
+  unsigned int width;
+  struct riscv_decode_node **children;
+
+  /* For a leaf, the candidate opcodes, terminated by NULL.  */
+  const struct riscv_opcode **ops;
 };
 
+/* All the state the disassembler keeps between instructions is here, in
+   INFO->private_data, so that separate disassemble_info structures can be
+   used from separate threads.  */
+
 struct riscv_private_data
 {
   bfd_vma gp;
   bfd_vma print_addr;
   bfd_vma hi_addr[OP_MASK_RD + 1];
-};
 
-/* Used for mapping symbols.  */
-static int last_map_symbol = -1;
-static bfd_vma last_stop_offset = 0;
-enum riscv_seg_mstate last_map_state;
+  /* Used for mapping symbols.  */
+  int last_map_symbol;
+  bfd_vma last_stop_offset;
+  enum riscv_seg_mstate last_map_state;
 
-static const char * const *riscv_gpr_names;
-static const char * const *riscv_fpr_names;
+  const char * const *riscv_gpr_names;
+  const char * const *riscv_fpr_names;
 
-/* If set, disassemble as most general instruction.  */
-static int no_aliases;
+  /* If set, disassemble as most general instruction.  */
+  int no_aliases;
+
+  unsigned xlen;
+  enum riscv_spec_class default_isa_spec;
+  enum riscv_spec_class default_priv_spec;
+  riscv_subset_list_t riscv_subsets;
+  riscv_parse_subset_t riscv_rps_dis;
+
+  /* The decode tree for each OP_HASH_IDX, built on first use.  */
+  struct riscv_decode_node *riscv_decode[OP_MASK_OP + 1];
+};
 
 static void
-set_default_riscv_dis_options (void)
+set_default_riscv_dis_options (struct riscv_private_data *pd)
 {
-  riscv_gpr_names = riscv_gpr_names_abi;
-  riscv_fpr_names = riscv_fpr_names_abi;
-  no_aliases = 0;
+  pd->riscv_gpr_names = riscv_gpr_names_abi;
+  pd->riscv_fpr_names = riscv_fpr_names_abi;
+  pd->no_aliases = 0;
 }
 
 static bool
-parse_riscv_dis_option_without_args (const char *option)
+parse_riscv_dis_option_without_args (struct riscv_private_data *pd,
+				     const char *option)
 {
   if (strcmp (option, "no-aliases") == 0)
-    no_aliases = 1;
+    pd->no_aliases = 1;
   else if (strcmp (option, "numeric") == 0)
     {
-      riscv_gpr_names = riscv_gpr_names_numeric;
-      riscv_fpr_names = riscv_fpr_names_numeric;
+      pd->riscv_gpr_names = riscv_gpr_names_numeric;
+      pd->riscv_fpr_names = riscv_fpr_names_numeric;
     }
   else
     return false;
@@ -89,11 +104,11 @@ parse_riscv_dis_option_without_args (const char *option)
 }
 
 static void
-parse_riscv_dis_option (const char *option)
+parse_riscv_dis_option (struct riscv_private_data *pd, const char *option)
 {
   char *equal, *value;
 
-  if (parse_riscv_dis_option_without_args (option))
+  if (parse_riscv_dis_option_without_args (pd, option))
     return;
 
   equal = strchr (option, '=');
@@ -124,11 +139,11 @@ parse_riscv_dis_option (const char *option)
       if (priv_spec == PRIV_SPEC_CLASS_NONE)
 	opcodes_error_handler (_("unknown privileged spec set by %s=%s"),
 			       option, value);
-      else if (default_priv_spec == PRIV_SPEC_CLASS_NONE)
-	default_priv_spec = priv_spec;
-      else if (default_priv_spec != priv_spec)
+      else if (pd->default_priv_spec == PRIV_SPEC_CLASS_NONE)
+	pd->default_priv_spec = priv_spec;
+      else if (pd->default_priv_spec != priv_spec)
 	{
-	  RISCV_GET_PRIV_SPEC_NAME (name, default_priv_spec);
+	  RISCV_GET_PRIV_SPEC_NAME (name, pd->default_priv_spec);
 	  opcodes_error_handler (_("mis-matched privilege spec set by %s=%s, "
 				   "the elf privilege attribute is %s"),
 				 option, value, name);
@@ -142,17 +157,17 @@ parse_riscv_dis_option (const char *option)
 }
 
 static void
-parse_riscv_dis_options (const char *opts_in)
+parse_riscv_dis_options (struct riscv_private_data *pd, const char *opts_in)
 {
   char *opts = xstrdup (opts_in), *opt = opts, *opt_end = opts;
 
-  set_default_riscv_dis_options ();
+  set_default_riscv_dis_options (pd);
 
   for ( ; opt_end != NULL; opt = opt_end + 1)
     {
       if ((opt_end = strchr (opt, ',')) != NULL)
 	*opt_end = 0;
-      parse_riscv_dis_option (opt);
+      parse_riscv_dis_option (pd, opt);
     }
 
   free (opts);
@@ -187,6 +202,26 @@ maybe_print_address (struct riscv_private_data *pd, int base_reg, int offset,
     pd->print_addr = (bfd_vma)(int32_t) pd->print_addr;
 }
 
+/* Return the name of CSR number CSR in privileged spec PRIV_SPEC, or
+   NULL if it has none.  */
+
+static const char *
+riscv_csr_name (unsigned int csr, enum riscv_spec_class priv_spec)
+{
+#define DECLARE_CSR(name, num, class, define_version, abort_version)	\
+  if (csr == num							\
+      && ((define_version == PRIV_SPEC_CLASS_NONE			\
+	   && abort_version == PRIV_SPEC_CLASS_NONE)			\
+	  || (priv_spec >= define_version				\
+	      && priv_spec < abort_version)))				\
+    return #name;
+#define DECLARE_CSR_ALIAS(name, num, class, define_version, abort_version) \
+  DECLARE_CSR (name, num, class, define_version, abort_version)
+#include "opcode/riscv-opc.h"
+#undef DECLARE_CSR
+  return NULL;
+}
+
 /* Print insn arguments for 32/64-bit code.  */
 
 static void
@@ -212,24 +247,24 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
 	    case 's': /* RS1 x8-x15.  */
 	    case 'w': /* RS1 x8-x15.  */
 	      print (info->stream, dis_style_register, "%s",
-		     riscv_gpr_names[EXTRACT_OPERAND (CRS1S, l) + 8]);
+		     pd->riscv_gpr_names[EXTRACT_OPERAND (CRS1S, l) + 8]);
 	      break;
 	    case 't': /* RS2 x8-x15.  */
 	    case 'x': /* RS2 x8-x15.  */
 	      print (info->stream, dis_style_register, "%s",
-		     riscv_gpr_names[EXTRACT_OPERAND (CRS2S, l) + 8]);
+		     pd->riscv_gpr_names[EXTRACT_OPERAND (CRS2S, l) + 8]);
 	      break;
 	    case 'U': /* RS1, constrained to equal RD.  */
 	      print (info->stream, dis_style_register,
-		     "%s", riscv_gpr_names[rd]);
+		     "%s", pd->riscv_gpr_names[rd]);
 	      break;
 	    case 'c': /* RS1, constrained to equal sp.  */
 	      print (info->stream, dis_style_register, "%s",
-		     riscv_gpr_names[X_SP]);
+		     pd->riscv_gpr_names[X_SP]);
 	      break;
 	    case 'V': /* RS2 */
 	      print (info->stream, dis_style_register, "%s",
-		     riscv_gpr_names[EXTRACT_OPERAND (CRS2, l)]);
+		     pd->riscv_gpr_names[EXTRACT_OPERAND (CRS2, l)]);
 	      break;
 	    case 'o':
 	    case 'j':
@@ -295,11 +330,11 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
 	      break;
 	    case 'T': /* Floating-point RS2.  */
 	      print (info->stream, dis_style_register, "%s",
-		     riscv_fpr_names[EXTRACT_OPERAND (CRS2, l)]);
+		     pd->riscv_fpr_names[EXTRACT_OPERAND (CRS2, l)]);
 	      break;
 	    case 'D': /* Floating-point RS2 x8-x15.  */
 	      print (info->stream, dis_style_register, "%s",
-		     riscv_fpr_names[EXTRACT_OPERAND (CRS2S, l) + 8]);
+		     pd->riscv_fpr_names[EXTRACT_OPERAND (CRS2S, l) + 8]);
 	      break;
 	    }
 	  break;
@@ -315,7 +350,7 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
 	    case 'e':
 	      if (!EXTRACT_OPERAND (VWD, l))
 		print (info->stream, dis_style_register, "%s",
-		       riscv_gpr_names[0]);
+		       pd->riscv_gpr_names[0]);
 	      else
 		print (info->stream, dis_style_register, "%s",
 		       riscv_vecr_names_numeric[EXTRACT_OPERAND (VD, l)]);
@@ -398,12 +433,12 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
 	case 's':
 	  if ((l & MASK_JALR) == MATCH_JALR)
 	    maybe_print_address (pd, rs1, 0, 0);
-	  print (info->stream, dis_style_register, "%s", riscv_gpr_names[rs1]);
+	  print (info->stream, dis_style_register, "%s", pd->riscv_gpr_names[rs1]);
 	  break;
 
 	case 't':
 	  print (info->stream, dis_style_register, "%s",
-		 riscv_gpr_names[EXTRACT_OPERAND (RS2, l)]);
+		 pd->riscv_gpr_names[EXTRACT_OPERAND (RS2, l)]);
 	  break;
 
 	case 'u':
@@ -468,7 +503,7 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
 	    pd->hi_addr[rd] = EXTRACT_UTYPE_IMM (l);
 	  else if ((l & MASK_C_LUI) == MATCH_C_LUI)
 	    pd->hi_addr[rd] = EXTRACT_CITYPE_LUI_IMM (l);
-	  print (info->stream, dis_style_register, "%s", riscv_gpr_names[rd]);
+	  print (info->stream, dis_style_register, "%s", pd->riscv_gpr_names[rd]);
 	  break;
 
 	case 'y':
@@ -477,7 +512,7 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
 	  break;
 
 	case 'z':
-	  print (info->stream, dis_style_register, "%s", riscv_gpr_names[0]);
+	  print (info->stream, dis_style_register, "%s", pd->riscv_gpr_names[0]);
 	  break;
 
 	case '>':
@@ -492,54 +527,35 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
 
 	case 'S':
 	case 'U':
-	  print (info->stream, dis_style_register, "%s", riscv_fpr_names[rs1]);
+	  print (info->stream, dis_style_register, "%s", pd->riscv_fpr_names[rs1]);
 	  break;
 
 	case 'T':
 	  print (info->stream, dis_style_register, "%s",
-		 riscv_fpr_names[EXTRACT_OPERAND (RS2, l)]);
+		 pd->riscv_fpr_names[EXTRACT_OPERAND (RS2, l)]);
 	  break;
 
 	case 'D':
-	  print (info->stream, dis_style_register, "%s", riscv_fpr_names[rd]);
+	  print (info->stream, dis_style_register, "%s", pd->riscv_fpr_names[rd]);
 	  break;
 
 	case 'R':
 	  print (info->stream, dis_style_register, "%s",
-		 riscv_fpr_names[EXTRACT_OPERAND (RS3, l)]);
+		 pd->riscv_fpr_names[EXTRACT_OPERAND (RS3, l)]);
 	  break;
 
 	case 'E':
 	  {
-	    static const char *riscv_csr_hash[4096]; /* Total 2^12 CSRs.  */
-	    static bool init_csr = false;
 	    unsigned int csr = EXTRACT_OPERAND (CSR, l);
+	    const char *csr_name;
 
-	    if (!init_csr)
-	      {
-		unsigned int i;
-		for (i = 0; i < 4096; i++)
-		  riscv_csr_hash[i] = NULL;
-
-		/* Set to the newest privileged version.  */
-		if (default_priv_spec == PRIV_SPEC_CLASS_NONE)
-		  default_priv_spec = PRIV_SPEC_CLASS_DRAFT - 1;
+	    /* Default to the newest privileged version.  */
+	    if (pd->default_priv_spec == PRIV_SPEC_CLASS_NONE)
+	      pd->default_priv_spec = PRIV_SPEC_CLASS_DRAFT - 1;
 
-#define DECLARE_CSR(name, num, class, define_version, abort_version)	\
-		if (riscv_csr_hash[num] == NULL 			\
-		    && ((define_version == PRIV_SPEC_CLASS_NONE 	\
-			 && abort_version == PRIV_SPEC_CLASS_NONE)	\
-			|| (default_priv_spec >= define_version 	\
-			    && default_priv_spec < abort_version)))	\
-		  riscv_csr_hash[num] = #name;
-#define DECLARE_CSR_ALIAS(name, num, class, define_version, abort_version) \
-		DECLARE_CSR (name, num, class, define_version, abort_version)
-#include "opcode/riscv-opc.h"
-#undef DECLARE_CSR
-	      }
-
-	    if (riscv_csr_hash[csr] != NULL)
-	      print (info->stream, dis_style_text, "%s", riscv_csr_hash[csr]);
+	    csr_name = riscv_csr_name (csr, pd->default_priv_spec);
+	    if (csr_name != NULL)
+	      print (info->stream, dis_style_text, "%s", csr_name);
 	    else
 	      print (info->stream, dis_style_text, "0x%x", csr);
 	    break;
@@ -564,48 +580,191 @@ print_insn_args (const char *oparg, insn_t l, bfd_vma pc, disassemble_info *info
     }
 }
 
-/* Print the RISC-V instruction at address MEMADDR in debugged memory,
-   on using INFO.  Returns length of the instruction, in bytes.
-   BIGENDIAN must be 1 if this is big-endian code, 0 if
-   this is little-endian code.  */
+#define OP_HASH_IDX(i) ((i) & (riscv_insn_length (i) == 2 ? 0x3 : OP_MASK_OP))
 
-static int
-riscv_disassemble_insn (bfd_vma memaddr, insn_t word, disassemble_info *info)
+/* Don't split a list of candidate opcodes shorter than this.  */
+#define RISCV_DECODE_LEAF_SIZE 4
+
+/* The fields a decode tree node may split on: the funct3, funct6/funct7
+   and register fields of the 32-bit formats, and the funct fields of the
+   compressed formats.  */
+
+static const struct
 {
-  const struct riscv_opcode *op;
-  static bool init = 0;
-  static const struct riscv_opcode *riscv_hash[OP_MASK_OP + 1];
-  struct riscv_private_data *pd;
-  int insnlen;
+  unsigned char shift;
+  unsigned char width;
+} riscv_decode_fields[] =
+{
+  { 12, 3 },
+  { 26, 6 },
+  { 25, 1 },
+  { 20, 5 },
+  { 15, 5 },
+  { 7, 5 },
+  { 13, 3 },
+  { 10, 3 },
+  { 5, 2 },
+  { 2, 5 },
+};
 
-#define OP_HASH_IDX(i) ((i) & (riscv_insn_length (i) == 2 ? 0x3 : OP_MASK_OP))
+/* Return true if OP can match a word whose WIDTH-bit field at SHIFT
+   holds VALUE.  Every match_func starts with match_opcode, so an opcode
+   whose MATCH and MASK disagree with VALUE can never match.  */
+
+static inline bool
+riscv_decode_may_match (const struct riscv_opcode *op, unsigned int shift,
+			unsigned int width, insn_t value)
+{
+  return ((((op->match >> shift) ^ value) & (op->mask >> shift)
+	   & (((insn_t) 1 << width) - 1)) == 0);
+}
+
+/* Build a decode tree node for the COUNT candidate opcodes in OPS.
+   The bits in USED have already been tested by the parent nodes.  */
 
-  /* Build a hash table to shorten the search time.  */
-  if (! init)
+static struct riscv_decode_node *
+riscv_build_decode_node (const struct riscv_opcode **ops, size_t count,
+			 insn_t used)
+{
+  struct riscv_decode_node *node = XCNEW (struct riscv_decode_node);
+  size_t best_max = count;
+  int best = -1;
+  size_t i, j;
+  insn_t v;
+
+  if (count > RISCV_DECODE_LEAF_SIZE)
     {
-      for (op = riscv_opcodes; op->name; op++)
-	if (!riscv_hash[OP_HASH_IDX (op->match)])
-	  riscv_hash[OP_HASH_IDX (op->match)] = op;
+      /* Pick the field that leaves the fewest candidates in the worst
+	 case.  */
+      for (i = 0; i < ARRAY_SIZE (riscv_decode_fields); i++)
+	{
+	  unsigned int shift = riscv_decode_fields[i].shift;
+	  unsigned int width = riscv_decode_fields[i].width;
+	  size_t max = 0;
+
+	  if (used & ((((insn_t) 1 << width) - 1) << shift))
+	    continue;
+	  for (v = 0; v < ((insn_t) 1 << width) && max < best_max; v++)
+	    {
+	      size_t n = 0;
 
-      init = 1;
+	      for (j = 0; j < count; j++)
+		if (riscv_decode_may_match (ops[j], shift, width, v))
+		  n++;
+	      if (n > max)
+		max = n;
+	    }
+	  if (max < best_max)
+	    {
+	      best_max = max;
+	      best = i;
+	    }
+	}
     }
 
-  if (info->private_data == NULL)
+  if (best >= 0)
     {
-      int i;
+      const struct riscv_opcode **sub;
+
+      node->shift = riscv_decode_fields[best].shift;
+      node->width = riscv_decode_fields[best].width;
+      node->children = XNEWVEC (struct riscv_decode_node *,
+				(size_t) 1 << node->width);
+      sub = XNEWVEC (const struct riscv_opcode *, count);
+      for (v = 0; v < ((insn_t) 1 << node->width); v++)
+	{
+	  size_t n = 0;
+
+	  for (j = 0; j < count; j++)
+	    if (riscv_decode_may_match (ops[j], node->shift, node->width, v))
+	      sub[n++] = ops[j];
+	  node->children[v]
+	    = riscv_build_decode_node (sub, n, used | ((((insn_t) 1
+							 << node->width) - 1)
+						       << node->shift));
+	}
+      free (sub);
+    }
+  else
+    {
+      node->ops = XNEWVEC (const struct riscv_opcode *, count + 1);
+      memcpy (node->ops, ops, count * sizeof (*ops));
+      node->ops[count] = NULL;
+    }
+
+  return node;
+}
 
-      pd = info->private_data = xcalloc (1, sizeof (struct riscv_private_data));
-      pd->gp = -1;
-      pd->print_addr = -1;
-      for (i = 0; i < (int)ARRAY_SIZE (pd->hi_addr); i++)
-	pd->hi_addr[i] = -1;
+/* Build the decode tree for words with OP_HASH_IDX equal to IDX.  The
+   search used to start at the first opcode with that index and run to
+   the end of the table, so the candidates are the opcodes from there on
+   that can match the index bits.  */
 
-      for (i = 0; i < info->symtab_size; i++)
-	if (strcmp (bfd_asymbol_name (info->symtab[i]), RISCV_GP_SYMBOL) == 0)
-	  pd->gp = bfd_asymbol_value (info->symtab[i]);
+static struct riscv_decode_node *
+riscv_build_decode_tree (insn_t idx)
+{
+  insn_t idx_mask = (idx & 0x3) == 0x3 ? OP_MASK_OP : 0x3;
+  const struct riscv_opcode *first, *op;
+  const struct riscv_opcode **ops;
+  struct riscv_decode_node *node;
+  size_t count = 0;
+
+  for (first = riscv_opcodes; first->name; first++)
+    if (OP_HASH_IDX (first->match) == idx)
+      break;
+  for (op = first; op->name; op++)
+    count++;
+
+  ops = XNEWVEC (const struct riscv_opcode *, count + 1);
+  count = 0;
+  for (op = first; op->name; op++)
+    {
+      if (((op->match ^ idx) & op->mask & idx_mask) != 0)
+	continue;
+      /* Macros use match_never, and so never match their own encoding;
+	 leave them out.  */
+      if (op->pinfo == INSN_MACRO && !(op->match_func) (op, op->match))
+	continue;
+      ops[count++] = op;
     }
-  else
-    pd = info->private_data;
+
+  node = riscv_build_decode_node (ops, count, idx_mask);
+  free (ops);
+  return node;
+}
+
+/* Free the decode tree NODE.  */
+
+static void
+riscv_free_decode_node (struct riscv_decode_node *node)
+{
+  insn_t v;
+
+  if (node == NULL)
+    return;
+  if (node->children != NULL)
+    {
+      for (v = 0; v < ((insn_t) 1 << node->width); v++)
+	riscv_free_decode_node (node->children[v]);
+      free (node->children);
+    }
+  free (node->ops);
+  free (node);
+}
+
+/* Print the RISC-V instruction at address MEMADDR in debugged memory,
+   on using INFO.  Returns length of the instruction, in bytes.
+   BIGENDIAN must be 1 if this is big-endian code, 0 if
+   this is little-endian code.  */
+
+static int
+riscv_disassemble_insn (bfd_vma memaddr, insn_t word, disassemble_info *info)
+{
+  const struct riscv_opcode *op, **ops;
+  struct riscv_private_data *pd = info->private_data;
+  struct riscv_decode_node *node;
+  insn_t idx;
+  int insnlen;
 
   insnlen = riscv_insn_length (word);
 
@@ -623,37 +782,45 @@ riscv_disassemble_insn (bfd_vma memaddr, insn_t word, disassemble_info *info)
   info->target = 0;
   info->target2 = 0;
 
-  op = riscv_hash[OP_HASH_IDX (word)];
-  if (op != NULL)
+  idx = OP_HASH_IDX (word);
+  if (pd->riscv_decode[idx] == NULL)
+    pd->riscv_decode[idx] = riscv_build_decode_tree (idx);
+  for (node = pd->riscv_decode[idx]; node->width != 0; )
+    node = node->children[(word >> node->shift)
+			  & (((insn_t) 1 << node->width) - 1)];
+
+  ops = node->ops;
+  if (*ops != NULL)
     {
       /* If XLEN is not known, get its value from the ELF class.  */
       if (info->mach == bfd_mach_riscv64)
-	xlen = 64;
+	pd->xlen = 64;
       else if (info->mach == bfd_mach_riscv32)
-	xlen = 32;
+	pd->xlen = 32;
       else if (info->section != NULL)
 	{
 	  Elf_Internal_Ehdr *ehdr = elf_elfheader (info->section->owner);
-	  xlen = ehdr->e_ident[EI_CLASS] == ELFCLASS64 ? 64 : 32;
+	  pd->xlen = ehdr->e_ident[EI_CLASS] == ELFCLASS64 ? 64 : 32;
 	}
 
       /* If arch has ZFINX flags, use gpr for disassemble.  */
-      if(riscv_subset_supports (&riscv_rps_dis, "zfinx"))
-	riscv_fpr_names = riscv_gpr_names;
+      if(riscv_subset_supports (&pd->riscv_rps_dis, "zfinx"))
+	pd->riscv_fpr_names = pd->riscv_gpr_names;
 
-      for (; op->name; op++)
+      for (; (op = *ops) != NULL; ops++)
 	{
 	  /* Does the opcode match?  */
 	  if (! (op->match_func) (op, word))
 	    continue;
 	  /* Is this a pseudo-instruction and may we print it as such?  */
-	  if (no_aliases && (op->pinfo & INSN_ALIAS))
+	  if (pd->no_aliases && (op->pinfo & INSN_ALIAS))
 	    continue;
 	  /* Is this instruction restricted to a certain value of XLEN?  */
-	  if ((op->xlen_requirement != 0) && (op->xlen_requirement != xlen))
+	  if ((op->xlen_requirement != 0)
+	      && (op->xlen_requirement != pd->xlen))
 	    continue;
 
-	  if (!riscv_multi_subset_supports (&riscv_rps_dis, op->insn_class))
+	  if (!riscv_multi_subset_supports (&pd->riscv_rps_dis, op->insn_class))
 	    continue;
 
 	  /* It's a match.  */
@@ -767,6 +934,7 @@ static enum riscv_seg_mstate
 riscv_search_mapping_symbol (bfd_vma memaddr,
 			     struct disassemble_info *info)
 {
+  struct riscv_private_data *pd = info->private_data;
   enum riscv_seg_mstate mstate;
   bool from_last_map_symbol;
   bool found = false;
@@ -787,19 +955,19 @@ riscv_search_mapping_symbol (bfd_vma memaddr,
 
   /* Reset the last_map_symbol if we start to dump a new section.  */
   if (memaddr <= 0)
-    last_map_symbol = -1;
+    pd->last_map_symbol = -1;
 
   /* If the last stop offset is different from the current one, then
      don't use the last_map_symbol to search.  We usually reset the
      info->stop_offset when handling a new section.  */
-  from_last_map_symbol = (last_map_symbol >= 0
-			  && info->stop_offset == last_stop_offset);
+  from_last_map_symbol = (pd->last_map_symbol >= 0
+			  && info->stop_offset == pd->last_stop_offset);
 
   /* Start scanning at the start of the function, or wherever
      we finished last time.  */
   n = info->symtab_pos + 1;
-  if (from_last_map_symbol && n >= last_map_symbol)
-    n = last_map_symbol;
+  if (from_last_map_symbol && n >= pd->last_map_symbol)
+    n = pd->last_map_symbol;
 
   /* Find the suitable mapping symbol to dump.  */
   for (; n < info->symtab_size; n++)
@@ -825,8 +993,8 @@ riscv_search_mapping_symbol (bfd_vma memaddr,
   if (!found)
     {
       n = info->symtab_pos;
-      if (from_last_map_symbol && n >= last_map_symbol)
-	n = last_map_symbol;
+      if (from_last_map_symbol && n >= pd->last_map_symbol)
+	n = pd->last_map_symbol;
 
       for (; n >= 0; n--)
 	{
@@ -845,8 +1013,8 @@ riscv_search_mapping_symbol (bfd_vma memaddr,
     }
 
   /* Save the information for next use.  */
-  last_map_symbol = symbol;
-  last_stop_offset = info->stop_offset;
+  pd->last_map_symbol = symbol;
+  pd->last_stop_offset = info->stop_offset;
 
   return mstate;
 }
@@ -857,17 +1025,18 @@ static bfd_vma
 riscv_data_length (bfd_vma memaddr,
 		   disassemble_info *info)
 {
+  struct riscv_private_data *pd = info->private_data;
   bfd_vma length;
   bool found = false;
 
   length = 4;
   if (info->symtab_size != 0
       && bfd_asymbol_flavour (*info->symtab) == bfd_target_elf_flavour
-      && last_map_symbol >= 0)
+      && pd->last_map_symbol >= 0)
     {
       int n;
       enum riscv_seg_mstate m = MAP_NONE;
-      for (n = last_map_symbol + 1; n < info->symtab_size; n++)
+      for (n = pd->last_map_symbol + 1; n < info->symtab_size; n++)
 	{
 	  bfd_vma addr = bfd_asymbol_value (info->symtab[n]);
 	  if (addr > memaddr
@@ -940,6 +1109,76 @@ riscv_disassemble_data (bfd_vma memaddr ATTRIBUTE_UNUSED,
   return info->bytes_per_chunk;
 }
 
+/* If ABFD has RISC-V ELF attributes, set *ARCH and *PRIV_SPEC from them.  */
+
+static void
+riscv_get_elf_arch (bfd *abfd, const char **arch,
+		    enum riscv_spec_class *priv_spec)
+{
+  if (abfd && bfd_get_flavour (abfd) == bfd_target_elf_flavour)
+    {
+      const char *sec_name = get_elf_backend_data (abfd)->obj_attrs_section;
+      if (bfd_get_section_by_name (abfd, sec_name) != NULL)
+	{
+	  obj_attribute *attr = elf_known_obj_attributes_proc (abfd);
+	  unsigned int Tag_a = Tag_RISCV_priv_spec;
+	  unsigned int Tag_b = Tag_RISCV_priv_spec_minor;
+	  unsigned int Tag_c = Tag_RISCV_priv_spec_revision;
+	  riscv_get_priv_spec_class_from_numbers (attr[Tag_a].i,
+						  attr[Tag_b].i,
+						  attr[Tag_c].i,
+						  priv_spec);
+	  *arch = attr[Tag_RISCV_arch].s;
+	}
+    }
+}
+
+/* Allocate and set up INFO->private_data.  The architecture is taken
+   from the ELF attributes of the file being disassembled: that owning
+   INFO->section if there is one, else that owning the symbols.  Without
+   either, assume the usual ISA for the XLEN given by INFO->mach.  */
+
+static struct riscv_private_data *
+riscv_init_private_data (struct disassemble_info *info)
+{
+  struct riscv_private_data *pd;
+  const char *arch = info->mach == bfd_mach_riscv32 ? "rv32gc" : "rv64gc";
+  bfd *abfd = NULL;
+  int i;
+
+  pd = info->private_data = xcalloc (1, sizeof (struct riscv_private_data));
+  pd->gp = -1;
+  pd->print_addr = -1;
+  for (i = 0; i < (int)ARRAY_SIZE (pd->hi_addr); i++)
+    pd->hi_addr[i] = -1;
+
+  for (i = 0; i < info->symtab_size; i++)
+    if (strcmp (bfd_asymbol_name (info->symtab[i]), RISCV_GP_SYMBOL) == 0)
+      pd->gp = bfd_asymbol_value (info->symtab[i]);
+
+  pd->last_map_symbol = -1;
+  set_default_riscv_dis_options (pd);
+
+  pd->default_isa_spec = ISA_SPEC_CLASS_DRAFT - 1;
+  pd->default_priv_spec = PRIV_SPEC_CLASS_NONE;
+  if (info->section != NULL)
+    abfd = info->section->owner;
+  else if (info->symtab_size > 0)
+    abfd = bfd_asymbol_bfd (info->symtab[0]);
+  else if (info->num_symbols > 0)
+    abfd = bfd_asymbol_bfd (info->symbols[0]);
+  riscv_get_elf_arch (abfd, &arch, &pd->default_priv_spec);
+
+  pd->riscv_rps_dis.subset_list = &pd->riscv_subsets;
+  pd->riscv_rps_dis.error_handler = opcodes_error_handler;
+  pd->riscv_rps_dis.xlen = &pd->xlen;
+  pd->riscv_rps_dis.isa_spec = &pd->default_isa_spec;
+  pd->riscv_rps_dis.check_unknown_prefixed_ext = false;
+  riscv_parse_subset (&pd->riscv_rps_dis, arch);
+
+  return pd;
+}
+
 int
 print_insn_riscv (bfd_vma memaddr, struct disassemble_info *info)
 {
@@ -949,19 +1188,21 @@ print_insn_riscv (bfd_vma memaddr, struct disassemble_info *info)
   int status;
   enum riscv_seg_mstate mstate;
   int (*riscv_disassembler) (bfd_vma, insn_t, struct disassemble_info *);
+  struct riscv_private_data *pd = info->private_data;
+
+  if (pd == NULL)
+    pd = riscv_init_private_data (info);
 
   if (info->disassembler_options != NULL)
     {
-      parse_riscv_dis_options (info->disassembler_options);
+      parse_riscv_dis_options (pd, info->disassembler_options);
       /* Avoid repeatedly parsing the options.  */
       info->disassembler_options = NULL;
     }
-  else if (riscv_gpr_names == NULL)
-    set_default_riscv_dis_options ();
 
   mstate = riscv_search_mapping_symbol (memaddr, info);
   /* Save the last mapping state.  */
-  last_map_state = mstate;
+  pd->last_map_state = mstate;
 
   /* Set the size to dump.  */
   if (mstate == MAP_DATA
@@ -998,30 +1239,26 @@ print_insn_riscv (bfd_vma memaddr, struct disassemble_info *info)
 }
 
 disassembler_ftype
-riscv_get_disassembler (bfd *abfd)
+riscv_get_disassembler (bfd *abfd ATTRIBUTE_UNUSED)
 {
-  const char *default_arch = "rv64gc";
+  return print_insn_riscv;
+}
 
-  if (abfd && bfd_get_flavour (abfd) == bfd_target_elf_flavour)
-    {
-      const char *sec_name = get_elf_backend_data (abfd)->obj_attrs_section;
-      if (bfd_get_section_by_name (abfd, sec_name) != NULL)
-	{
-	  obj_attribute *attr = elf_known_obj_attributes_proc (abfd);
-	  unsigned int Tag_a = Tag_RISCV_priv_spec;
-	  unsigned int Tag_b = Tag_RISCV_priv_spec_minor;
-	  unsigned int Tag_c = Tag_RISCV_priv_spec_revision;
-	  riscv_get_priv_spec_class_from_numbers (attr[Tag_a].i,
-						  attr[Tag_b].i,
-						  attr[Tag_c].i,
-						  &default_priv_spec);
-	  default_arch = attr[Tag_RISCV_arch].s;
-	}
-    }
+/* Free the subset list held in INFO->private_data.  */
 
-  riscv_release_subset_list (&riscv_subsets);
-  riscv_parse_subset (&riscv_rps_dis, default_arch);
-  return print_insn_riscv;
+void
+disassemble_free_riscv (struct disassemble_info *info)
+{
+  struct riscv_private_data *pd = info->private_data;
+
+  size_t i;
+
+  if (pd == NULL)
+    return;
+
+  riscv_release_subset_list (&pd->riscv_subsets);
+  for (i = 0; i < ARRAY_SIZE (pd->riscv_decode); i++)
+    riscv_free_decode_node (pd->riscv_decode[i]);
 }
 
 /* Prevent use of the fake labels that are generated as part of the DWARF